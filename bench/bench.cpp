@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "phys/chan.hpp"
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/qam.hpp"
+#include "phys/qam/qam_demodulator.hpp"
+#include "phys/qam/qam_fused.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "sim/error_stats.hpp"
+#include "sim/perf_counters.hpp"
+#include "types/complex.hpp"
+
+/**
+ * Micro-benchmarks of the modem, the channel and the utilities.
+ *
+ * Every kernel runs over a block of symbols, the loop is calibrated to run
+ * for at least --min-time milliseconds and repeated --repeat times; each
+ * repetition is one sample of ns per symbol. The report is JSON on stdout
+ * (or --out FILE), the median is the headline value. With --perf the
+ * repetitions are also wrapped in hardware counters (IPC and events per
+ * symbol); events the machine does not expose are left out of the report.
+ */
+
+namespace {
+
+// results are folded into a volatile so the kernels cannot be optimized away
+volatile uint64_t bench_sink = 0;
+
+void keep(uint64_t value) {
+    bench_sink = bench_sink + value;
+}
+
+struct bench_options {
+    size_t                  repeat      = 5;        // Samples per kernel
+    double                  min_time_ms = 20.0;     // Minimum duration of one sample
+    std::vector<size_t>     blocks      = {1024, 16384, 262144};
+    std::string             filter;                 // Substring of the kernel name, empty runs all
+    std::string             output;                 // JSON file, empty prints to stdout
+    bool                    perf        = false;    // Read hardware counters
+};
+
+struct bench_result {
+    std::string             name;               // kernel/order/dtype/block
+    std::string             kernel;
+    std::string             order;
+    std::string             dtype;
+    size_t                  block           = 0;    // Symbols per call
+    double                  bytes_per_symbol = 0;   // Bytes read + written per symbol
+    std::vector<double>     samples;                // ns per symbol
+    perf_sample             perf;                   // Counters of all repetitions (--perf)
+    uint64_t                perf_symbols    = 0;    // Symbols processed under the counters
+};
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+    return (values.size() % 2) ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+const char* order_name(qam_order order) {
+    switch (order) {
+        case qam_order::QPSK:   return "QPSK";
+        case qam_order::QAM16:  return "QAM16";
+        case qam_order::QAM64:  return "QAM64";
+        default:                return "unknown";
+    }
+}
+
+template<typename DTYPE>
+const char* dtype_name();
+
+template<>
+const char* dtype_name<float>() { return "float"; }
+
+template<>
+const char* dtype_name<double>() { return "double"; }
+
+/**
+ * @brief Times a kernel, one sample per repetition
+ * @param kernel Callback processing one block
+ * @param block Symbols per call
+ * @param result Receives ns per symbol of every repetition and the counters
+ * @param counters Hardware counters of this thread, null to skip them
+ */
+void measure(const std::function<void()>& kernel, size_t block, const bench_options& opts,
+             bench_result& result, perf_counters* counters) {
+    using clock = std::chrono::steady_clock;
+
+    auto time_ns = [&kernel](size_t iterations) {
+        const auto start = clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            kernel();
+        }
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+    };
+
+    // warm up caches and lazily built tables, then calibrate the loop
+    kernel();
+    const double min_ns = opts.min_time_ms * 1e6;
+    size_t iterations = 1;
+    double elapsed = time_ns(iterations);
+    while (elapsed < min_ns && iterations < (size_t(1) << 30)) {
+        const double scale = elapsed > 0 ? std::min(10.0, 1.2 * min_ns / elapsed) : 10.0;
+        iterations = std::max(iterations + 1, static_cast<size_t>(iterations * scale));
+        elapsed = time_ns(iterations);
+    }
+
+    for (size_t r = 0; r < opts.repeat; ++r) {
+        if (counters) {
+            perf_scope scope(*counters, result.perf);
+            result.samples.push_back(time_ns(iterations) / static_cast<double>(iterations * block));
+            result.perf_symbols += iterations * block;
+        } else {
+            result.samples.push_back(time_ns(iterations) / static_cast<double>(iterations * block));
+        }
+    }
+}
+
+class bench_suite {
+public:
+    explicit bench_suite(const bench_options& opts) : opts_m(opts) {
+        if (opts_m.perf) {
+            counters_m = perf_counters::make();
+            if (!counters_m->available()) {
+                std::cerr << "Hardware counters unavailable (perf_event_paranoid / container), --perf ignored" << std::endl;
+                counters_m.reset();
+            }
+        }
+    }
+
+    /**
+     * @brief Runs a kernel unless it is filtered out
+     */
+    void add(const std::string& kernel, const char* order, const char* dtype, size_t block,
+             double bytes_per_symbol, const std::function<void()>& fn) {
+        bench_result result;
+        result.kernel = kernel;
+        result.order = order;
+        result.dtype = dtype;
+        result.block = block;
+        result.bytes_per_symbol = bytes_per_symbol;
+        result.name = kernel + "/" + order + "/" + dtype + "/" + std::to_string(block);
+        if (!opts_m.filter.empty() && result.name.find(opts_m.filter) == std::string::npos) {
+            return;
+        }
+
+        measure(fn, block, opts_m, result, counters_m.get());
+        std::cerr << std::left << std::setw(36) << result.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << median(result.samples) << " ns/sym";
+        if (counters_m) {
+            std::cerr << "  " << result.perf.report(result.perf_symbols);
+        }
+        std::cerr << std::endl;
+        results_m.push_back(std::move(result));
+    }
+
+    /**
+     * @brief Writes all results as JSON
+     */
+    void write_json(std::ostream& out) const {
+        out << "{\n  \"suite\": \"yadro_1v\",\n  \"repeat\": " << opts_m.repeat
+            << ",\n  \"min_time_ms\": " << opts_m.min_time_ms << ",\n  \"results\": [\n";
+        for (size_t r = 0; r < results_m.size(); ++r) {
+            const bench_result& result = results_m[r];
+            const double ns = median(result.samples);
+            out << "    {\"name\": \"" << result.name << "\", \"kernel\": \"" << result.kernel
+                << "\", \"order\": \"" << result.order << "\", \"dtype\": \"" << result.dtype
+                << "\", \"block\": " << result.block
+                << ", \"ns_per_symbol\": " << std::setprecision(6) << ns
+                << ", \"gb_per_s\": " << (ns > 0 ? result.bytes_per_symbol / ns : 0.0);
+            write_perf(out, result);
+            out << ", \"samples\": [";
+            for (size_t s = 0; s < result.samples.size(); ++s) {
+                out << (s ? ", " : "") << result.samples[s];
+            }
+            out << "]}" << (r + 1 < results_m.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    /**
+     * @brief Writes the counted events of a result as JSON fields
+     */
+    static void write_perf(std::ostream& out, const bench_result& result) {
+        const perf_sample& perf = result.perf;
+        if (perf.has(perf_event_kind::CYCLES) && perf.has(perf_event_kind::INSTRUCTIONS)) {
+            out << ", \"ipc\": " << perf.ipc();
+        }
+
+        static const std::pair<perf_event_kind, const char*> fields[] = {
+            {perf_event_kind::CYCLES,           "cycles_per_symbol"},
+            {perf_event_kind::INSTRUCTIONS,     "instructions_per_symbol"},
+            {perf_event_kind::BRANCH_MISSES,    "branch_misses_per_symbol"},
+            {perf_event_kind::L1D_MISSES,       "l1d_misses_per_symbol"},
+            {perf_event_kind::LLC_MISSES,       "llc_misses_per_symbol"},
+        };
+        for (const auto& [kind, field] : fields) {
+            if (perf.has(kind)) {
+                out << ", \"" << field << "\": " << perf.per_unit(kind, result.perf_symbols);
+            }
+        }
+    }
+
+    bench_options               opts_m;
+    perf_counters::ptr          counters_m;
+    std::vector<bench_result>   results_m;
+};
+
+template<typename DTYPE>
+void bench_modem(bench_suite& suite, qam_order order, size_t block) {
+    auto mapper = ext_make_mapper<DTYPE>(order);
+    const uint32_t bps = mapper->get_bits_per_symbol();
+    const size_t bytes = block * bps / 8;
+    const double sym_bytes = 2.0 * sizeof(DTYPE);
+    const double bit_bytes = bps / 8.0;
+    const char* oname = order_name(order);
+    const char* dname = dtype_name<DTYPE>();
+
+    std::vector<byte> tx(bytes);
+    std::vector<byte> rx(bytes);
+    std::mt19937 gen(1);
+    std::generate(tx.begin(), tx.end(), [&gen]() { return static_cast<byte>(gen()); });
+
+    qam_modulator<DTYPE> modulator;
+    qam_demodulator<DTYPE> demodulator;
+    modulator.set_mapper(mapper);
+    demodulator.set_mapper(mapper);
+
+    auto symbols = complex<DTYPE>::make(block * 2);
+    auto noisy = complex<DTYPE>::make(block * 2);
+    channel<DTYPE> chan;
+    chan.set_channel_response_model(noise<DTYPE>(0.1, 1, 0));
+    modulator.modulate(std::span<const byte>(tx), symbols);
+    chan.transmit(symbols, noisy, block);
+
+    suite.add("modulate", oname, dname, block, bit_bytes + sym_bytes, [&]() {
+        keep(modulator.modulate(std::span<const byte>(tx), symbols));
+    });
+
+    suite.add("transmit", oname, dname, block, 2 * sym_bytes, [&]() {
+        chan.transmit(symbols, noisy, block);
+        keep(noisy.size());
+    });
+
+    suite.add("demodulate", oname, dname, block, sym_bytes + bit_bytes, [&]() {
+        demodulator.demodulate(noisy, block, std::span<byte>(rx));
+        keep(rx[0]);
+    });
+
+    suite.add("demodulate_llr", oname, dname, block, sym_bytes + bit_bytes, [&]() {
+        keep(demodulator.demodulate_llr(noisy, chan)[0]);
+    });
+
+    error_counter counter(bps);
+    demodulator.demodulate(noisy, block, std::span<byte>(rx));
+    suite.add("count_errors", oname, dname, block, 2 * bit_bytes, [&]() {
+        counter.reset();
+        counter.accumulate(tx, rx);
+        keep(counter.get_stats().errors);
+    });
+
+    // the whole chain of a sim_engine tile, staged through buffers vs fused in registers
+    suite.add("chain_staged", oname, dname, block, bit_bytes, [&]() {
+        modulator.modulate(std::span<const byte>(tx), symbols);
+        chan.transmit(symbols, symbols, block);
+        demodulator.demodulate(symbols, block, std::span<byte>(rx));
+        counter.reset();
+        counter.accumulate(tx, rx);
+        keep(counter.get_stats().errors);
+    });
+}
+
+template<typename DTYPE, qam_order ORDER>
+void bench_fused(bench_suite& suite, size_t block) {
+    const uint32_t bps = ext_get_bits_per_symbol(ORDER);
+    std::vector<byte> tx(block * bps / 8);
+    std::mt19937 gen(1);
+    std::generate(tx.begin(), tx.end(), [&gen]() { return static_cast<byte>(gen()); });
+
+    const qam_mapper<DTYPE, ORDER> mapper;
+    qam_fused_kernel<DTYPE, ORDER> kernel(mapper);
+    channel<DTYPE> chan;
+    chan.set_channel_response_model(noise<DTYPE>(0.1, 1, 0));
+    std::array<uint64_t, error_stats::MAX_BITS_PER_SYMBOL> position_errors{};
+
+    suite.add("chain_fused", order_name(ORDER), dtype_name<DTYPE>(), block, bps / 8.0, [&]() {
+        keep(kernel.run(tx, chan, position_errors));
+    });
+}
+
+template<typename DTYPE>
+void bench_utilities(bench_suite& suite, size_t block) {
+    const double sym_bytes = 2.0 * sizeof(DTYPE);
+    const char* dname = dtype_name<DTYPE>();
+
+    // one complex sample per symbol from the stream
+    noise<DTYPE> ns(0.5, 1, 0);
+    std::vector<DTYPE> samples(block * 2);
+    suite.add("noise", "none", dname, block, sym_bytes, [&]() {
+        for (auto& sample : samples) {
+            sample = ns.get_next_noise();
+        }
+        keep(samples[0]);
+    });
+
+    auto source = complex<DTYPE>::make(block * 2);
+    auto target = complex<DTYPE>::make(block * 2);
+    suite.add("complex_copy", "none", dname, block, 2 * sym_bytes, [&]() {
+        target = source;
+        keep(target.size());
+    });
+
+    const complex_t<DTYPE> value(1, -1);
+    suite.add("complex_store", "none", dname, block, sym_bytes, [&]() {
+        for (size_t i = 0; i < block; ++i) {
+            target.store(value, i);
+        }
+        keep(target.size());
+    });
+}
+
+template<typename DTYPE>
+void bench_dtype(bench_suite& suite, const bench_options& opts) {
+    for (size_t block : opts.blocks) {
+        for (qam_order order : {qam_order::QPSK, qam_order::QAM16, qam_order::QAM64}) {
+            bench_modem<DTYPE>(suite, order, block);
+        }
+        bench_fused<DTYPE, qam_order::QPSK>(suite, block);
+        bench_fused<DTYPE, qam_order::QAM16>(suite, block);
+        bench_fused<DTYPE, qam_order::QAM64>(suite, block);
+        bench_utilities<DTYPE>(suite, block);
+    }
+}
+
+void print_usage(const char* app) {
+    std::cout << "Usage: " << app << " [options]\n"
+              << "  --repeat N       samples per kernel (default 5)\n"
+              << "  --min-time MS    minimum duration of one sample (default 20)\n"
+              << "  --blocks A,B,..  block sizes in symbols, multiples of 8 (default 1024,16384,262144)\n"
+              << "  --filter STR     run kernels whose name contains STR\n"
+              << "  --out FILE       write the JSON report to FILE instead of stdout\n"
+              << "  --perf           add hardware counters (IPC, misses per symbol) where available\n";
+}
+
+std::vector<size_t> parse_blocks(const std::string& value) {
+    std::vector<size_t> blocks;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const size_t block = std::stoull(item);
+        if (block == 0 || block % 8) {
+            throw std::invalid_argument("block sizes must be positive multiples of 8");
+        }
+        blocks.push_back(block);
+    }
+    return blocks;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench_options opts;
+
+    try {
+        for (int a = 1; a < argc; ++a) {
+            const std::string arg = argv[a];
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            if (arg == "--perf") {
+                opts.perf = true;
+                continue;
+            }
+            if (a + 1 >= argc) {
+                throw std::invalid_argument("missing value of " + arg);
+            }
+            const std::string value = argv[++a];
+            if (arg == "--repeat") {
+                opts.repeat = std::max<size_t>(1, std::stoull(value));
+            } else if (arg == "--min-time") {
+                opts.min_time_ms = std::stod(value);
+            } else if (arg == "--blocks") {
+                opts.blocks = parse_blocks(value);
+            } else if (arg == "--filter") {
+                opts.filter = value;
+            } else if (arg == "--out") {
+                opts.output = value;
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench_suite suite(opts);
+    bench_dtype<float>(suite, opts);
+    bench_dtype<double>(suite, opts);
+
+    if (opts.output.empty()) {
+        suite.write_json(std::cout);
+    } else {
+        std::ofstream file(opts.output);
+        if (!file) {
+            std::cerr << "Error: cannot open " << opts.output << std::endl;
+            return EXIT_FAILURE;
+        }
+        suite.write_json(file);
+    }
+
+    return EXIT_SUCCESS;
+}
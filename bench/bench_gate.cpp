@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * Performance regression gate: runs the bench executable, compares the
+ * median ns/symbol of every kernel against a baseline report and fails if
+ * a kernel got slower by more than the threshold AND by more than the
+ * measurement noise.
+ *
+ * The bench is run --runs times and the samples of all runs are pooled, so
+ * the noise estimate (standard error of the median derived from the MAD)
+ * covers the drift between processes and not only between repetitions of
+ * one loop. Ratios are normalized by the median ratio of the whole suite,
+ * so a baseline recorded on another (uniformly faster or slower) machine
+ * still catches a single kernel that doubled; --absolute disables the
+ * normalization when both reports come from the same box.
+ */
+
+namespace {
+
+struct kernel_stats {
+    double  median  = 0.0;  // ns per symbol
+    double  sigma   = 0.0;  // Standard error of the median, from the MAD of the samples
+};
+
+using report_samples = std::map<std::string, std::vector<double>>;
+
+struct gate_options {
+    std::string                 bench;                      // bench executable
+    std::string                 baseline;                   // Baseline JSON report
+    std::string                 current;                    // Compare this report instead of running bench
+    double                      threshold   = 0.75;         // Allowed relative slowdown
+    double                      mad_k       = 3.0;          // Slowdown must exceed mad_k noise sigmas
+    bool                        absolute    = false;        // Do not normalize by the suite-wide ratio
+    bool                        update      = false;        // Rewrite the baseline with the current run
+    size_t                      runs        = 3;            // bench processes pooled per report
+    std::vector<std::string>    bench_args;                 // Passed through to bench
+};
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+    return (values.size() % 2) ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+kernel_stats make_stats(const std::vector<double>& samples) {
+    kernel_stats stats;
+    stats.median = median(samples);
+    std::vector<double> deviations;
+    for (double sample : samples) {
+        deviations.push_back(std::fabs(sample - stats.median));
+    }
+    // MAD -> standard deviation -> standard error of the median
+    stats.sigma = 1.2533 * 1.4826 * median(deviations) / std::sqrt(static_cast<double>(samples.size()));
+    return stats;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/**
+ * @brief Appends the samples of a bench report to name -> samples
+ *
+ * Only the layout written by bench is understood: one object per result
+ * with a "name" string and a "samples" array of numbers.
+ */
+void parse_report(const std::string& path, report_samples& report) {
+    const std::string text = read_file(path);
+
+    const std::string name_key = "\"name\": \"";
+    const std::string samples_key = "\"samples\": [";
+    size_t pos = 0;
+    while ((pos = text.find(name_key, pos)) != std::string::npos) {
+        pos += name_key.size();
+        const size_t name_end = text.find('"', pos);
+        const size_t samples_pos = text.find(samples_key, pos);
+        const size_t next_name = text.find(name_key, pos);
+        if (name_end == std::string::npos || samples_pos == std::string::npos || samples_pos > next_name) {
+            throw std::runtime_error("malformed bench report " + path);
+        }
+        const std::string name = text.substr(pos, name_end - pos);
+
+        const size_t begin = samples_pos + samples_key.size();
+        const size_t end = text.find(']', begin);
+        if (end == std::string::npos) {
+            throw std::runtime_error("malformed bench report " + path);
+        }
+        std::string list = text.substr(begin, end - begin);
+        std::replace(list.begin(), list.end(), ',', ' ');
+        std::stringstream ss(list);
+        std::vector<double> samples;
+        double value = 0.0;
+        while (ss >> value) {
+            samples.push_back(value);
+        }
+        if (samples.empty()) {
+            throw std::runtime_error("no samples for " + name + " in " + path);
+        }
+
+        auto& pooled = report[name];
+        pooled.insert(pooled.end(), samples.begin(), samples.end());
+        pos = end;
+    }
+
+    if (report.empty()) {
+        throw std::runtime_error("no results in " + path);
+    }
+}
+
+/**
+ * @brief Writes pooled samples in the layout of a bench report
+ */
+void write_report(const std::string& path, const report_samples& report) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+
+    file << "{\n  \"suite\": \"yadro_1v\",\n  \"results\": [\n" << std::setprecision(6);
+    size_t r = 0;
+    for (const auto& [name, samples] : report) {
+        file << "    {\"name\": \"" << name << "\", \"ns_per_symbol\": " << median(samples) << ", \"samples\": [";
+        for (size_t s = 0; s < samples.size(); ++s) {
+            file << (s ? ", " : "") << samples[s];
+        }
+        file << "]}" << (++r < report.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+}
+
+void run_bench(const gate_options& opts, const std::string& output) {
+    std::string command = "\"" + opts.bench + "\"";
+    for (const std::string& arg : opts.bench_args) {
+        command += " \"" + arg + "\"";
+    }
+    command += " --out \"" + output + "\" 2>/dev/null";
+
+    std::cout << "Running " << command << std::endl;
+    if (std::system(command.c_str()) != 0) {
+        throw std::runtime_error("bench failed: " + command);
+    }
+}
+
+/**
+ * @brief Prints the comparison table
+ * @return Number of regressed kernels
+ */
+size_t compare(const report_samples& baseline_samples, const report_samples& current_samples, const gate_options& opts) {
+    std::map<std::string, kernel_stats> baseline;
+    std::map<std::string, kernel_stats> current;
+    for (const auto& [name, samples] : baseline_samples) {
+        baseline[name] = make_stats(samples);
+    }
+    for (const auto& [name, samples] : current_samples) {
+        current[name] = make_stats(samples);
+    }
+
+    std::vector<double> ratios;
+    for (const auto& [name, stats] : current) {
+        auto it = baseline.find(name);
+        if (it != baseline.end() && it->second.median > 0) {
+            ratios.push_back(stats.median / it->second.median);
+        }
+    }
+    if (ratios.empty()) {
+        throw std::runtime_error("no kernel of the current run is in the baseline");
+    }
+    const double machine = opts.absolute ? 1.0 : median(ratios);
+
+    std::cout << "Machine factor (median current / baseline): " << std::fixed << std::setprecision(3) << median(ratios)
+              << (opts.absolute ? " (not applied)" : "") << "\n\n";
+    std::cout << std::left << std::setw(36) << "kernel" << std::right
+              << std::setw(12) << "base ns/sym" << std::setw(12) << "cur ns/sym"
+              << std::setw(9) << "ratio" << std::setw(9) << "noise" << "  status\n";
+    std::cout << std::string(86, '-') << "\n";
+
+    size_t regressions = 0;
+    for (const auto& [name, stats] : current) {
+        std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3);
+
+        auto it = baseline.find(name);
+        if (it == baseline.end()) {
+            std::cout << std::setw(12) << "-" << std::setw(12) << stats.median << std::setw(9) << "-"
+                      << std::setw(9) << "-" << "  new\n";
+            continue;
+        }
+
+        const kernel_stats& base = it->second;
+        const double expected = base.median * machine;
+        const double ratio = expected > 0 ? stats.median / expected : 1.0;
+        const double noise = std::hypot(base.sigma * machine, stats.sigma);
+        const double delta = stats.median - expected;
+
+        std::string status = "ok";
+        if (ratio > 1.0 + opts.threshold && delta > opts.mad_k * noise) {
+            status = "REGRESSED";
+            regressions++;
+        } else if (ratio < 1.0 / (1.0 + opts.threshold) && -delta > opts.mad_k * noise) {
+            status = "faster";
+        }
+
+        std::cout << std::setw(12) << base.median << std::setw(12) << stats.median
+                  << std::setw(9) << ratio << std::setw(9) << noise << "  " << status << "\n";
+    }
+
+    for (const auto& [name, stats] : baseline) {
+        if (current.find(name) == current.end()) {
+            std::cout << std::left << std::setw(36) << name << std::right << std::setw(12) << stats.median
+                      << std::setw(12) << "-" << std::setw(9) << "-" << std::setw(9) << "-" << "  missing\n";
+        }
+    }
+
+    return regressions;
+}
+
+void print_usage(const char* app) {
+    std::cout << "Usage: " << app << " --baseline FILE (--bench PATH | --current FILE) [options] [-- bench args]\n"
+              << "  --runs N         bench processes pooled per report (default 3)\n"
+              << "  --threshold X    allowed relative slowdown (default 0.75, i.e. 1.75x)\n"
+              << "  --mad-k K        slowdown must also exceed K noise sigmas (default 3)\n"
+              << "  --absolute       compare raw medians, no machine factor\n"
+              << "  --update         write the current runs to the baseline and exit\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    gate_options opts;
+
+    try {
+        for (int a = 1; a < argc; ++a) {
+            const std::string arg = argv[a];
+            if (arg == "--") {
+                opts.bench_args.assign(argv + a + 1, argv + argc);
+                break;
+            }
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            if (arg == "--absolute") {
+                opts.absolute = true;
+                continue;
+            }
+            if (arg == "--update") {
+                opts.update = true;
+                continue;
+            }
+            if (a + 1 >= argc) {
+                throw std::invalid_argument("missing value of " + arg);
+            }
+            const std::string value = argv[++a];
+            if (arg == "--bench") {
+                opts.bench = value;
+            } else if (arg == "--baseline") {
+                opts.baseline = value;
+            } else if (arg == "--current") {
+                opts.current = value;
+            } else if (arg == "--threshold") {
+                opts.threshold = std::stod(value);
+            } else if (arg == "--runs") {
+                opts.runs = std::max<size_t>(1, std::stoull(value));
+            } else if (arg == "--mad-k") {
+                opts.mad_k = std::stod(value);
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+        if (opts.baseline.empty() || (opts.bench.empty() && opts.current.empty())) {
+            throw std::invalid_argument("--baseline and --bench or --current are required");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        report_samples current;
+        if (opts.current.empty()) {
+            const std::string output = (std::filesystem::temp_directory_path() /
+                                        ("bench_gate_" + std::to_string(::getpid()) + ".json")).string();
+            for (size_t run = 0; run < opts.runs; ++run) {
+                run_bench(opts, output);
+                parse_report(output, current);
+                std::remove(output.c_str());
+            }
+        } else {
+            parse_report(opts.current, current);
+        }
+
+        if (opts.update) {
+            write_report(opts.baseline, current);
+            std::cout << "Baseline " << opts.baseline << " updated" << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        report_samples baseline;
+        parse_report(opts.baseline, baseline);
+        const size_t regressions = compare(baseline, current, opts);
+        if (regressions) {
+            std::cout << "\n" << regressions << " kernel(s) regressed" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "\nNo regressions" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -12,6 +12,11 @@ plt.plot(qpsk_data['sigma'], qpsk_data['ber'], label='QPSK', color='blue')
 plt.plot(qam64_data['sigma'], qam64_data['ber'], label='QAM16', color='green')
 plt.plot(qam16_data['sigma'], qam16_data['ber'], label='QAM64', color='orange')
 
+# analytic reference written by job spec runs (see sim/theory.hpp)
+for data, color in ((qpsk_data, 'blue'), (qam64_data, 'green'), (qam16_data, 'orange')):
+    if 'theory_ber' in data.columns:
+        plt.plot(data['sigma'], data['theory_ber'], linestyle='--', linewidth=0.8, color=color)
+
 plt.xlabel('sigma')
 plt.ylabel('Bit Error Rate (BER)')
 plt.title('BER vs Noise Level for QPSK, QAM16, and QAM64')
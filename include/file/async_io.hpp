@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "types/def.hpp"
+
+/**
+ * @enum io_backend
+ * @brief Engines behind block_source and block_sink
+ */
+enum class io_backend {
+    AUTO,       //< io_uring if the kernel allows it, threads otherwise
+    URING,      //< io_uring through raw syscalls, no liburing
+    THREADS,    //< Pool of threads issuing pread / pwrite
+};
+
+/**
+ * @struct async_io_config
+ * @brief Parameters of block_source and block_sink
+ */
+struct async_io_config {
+    io_backend  backend         = io_backend::AUTO;
+    size_t      block_bytes     = 1 << 20;  // Bytes per block, rounded up to IO_ALIGN
+    size_t      queue_depth     = 4;        // Blocks in flight
+    bool        direct          = true;     // O_DIRECT if the file system supports it
+};
+
+// alignment of O_DIRECT buffers, offsets and lengths
+constexpr size_t IO_ALIGN = 4096;
+
+/**
+ * @struct io_request
+ * @brief One read or write of an io_engine
+ */
+struct io_request {
+    bool        write   = false;
+    int         fd      = -1;
+    void*       data    = nullptr;
+    size_t      bytes   = 0;
+    uint64_t    offset  = 0;
+    uint64_t    tag     = 0;        // Returned with the completion
+};
+
+/**
+ * @struct io_completion
+ * @brief Result of an io_request
+ */
+struct io_completion {
+    uint64_t    tag     = 0;
+    int64_t     result  = 0;        // Bytes transferred or -errno
+};
+
+/**
+ * @class io_engine
+ * @brief Queue of asynchronous reads and writes, completions in any order
+ */
+class io_engine {
+public:
+    using ptr = std::unique_ptr<io_engine>;
+
+    virtual ~io_engine() = default;
+
+    /**
+     * @brief Queues a request, the buffer must stay valid until its completion
+     */
+    virtual void submit(const io_request& request) = 0;
+
+    /**
+     * @brief Waits for the next completion
+     */
+    virtual io_completion wait() = 0;
+
+    virtual io_backend get_backend() const = 0;
+
+    /**
+     * @brief Creates an engine
+     * @param backend Requested engine, AUTO falls back to THREADS
+     * @param depth Requests in flight
+     * @throws std::runtime_error if URING is requested but unavailable
+     */
+    static ptr make(io_backend backend, size_t depth);
+};
+
+/**
+ * @brief Frees buffers of ext_alloc_aligned()
+ */
+struct aligned_deleter {
+    void operator()(byte* data) const;
+};
+
+using aligned_buffer = std::unique_ptr<byte[], aligned_deleter>;
+
+/**
+ * @brief Allocates an IO_ALIGN aligned buffer, bytes are rounded up to IO_ALIGN
+ */
+aligned_buffer ext_alloc_aligned(size_t bytes);
+
+/**
+ * @class block_source
+ * @brief Reads a file front to back with queue_depth block reads in flight
+ *
+ * Reads are issued ahead into a ring of aligned buffers; next() hands out
+ * the blocks in file order while the following ones are still loading.
+ */
+class block_source {
+public:
+    using ptr = std::unique_ptr<block_source>;
+
+    /**
+     * @brief Constructor, opens the file and issues the first reads
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit block_source(const std::string& filename, const async_io_config& cfg = async_io_config());
+
+    static ptr make(const std::string& filename, const async_io_config& cfg = async_io_config());
+
+    /**
+     * @brief Waits for reads still in flight and closes the file
+     */
+    ~block_source();
+
+    block_source(const block_source&) = delete;
+    block_source& operator=(const block_source&) = delete;
+
+    /**
+     * @brief Gets the next block, valid until the next call
+     * @return Block of block_bytes (shorter at the end), empty past the end
+     * @throws std::runtime_error on a read error
+     */
+    std::span<const byte> next();
+
+    /**
+     * @brief Gets the file size
+     */
+    uint64_t size() const {
+        return size_m;
+    }
+
+    /**
+     * @brief Gets the size of a full block
+     */
+    size_t block_bytes() const {
+        return block_bytes_m;
+    }
+
+    io_backend get_backend() const {
+        return engine_m->get_backend();
+    }
+
+private:
+    void submit(size_t slot);
+    void read(size_t slot);     // the part of the slot's block not loaded yet
+    size_t block_size(uint64_t block) const;
+
+    std::string                 filename_m;
+    io_engine::ptr              engine_m;
+    int                         fd_m = -1;
+    uint64_t                    size_m = 0;
+    size_t                      block_bytes_m = 0;
+    std::vector<aligned_buffer> buffers_m;
+    std::vector<uint64_t>       slot_block_m;   // Block loading into each slot
+    std::vector<size_t>         slot_filled_m;  // Bytes of that block read so far
+    std::vector<bool>           slot_done_m;
+    uint64_t                    next_submit_m = 0;
+    uint64_t                    next_emit_m = 0;
+    size_t                      in_flight_m = 0;
+    bool                        held_m = false; // The slot of the last next() is still lent out
+};
+
+/**
+ * @class block_sink
+ * @brief Writes a file front to back with queue_depth block writes in flight
+ *
+ * Blocks are filled in aligned buffers and written while the next ones
+ * are filled. With O_DIRECT the last block is written padded and the file
+ * is truncated to its size by close().
+ */
+class block_sink {
+public:
+    using ptr = std::unique_ptr<block_sink>;
+
+    /**
+     * @brief Constructor, creates the file
+     * @throws std::runtime_error if the file cannot be created
+     */
+    explicit block_sink(const std::string& filename, const async_io_config& cfg = async_io_config());
+
+    static ptr make(const std::string& filename, const async_io_config& cfg = async_io_config());
+
+    /**
+     * @brief Closes the file, errors are swallowed (call close() to see them)
+     */
+    ~block_sink();
+
+    block_sink(const block_sink&) = delete;
+    block_sink& operator=(const block_sink&) = delete;
+
+    /**
+     * @brief Gets a free block buffer, waits for a write if all are in flight
+     */
+    std::span<byte> acquire();
+
+    /**
+     * @brief Writes the acquired buffer
+     * @param bytes Bytes of the buffer to write, block_bytes except for the last block
+     * @throws std::logic_error if nothing is acquired or a short block was committed before
+     */
+    void commit(size_t bytes);
+
+    /**
+     * @brief Copies bytes into blocks, committing every full one
+     */
+    void write(std::span<const byte> data);
+
+    /**
+     * @brief Commits the partial block, waits for all writes, truncates and closes the file
+     * @throws std::runtime_error on a write error
+     */
+    void close();
+
+    /**
+     * @brief Gets the number of bytes written or staged
+     */
+    uint64_t size() const {
+        return offset_m + staged_m;
+    }
+
+    io_backend get_backend() const {
+        return engine_m->get_backend();
+    }
+
+private:
+    void reap();
+
+    std::string                 filename_m;
+    io_engine::ptr              engine_m;
+    int                         fd_m = -1;
+    size_t                      block_bytes_m = 0;
+    std::vector<aligned_buffer> buffers_m;
+    std::vector<size_t>         free_m;         // Slots not in flight
+    long                        acquired_m = -1;// Slot lent out by acquire()
+    size_t                      staged_m = 0;   // Bytes of write() in the acquired slot
+    uint64_t                    offset_m = 0;   // Bytes committed
+    size_t                      in_flight_m = 0;
+    bool                        short_m = false;// A short block ended the file
+};
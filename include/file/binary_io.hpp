@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Helpers of the small binary files (checkpoints, shard files, the result
+ * cache and binary result files): values are stored as their object
+ * representation in native endianness, behind a 4-byte magic. Error
+ * messages name the kind of file, e.g. "Truncated checkpoint file".
+ */
+
+/**
+ * @brief Writes the object representation of a value
+ * @param file Output stream
+ * @param value Trivially copyable value
+ */
+template<typename T>
+void ext_write_value(std::ostream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Reads a value written by ext_write_value()
+ * @param file Input stream
+ * @param value Receives the value
+ * @param kind Kind of file for the error message
+ * @throws std::runtime_error if the file ends first
+ */
+template<typename T>
+void ext_read_value(std::istream& file, T& value, const char* kind) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    if (!file) {
+        throw std::runtime_error(std::string("Truncated ") + kind + " file");
+    }
+}
+
+/**
+ * @brief Reads a 4-byte magic and compares it
+ * @return false if the file is shorter or starts with something else
+ */
+inline bool ext_read_magic(std::istream& file, const char (&magic)[4]) {
+    char found[4];
+    file.read(found, sizeof(found));
+    return file && std::memcmp(found, magic, sizeof(found)) == 0;
+}
+
+/**
+ * @brief Writes a file through a temporary file and a rename, so a kill
+ *        or a concurrent reader never sees a torn file
+ * @param filename File to create or replace
+ * @param write Writes the whole content
+ * @param kind Kind of file for the error messages
+ * @throws std::runtime_error if the file cannot be written or replaced
+ */
+inline void ext_replace_file(const std::string& filename, const std::function<void(std::ofstream&)>& write,
+                             const char* kind) {
+    const std::string tmp_filename = filename + ".tmp";
+
+    {
+        std::ofstream file(tmp_filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::string("Could not open ") + kind + " file: " + tmp_filename);
+        }
+        write(file);
+        file.close();
+        if (!file) {
+            throw std::runtime_error(std::string("Could not write ") + kind + " file: " + tmp_filename);
+        }
+    }
+
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error(std::string("Could not replace ") + kind + " file: " + filename);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <memory>
 #include "phys/qam/qam.hpp"
@@ -19,6 +20,15 @@ namespace file_io {
  */
 std::string get_order_name(qam_order order);
 
+/**
+ * @struct export_options
+ * @brief Layout of symbol dumps
+ */
+struct export_options {
+    size_t  decimation  = 1;        // Write every Nth symbol (indices keep their original value)
+    bool    binary      = false;    // Raw records for gnuplot's binary format instead of text (uint64 index, float32 i q)
+};
+
 /**
  * @brief Saves the constellation map to a text file
  * @tparam DTYPE Data type for components of a complex number
@@ -75,13 +85,15 @@ bool save_and_plot_constellation(
  * @param symbols Modulated symbols
  * @param filename File name
  * @param include_indices Whether to include point indices in the file
+ * @param options Decimation and binary output
  * @return true if saving was successful, false otherwise
  */
 template<typename DTYPE>
 bool save_modulated_symbols_to_file(
     const complex<DTYPE>& symbols,
     const std::string& filename,
-    bool include_indices = true
+    bool include_indices = true,
+    const export_options& options = export_options()
 );
 
 /**
@@ -90,13 +102,30 @@ bool save_modulated_symbols_to_file(
  * @param script_filename The name of the file for the script
  * @param title The title for the plot
  * @param include_indices Whether to include point indices in the visualization
+ * @param options Layout of the data file
  * @return true if creation succeeds, false otherwise
  */
 bool create_modulated_gnuplot_script(
     const std::string& data_filename,
     const std::string& script_filename,
     const std::string& title,
-    bool include_indices = true
+    bool include_indices = true,
+    const export_options& options = export_options()
+);
+
+/**
+ * @brief Creates a script for gnuplot to draw a constellation heat map
+ * @param data_filename Binary matrix of the histogram (float32, gnuplot's binary matrix layout)
+ * @param script_filename The name of the file for the script
+ * @param title The title for the plot
+ * @param limit Both axes cover [-limit, limit]
+ * @return true if creation succeeds, false otherwise
+ */
+bool create_histogram_gnuplot_script(
+    const std::string& data_filename,
+    const std::string& script_filename,
+    const std::string& title,
+    double limit
 );
 
 /**
@@ -106,6 +135,7 @@ bool create_modulated_gnuplot_script(
  * @param base_filename The base file name (without extension)
  * @param title The title for the plot
  * @param include_indices Whether to include point indices
+ * @param options Decimation and binary output
  * @return true if the operation succeeds, false otherwise
  */
 template<typename DTYPE>
@@ -113,7 +143,8 @@ bool save_and_plot_modulated_symbols(
     const complex<DTYPE>& symbols,
     const std::string& base_filename,
     const std::string& title,
-    bool include_indices = true
+    bool include_indices = true,
+    const export_options& options = export_options()
 );
 
 }
@@ -140,11 +171,13 @@ bool save_and_plot_modulated_symbols(
     template bool file_io::save_modulated_symbols_to_file(          \
         const complex<dtype>& symbols,                              \
         const std::string& filename,                                \
-        bool include_indices                                        \
+        bool include_indices,                                       \
+        const export_options& options                               \
     );                                                              \
     template bool file_io::save_and_plot_modulated_symbols(         \
         const complex<dtype>& symbols,                              \
         const std::string& base_filename,                           \
         const std::string& title,                                   \
-        bool include_indices                                        \
+        bool include_indices,                                       \
+        const export_options& options                               \
     );
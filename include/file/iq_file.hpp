@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "phys/qam/qam.hpp"
+#include "types/complex.hpp"
+#include "types/def.hpp"
+
+/**
+ * @enum iq_dtype
+ * @brief Sample component type of an IQ file
+ */
+enum class iq_dtype : uint32_t {
+    FLOAT32 = 0,
+    FLOAT64 = 1,
+};
+
+/**
+ * @enum iq_layout
+ * @brief Payload layout of an IQ file
+ */
+enum class iq_layout : uint32_t {
+    INTERLEAVED = 0,    //< I0 Q0 I1 Q1 ... (SigMF cf32_le / cf64_le)
+    PLANAR      = 1,    //< Per block [I0 .. In | Q0 .. Qn], the layout of complex<DTYPE>
+};
+
+/**
+ * @struct iq_header
+ * @brief On-disk header of an IQ file (little endian, padded to IQ_PAYLOAD_OFFSET)
+ */
+struct iq_header {
+    char        magic[4]        = {'Y', 'Q', 'I', 'Q'};
+    uint32_t    version         = 1;
+    iq_dtype    dtype           = iq_dtype::FLOAT32;
+    iq_layout   layout          = iq_layout::PLANAR;
+    uint64_t    sample_count    = 0;        // Complex samples in the payload
+    uint64_t    block_samples   = 0;        // Samples per block (the last one may be shorter)
+    uint32_t    modulation      = 0;        // qam_order of the samples, 0 if unknown
+    uint32_t    reserved        = 0;
+    double      sample_rate     = 0.0;      // Hz, 0 if unknown
+    double      sigma           = 0.0;      // Channel noise of the capture, 0 if unknown
+    uint64_t    payload_offset  = 0;        // Byte offset of the first block
+};
+
+static_assert(sizeof(iq_header) == 64, "iq_header must stay 64 bytes");
+
+// payload starts page aligned, so blocks can be mapped and read with O_DIRECT
+constexpr uint64_t IQ_PAYLOAD_OFFSET = 4096;
+
+/**
+ * @struct iq_metadata
+ * @brief Parameters of a new IQ file
+ */
+struct iq_metadata {
+    iq_layout   layout          = iq_layout::PLANAR;
+    size_t      block_samples   = 1 << 16;  // Samples per block
+    qam_order   modulation      = static_cast<qam_order>(0);
+    double      sample_rate     = 0.0;
+    double      sigma           = 0.0;
+    bool        sigmf           = false;    // Write a <file>.sigmf-meta sidecar (interleaved only)
+};
+
+/**
+ * @struct iq_view
+ * @brief Zero-copy view of one block of a mapped IQ file
+ */
+template<typename DTYPE>
+struct iq_view {
+    size_t                  first   = 0;    // Index of the first sample
+    size_t                  count   = 0;    // Samples in the block
+    std::span<const DTYPE>  i;              // In-phase components (PLANAR)
+    std::span<const DTYPE>  q;              // Quadrature components (PLANAR)
+    std::span<const DTYPE>  interleaved;    // I/Q pairs (INTERLEAVED)
+};
+
+/**
+ * @class iq_writer
+ * @brief Appends complex samples to an IQ file block by block
+ *
+ * Samples are staged until a block is full and written with one write();
+ * close() writes the last (short) block, patches the sample count into the
+ * header and writes the SigMF sidecar if requested.
+ * @tparam DTYPE float or double
+ */
+template<typename DTYPE>
+class iq_writer {
+public:
+    using ptr = std::unique_ptr<iq_writer>;
+
+    /**
+     * @brief Constructor, creates the file and writes a provisional header
+     * @param filename Output file
+     * @param meta Layout and metadata
+     * @throws std::runtime_error if the file cannot be created
+     * @throws std::invalid_argument on a zero block size or a planar SigMF request
+     */
+    iq_writer(const std::string& filename, const iq_metadata& meta = iq_metadata());
+
+    /**
+     * @brief Creates a writer instance
+     */
+    static ptr make(const std::string& filename, const iq_metadata& meta = iq_metadata());
+
+    /**
+     * @brief Closes the file, errors are swallowed (call close() to see them)
+     */
+    ~iq_writer();
+
+    iq_writer(const iq_writer&) = delete;
+    iq_writer& operator=(const iq_writer&) = delete;
+
+    /**
+     * @brief Appends samples
+     * @param i In-phase components
+     * @param q Quadrature components, same size as i
+     */
+    void append(std::span<const DTYPE> i, std::span<const DTYPE> q);
+
+    /**
+     * @brief Appends the first count samples of a container
+     */
+    void append(const complex<DTYPE>& symbols, size_t count);
+
+    /**
+     * @brief Writes the last block, the final header and the sidecar, closes the file
+     */
+    void close();
+
+    /**
+     * @brief Gets the number of appended samples
+     */
+    uint64_t size() const {
+        return header_m.sample_count + staged_m;
+    }
+
+private:
+    void write_block();
+    void write_all(const void* data, size_t bytes, uint64_t offset);
+    void write_sigmf() const;
+
+    std::string             filename_m;
+    iq_metadata             meta_m;
+    iq_header               header_m;
+    int                     fd_m = -1;
+    uint64_t                offset_m = IQ_PAYLOAD_OFFSET;
+    std::vector<DTYPE>      block_m;        // Staged block in file layout
+    size_t                  staged_m = 0;   // Samples in block_m
+};
+
+/**
+ * @class iq_reader
+ * @brief Memory-mapped reader of an IQ file
+ *
+ * The whole file is mapped read-only; block() returns spans into the
+ * mapping, read() copies any range into a complex<DTYPE> container. The
+ * reader must outlive all views.
+ * @tparam DTYPE float or double, must match the dtype of the file
+ */
+template<typename DTYPE>
+class iq_reader {
+public:
+    using ptr = std::unique_ptr<iq_reader>;
+
+    /**
+     * @brief Constructor, maps the file
+     * @throws std::runtime_error if the file is missing, foreign, truncated or of another dtype
+     */
+    explicit iq_reader(const std::string& filename);
+
+    /**
+     * @brief Creates a reader instance
+     */
+    static ptr make(const std::string& filename);
+
+    ~iq_reader();
+
+    iq_reader(const iq_reader&) = delete;
+    iq_reader& operator=(const iq_reader&) = delete;
+
+    const iq_header& get_header() const {
+        return header_m;
+    }
+
+    /**
+     * @brief Gets the number of samples
+     */
+    size_t size() const {
+        return header_m.sample_count;
+    }
+
+    /**
+     * @brief Gets the number of blocks
+     */
+    size_t block_count() const;
+
+    /**
+     * @brief Gets a zero-copy view of a block
+     * @throws std::out_of_range if index >= block_count()
+     */
+    iq_view<DTYPE> block(size_t index) const;
+
+    /**
+     * @brief Copies samples into a container (planar, from index 0)
+     * @param first Index of the first sample
+     * @param count Number of samples
+     * @param out Container holding at least count samples
+     * @throws std::out_of_range if the range exceeds the file or the container
+     */
+    void read(size_t first, size_t count, complex<DTYPE>& out) const;
+
+    /**
+     * @brief Gets the raw payload bytes of the file
+     */
+    std::span<const byte> payload() const;
+
+private:
+    const DTYPE* block_data(size_t index) const;
+
+    iq_header               header_m;
+    const byte*             map_m = nullptr;
+    size_t                  map_bytes_m = 0;
+};
+
+/**
+ * @brief Gets the dtype tag of a component type
+ */
+template<typename DTYPE>
+constexpr iq_dtype ext_iq_dtype();
+
+template<>
+constexpr iq_dtype ext_iq_dtype<float>() {
+    return iq_dtype::FLOAT32;
+}
+
+template<>
+constexpr iq_dtype ext_iq_dtype<double>() {
+    return iq_dtype::FLOAT64;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum result_format
+ * @brief Back ends of result_writer
+ */
+enum class result_format {
+    CSV,        //< Text, one row per record, formatted per column
+    BINARY,     //< "YQRW" header with the column names, then raw double records
+};
+
+/**
+ * @struct result_column
+ * @brief Column of a result file and its CSV formatting
+ */
+struct result_column {
+    std::string name;                   // Header name
+    int         precision   = 6;        // Digits after the decimal point
+    bool        scientific  = false;    // Scientific instead of fixed notation
+};
+
+/**
+ * @struct result_table
+ * @brief Content of a binary result file
+ */
+struct result_table {
+    std::vector<std::string>    columns;    // Column names
+    std::vector<double>         values;     // Row-major records
+
+    size_t rows() const {
+        return columns.empty() ? 0 : values.size() / columns.size();
+    }
+
+    double at(size_t row, size_t column) const {
+        return values[row * columns.size() + column];
+    }
+};
+
+/**
+ * @struct result_writer_config
+ * @brief Buffering of result_writer
+ */
+struct result_writer_config {
+    size_t  buffer_bytes    = 1 << 20;  // Buffer size that triggers a write
+    bool    background      = true;     // Write from a background thread
+};
+
+/**
+ * @class result_writer
+ * @brief Buffered sink of numeric records with CSV and binary back ends
+ *
+ * Records are formatted with std::to_chars (CSV) or copied raw (binary)
+ * into a large buffer. A full buffer is handed to a background thread and
+ * the producer continues in a recycled one, so push() never waits for the
+ * disk unless the writer falls more than one buffer behind. Without the
+ * background thread full buffers are written on the caller's thread.
+ * Write errors of the background thread are rethrown by the next push(),
+ * flush() or close().
+ */
+class result_writer {
+public:
+    using ptr = std::unique_ptr<result_writer>;
+
+    /**
+     * @brief Constructor, opens the file and writes the header
+     * @param filename Output file
+     * @param columns Columns of every record
+     * @param format Back end
+     * @param cfg Buffering
+     * @throws std::runtime_error if the file cannot be opened
+     * @throws std::invalid_argument if there are no columns
+     */
+    result_writer(const std::string& filename, std::vector<result_column> columns,
+                  result_format format = result_format::CSV, const result_writer_config& cfg = result_writer_config());
+
+    /**
+     * @brief Creates a writer instance
+     */
+    static ptr make(const std::string& filename, std::vector<result_column> columns,
+                    result_format format = result_format::CSV, const result_writer_config& cfg = result_writer_config());
+
+    /**
+     * @brief Flushes and closes, errors are swallowed (call close() to see them)
+     */
+    ~result_writer();
+
+    result_writer(const result_writer&) = delete;
+    result_writer& operator=(const result_writer&) = delete;
+
+    /**
+     * @brief Appends one record
+     * @param values One value per column
+     * @throws std::invalid_argument on a column count mismatch
+     */
+    void push(std::span<const double> values);
+
+    /**
+     * @brief Appends one record
+     */
+    void push(std::initializer_list<double> values) {
+        push(std::span<const double>(values.begin(), values.size()));
+    }
+
+    /**
+     * @brief Writes everything pushed so far and flushes the file
+     */
+    void flush();
+
+    /**
+     * @brief Flushes, stops the background thread and closes the file
+     */
+    void close();
+
+    /**
+     * @brief Gets the number of pushed records
+     */
+    uint64_t get_records() const {
+        return records_m;
+    }
+
+    /**
+     * @brief Reads a file written with result_format::BINARY
+     * @throws std::runtime_error if the file is missing, foreign or truncated
+     */
+    static result_table load_binary(const std::string& filename);
+
+private:
+    void write_header();
+    void append_csv(std::span<const double> values);
+    void submit();
+    void write_buffer(const std::vector<char>& buffer);
+    void writer_loop();
+    void rethrow();
+
+    std::vector<result_column>          columns_m;
+    result_format                       format_m;
+    result_writer_config                cfg_m;
+    std::ofstream                       file_m;
+    uint64_t                            records_m = 0;
+    bool                                closed_m = false;
+
+    std::vector<char>                   active_m;       // Filled by push()
+    std::vector<char>                   pending_m;      // Handed to the writer thread
+    std::vector<char>                   spare_m;        // Recycled buffer
+
+    std::mutex                          mutex_m;
+    std::condition_variable             cv_m;
+    bool                                has_pending_m = false;
+    bool                                stop_m = false;
+    std::exception_ptr                  error_m;
+    std::thread                         thread_m;
+};
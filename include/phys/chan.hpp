@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cmath>
+#include <limits>
 #include <random>
-#include <vector>
+#include <stdexcept>
+#include "sim/bit_source.hpp"
 #include "types/def.hpp"
 #include "types/complex.hpp"
 
@@ -16,29 +18,37 @@ enum class noise_type {
 
 /**
  * @class noise
- * @brief Class for generating and managing noise
+ * @brief Class for generating noise
+ *
+ * Samples are drawn as a stream from a gaussian_source: the same (seed,
+ * stream) pair always gives the same noise and the sequence never repeats.
  * @tparam DTYPE Data type for noise components
  */
 template<typename DTYPE>
 class noise { 
 public:
     /**
-     * @brief Default constructor
+     * @brief Default constructor (no noise, random seed)
      */
-    explicit noise() : sigma_m(0.0), noise_seq_len_m(1000), noise_type_m(noise_type::AWGN) {
-        recalc_noise();
-    }
+    explicit noise() : noise(0.0) {}
     
     /**
-     * @brief Constructor with parameters
+     * @brief Constructor with a random seed
      * @param sigma Standard deviation of noise
-     * @param seq_len Noise sequence length
      * @param type Noise type
      */
-    explicit noise(double sigma, size_t seq_len = 1000, noise_type type = noise_type::AWGN) 
-        : sigma_m(sigma), noise_seq_len_m(seq_len), noise_type_m(type) {
-        recalc_noise();
-    }
+    explicit noise(double sigma, noise_type type = noise_type::AWGN) 
+        : noise(sigma, std::random_device{}(), 0, type) {}
+
+    /**
+     * @brief Constructor with a reproducible stream
+     * @param sigma Standard deviation of noise
+     * @param seed Experiment seed
+     * @param stream Stream index (thread, modulation, work item, ...)
+     * @param type Noise type
+     */
+    noise(double sigma, uint64_t seed, uint64_t stream, noise_type type = noise_type::AWGN) 
+        : sigma_m(sigma), noise_type_m(type), source_m(seed, stream) {}
     
     /**
      * @brief Destructor
@@ -62,34 +72,20 @@ public:
     }
     
     /**
-     * @brief Gets the noise sequence length
-     * @return Sequence length
-     */
-    size_t get_sequence_length() const {
-        return noise_seq_len_m;
-    }
-    
-    /**
-     * @brief Recalculates the noise sequence with new sigma value
+     * @brief Sets a new sigma value, the stream continues
      * @param new_sigma New sigma value
      */
-    void recalc_sequence(double new_sigma) { 
-        if (sigma_m == new_sigma) { 
-            // If sigma has not changed, do nothing
-            return;
-        }
-
+    void set_sigma(double new_sigma) { 
         sigma_m = new_sigma;
-        recalc_noise();
     }
-    
+
     /**
-     * @brief Sets the noise sequence length
-     * @param seq_len New sequence length
+     * @brief Restarts the noise at another stream
+     * @param seed Experiment seed
+     * @param stream Stream index
      */
-    void set_sequence_length(size_t seq_len) {
-        noise_seq_len_m = seq_len;
-        recalc_noise();
+    void set_seed(uint64_t seed, uint64_t stream = 0) {
+        source_m = gaussian_source(seed, stream);
     }
     
     /**
@@ -98,7 +94,13 @@ public:
      */
     void set_type(noise_type type) {
         noise_type_m = type;
-        recalc_noise();
+    }
+
+    /**
+     * @brief Gets the sample source (to checkpoint the stream)
+     */
+    gaussian_source& get_source() {
+        return source_m;
     }
     
     /**
@@ -106,15 +108,8 @@ public:
      * @return Noise value
      */
     DTYPE get_next_noise() {
-        if (noise_sequence_m.empty()) {
-            recalc_noise();
-        }
-        
-        if (current_index_m >= noise_sequence_m.size()) {
-            current_index_m = 0;
-        }
-        
-        return noise_sequence_m[current_index_m++];
+        // drawn at any sigma, so the stream position does not depend on it
+        return static_cast<DTYPE>(sigma_m * source_m.next());
     }
     
     /**
@@ -135,46 +130,40 @@ public:
         return {value.i + get_next_noise(), value.q + get_next_noise()};
     }
 
-protected: 
-    /**
-     * @brief Recalculates the noise sequence
-     */
-    void recalc_noise() { 
-        noise_sequence_m.resize(noise_seq_len_m);
-        current_index_m = 0;
-        
-        switch (noise_type_m) {
-            case noise_type::AWGN:
-                generate_awgn_noise();
-                break;
-            default:
-                // Use AWGN by default
-                generate_awgn_noise();
-                break;
-        }
-    }
-    
-    /**
-     * @brief Generates AWGN noise
-     */
-    void generate_awgn_noise() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::normal_distribution<DTYPE> dist(0.0, sigma_m);
-        
-        for (size_t i = 0; i < noise_seq_len_m; i++) {
-            noise_sequence_m[i] = dist(gen);
-        }
-    }
-
 private: 
     double sigma_m;                    // Standard deviation of noise
-    size_t noise_seq_len_m;            // Noise sequence length
     noise_type noise_type_m;           // Noise type
-    std::vector<DTYPE> noise_sequence_m; // Noise sequence
-    size_t current_index_m = 0;        // Current index in the sequence
+    gaussian_source source_m;          // N(0, 1) samples
 };
 
+/**
+ * @brief Converts Es/N0 to the per-component noise sigma
+ * @param esn0_db Es/N0 in dB
+ * @param symbol_energy Average symbol energy Es
+ * @return sigma with N0 = 2 * sigma^2
+ */
+inline double ext_esn0_to_sigma(double esn0_db, double symbol_energy = 1.0) {
+    if (symbol_energy <= 0) {
+        throw std::invalid_argument("symbol_energy must be > 0");
+    }
+    const double esn0 = std::pow(10.0, esn0_db / 10.0);
+    return std::sqrt(symbol_energy / (2.0 * esn0));
+}
+
+/**
+ * @brief Converts Eb/N0 to the per-component noise sigma
+ * @param ebn0_db Eb/N0 in dB
+ * @param bits_per_symbol Bits per symbol of the modulation
+ * @param symbol_energy Average symbol energy Es
+ * @return sigma with N0 = 2 * sigma^2 and Eb = Es / bits_per_symbol
+ */
+inline double ext_ebn0_to_sigma(double ebn0_db, uint32_t bits_per_symbol, double symbol_energy = 1.0) {
+    if (bits_per_symbol == 0) {
+        throw std::invalid_argument("bits_per_symbol must be > 0");
+    }
+    return ext_esn0_to_sigma(ebn0_db + 10.0 * std::log10(static_cast<double>(bits_per_symbol)), symbol_energy);
+}
+
 /**
  * @class channel
  * @brief Class for modeling a communication channel
@@ -186,7 +175,7 @@ public:
     /**
      * @brief Default constructor
      */
-    explicit channel() : noise_m(0.0), snr_m(0.0) {}
+    explicit channel() : noise_m(0.0), snr_m(calculate_snr(0.0)) {}
     
     /**
      * @brief Constructor with parameters
@@ -213,10 +202,55 @@ public:
      * @param sigma New sigma value
      */
     void set_sigma(double sigma) {
-        noise_m.recalc_sequence(sigma);
+        noise_m.set_sigma(sigma);
         snr_m = calculate_snr(sigma);
     }
+
+    /**
+     * @brief Restarts the noise at another stream
+     * @param seed Experiment seed
+     * @param stream Stream index
+     */
+    void set_seed(uint64_t seed, uint64_t stream = 0) {
+        noise_m.set_seed(seed, stream);
+    }
+
+    /**
+     * @brief Gets the noise sample source (to checkpoint the stream)
+     */
+    gaussian_source& get_noise_source() {
+        return noise_m.get_source();
+    }
     
+    /**
+     * @brief Sets the average energy of the transmitted symbols
+     * @param symbol_energy Es of the constellation (1 for unit-energy tables)
+     */
+    void set_signal_energy(double symbol_energy) {
+        if (symbol_energy <= 0) {
+            throw std::invalid_argument("symbol_energy must be > 0");
+        }
+        signal_energy_m = symbol_energy;
+        snr_m = calculate_snr(noise_m.get_sigma());
+    }
+
+    /**
+     * @brief Sets the noise level from Es/N0
+     * @param esn0_db Es/N0 in dB (Es as set by set_signal_energy)
+     */
+    void set_esn0_db(double esn0_db) {
+        set_sigma(ext_esn0_to_sigma(esn0_db, signal_energy_m));
+    }
+
+    /**
+     * @brief Sets the noise level from Eb/N0
+     * @param ebn0_db Eb/N0 in dB (Es as set by set_signal_energy)
+     * @param bits_per_symbol Bits per symbol of the modulation
+     */
+    void set_ebn0_db(double ebn0_db, uint32_t bits_per_symbol) {
+        set_sigma(ext_ebn0_to_sigma(ebn0_db, bits_per_symbol, signal_energy_m));
+    }
+
     /**
      * @brief Gets the channel quality estimate
      * @return Sigma value
@@ -227,7 +261,7 @@ public:
     
     /**
      * @brief Gets the logarithmic channel quality estimate
-     * @return SNR in dB
+     * @return Es/N0 in dB
      */
     DTYPE get_log_quality() const {
         return static_cast<DTYPE>(snr_m);
@@ -266,25 +300,47 @@ public:
         return result;
     }
 
+    /**
+     * @brief Passes a block of complex values through the channel
+     *        into a preallocated container (may be the input itself)
+     * @param symbols Original sequence
+     * @param result Output container
+     * @param count Number of symbols to pass
+     */
+    void transmit(const complex<DTYPE>& symbols, complex<DTYPE>& result, size_t count) {
+        if (count > symbols.size() / 2 || count > result.size() / 2) {
+            throw std::out_of_range("requested symbol count is out of range");
+        }
+
+        auto [in_i, in_q] = symbols.decompose();
+        auto [out_i, out_q] = result.decompose();
+
+        for (size_t i = 0; i < count; i++) {
+            // same noise draw order as add_noise(complex_t): I first, then Q
+            DTYPE noisy_i = in_i[i] + noise_m.get_next_noise();
+            DTYPE noisy_q = in_q[i] + noise_m.get_next_noise();
+            out_i[i] = noisy_i;
+            out_q[i] = noisy_q;
+        }
+    }
+
 private: 
     /**
-     * @brief Calculates SNR from sigma value
-     * @param sigma Sigma value
-     * @return SNR in dB
+     * @brief Calculates Es/N0 from sigma value
+     * @param sigma Sigma value (per component, N0 = 2 * sigma^2)
+     * @return Es/N0 in dB
      */
     double calculate_snr(double sigma) {
         if (sigma <= 0) {
             return std::numeric_limits<double>::infinity();
         }
-        // Assume signal power = 1
-        double signal_power = 1.0;
-        double noise_power = sigma * sigma;
-        // SNR = 10 * log10(signal_power / noise_power)
-        return 10.0 * std::log10(signal_power / noise_power);
+        double noise_power = 2.0 * sigma * sigma;
+        return 10.0 * std::log10(signal_energy_m / noise_power);
     }
 
-    noise<DTYPE> noise_m;  // Noise object
-    double snr_m;          // Signal-to-noise ratio in dB
+    noise<DTYPE> noise_m;               // Noise object
+    double signal_energy_m = 1.0;       // Average symbol energy Es
+    double snr_m;                       // Es/N0 in dB
 };
 
 // Explicit template instantiation declarations
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cmath>
 #include <map>
 #include <functional>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 #include "types/def.hpp"
 #include "types/complex.hpp"
@@ -59,6 +62,18 @@ public:
         return constellation_map_m;
     }
 
+    /**
+     * @brief Gets the constellation scaled to unit average energy
+     * @return Points of get_constellation() divided by sqrt(get_symbol_energy())
+     */
+    const constellation_map_type& get_unit_constellation() const { 
+        return unit_constellation_map_m;
+    }
+
+    double get_symbol_energy() const override { 
+        return symbol_energy_m;
+    }
+
     qam_order get_order() const override { 
         return ORDER; 
     }
@@ -71,6 +86,19 @@ private:
         if (constellation_generator_m) {
             constellation_map_m = constellation_generator_m();
         }
+
+        // unit-energy copy, so Es/N0 is the same quantity for every order
+        double energy = 0.0;
+        for (const auto& [index, point] : constellation_map_m) {
+            energy += static_cast<double>(point.i) * point.i + static_cast<double>(point.q) * point.q;
+        }
+        symbol_energy_m = constellation_map_m.empty() ? 0.0 : energy / constellation_map_m.size();
+
+        const double scale = symbol_energy_m > 0 ? 1.0 / std::sqrt(symbol_energy_m) : 1.0;
+        unit_constellation_map_m.clear();
+        for (const auto& [index, point] : constellation_map_m) {
+            unit_constellation_map_m[index] = {static_cast<DTYPE>(point.i * scale), static_cast<DTYPE>(point.q * scale)};
+        }
     }
 
     void init_default_constellation() { 
@@ -156,9 +184,101 @@ private:
     }
 
     constellation_map_type  constellation_map_m;
+    constellation_map_type  unit_constellation_map_m;
+    double                  symbol_energy_m = 0.0;
     generator_function      constellation_generator_m;
 };
 
 QAM_TEMPLATES(qam_mapper, qam_order::QPSK)
 QAM_TEMPLATES(qam_mapper, qam_order::QAM16)
 QAM_TEMPLATES(qam_mapper, qam_order::QAM64)
+
+
+/**
+ * @struct qam_table
+ * @brief Flat copy of a constellation map for block processing
+ */
+template<typename DTYPE>
+struct qam_table {
+    std::vector<complex_t<DTYPE>>   lut;        // symbol index -> point ({0,0} for missing indices)
+    std::vector<uint32_t>           indices;    // present indices in ascending order
+    std::vector<complex_t<DTYPE>>   points;     // points, parallel to indices
+};
+
+/**
+ * @brief Flattens the constellation of a mapper
+ * @param mapper Mapper
+ * @param unit_energy Use the unit average energy constellation
+ * @return Table with the current constellation of the mapper
+ */
+template<typename DTYPE, qam_order ORDER>
+qam_table<DTYPE> ext_make_table(const qam_mapper<DTYPE, ORDER>& mapper, bool unit_energy = false) { 
+    qam_table<DTYPE> table;
+    table.lut.assign(static_cast<size_t>(ORDER), complex_t<DTYPE>());
+
+    const auto& constellation = unit_energy ? mapper.get_unit_constellation() : mapper.get_constellation();
+    for (const auto& [index, point] : constellation) {
+        if (index < table.lut.size()) {
+            table.lut[index] = point;
+        }
+        table.indices.push_back(index);
+        table.points.push_back(point);
+    }
+
+    return table;
+}
+
+/**
+ * @brief Resolves a type-erased mapper into a flat constellation table
+ * @param mapper Pointer to the mapper
+ * @param unit_energy Use the unit average energy constellation
+ * @return Table with the current constellation of the mapper
+ */
+template<typename DTYPE>
+qam_table<DTYPE> ext_make_table(const std::shared_ptr<mapper_base>& mapper, bool unit_energy = false) { 
+    if (!mapper) {
+        throw std::runtime_error("Mapper not set");
+    }
+
+    switch (mapper->get_order()) {
+        case qam_order::QPSK: {
+            auto typed = std::dynamic_pointer_cast<qam_mapper<DTYPE, qam_order::QPSK>>(mapper);
+            if (!typed) {
+                throw std::runtime_error("Failed to cast mapper to QPSK type");
+            }
+            return ext_make_table(*typed, unit_energy);
+        }
+        case qam_order::QAM16: {
+            auto typed = std::dynamic_pointer_cast<qam_mapper<DTYPE, qam_order::QAM16>>(mapper);
+            if (!typed) {
+                throw std::runtime_error("Failed to cast mapper to QAM16 type");
+            }
+            return ext_make_table(*typed, unit_energy);
+        }
+        case qam_order::QAM64: {
+            auto typed = std::dynamic_pointer_cast<qam_mapper<DTYPE, qam_order::QAM64>>(mapper);
+            if (!typed) {
+                throw std::runtime_error("Failed to cast mapper to QAM64 type");
+            }
+            return ext_make_table(*typed, unit_energy);
+        }
+        default:
+            throw std::invalid_argument("Unsupported modulation order");
+    }
+}
+
+/**
+ * @brief Creates the default Gray mapper of a modulation order
+ * @param order Modulation order
+ * @return Pointer to the mapper
+ */
+template<typename DTYPE>
+std::shared_ptr<mapper_base> ext_make_mapper(qam_order order) { 
+    switch (order) {
+        case qam_order::QPSK:   return qam_mapper<DTYPE, qam_order::QPSK>::make();
+        case qam_order::QAM16:  return qam_mapper<DTYPE, qam_order::QAM16>::make();
+        case qam_order::QAM64:  return qam_mapper<DTYPE, qam_order::QAM64>::make();
+        default:
+            throw std::invalid_argument("Unsupported modulation order");
+    }
+}
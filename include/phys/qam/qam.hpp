@@ -41,6 +41,12 @@ public:
      * @return Number of bits per symbol
      */
     virtual uint32_t get_bits_per_symbol() const = 0;
+
+    /**
+     * @brief Gets the average energy of the constellation points
+     * @return Mean of |point|^2 over the constellation
+     */
+    virtual double get_symbol_energy() const = 0;
 };
 
 /**
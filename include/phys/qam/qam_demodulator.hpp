@@ -1,10 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "phys/qam/qam.hpp"
 #include "phys/qam/mapper.hpp"
+#include "phys/qam/slicer.hpp"
 #include "phys/chan.hpp"
 #include "types/def.hpp"
 #include "types/complex.hpp"
@@ -40,10 +43,20 @@ public:
     
     /**
      * @brief Sets the mapper for demodulation
+     *        (the block API copies its constellation: set the mapper again after changing it)
      * @param mapper_ptr Pointer to mapper
      */
     void set_mapper(std::shared_ptr<mapper_base> mapper_ptr) override;
     
+    /**
+     * @brief Selects the unit average energy constellation for the block API
+     * @param unit_energy Slices against the mapper's unit-energy table instead of its raw points
+     */
+    void set_unit_energy(bool unit_energy) {
+        unit_energy_m = unit_energy;
+        update_table();
+    }
+    
     /**
      * @brief Starts the demodulation process
      */
@@ -67,6 +80,16 @@ public:
      * @return Bit sequence
      */
     std::vector<byte> demodulate(const complex<DTYPE>& symbols);
+
+    /**
+     * @brief Demodulates a symbol block into a preallocated bit buffer
+     *        (same decisions as demodulate(), through the slicer built by set_mapper();
+     *        rectangular constellations are sliced per axis, see qam_slicer)
+     * @param symbols Input IQ symbols
+     * @param count Number of symbols to demodulate
+     * @param bits Output bit buffer, bits past its end are dropped
+     */
+    void demodulate(const complex<DTYPE>& symbols, size_t count, std::span<byte> bits);
     
     /**
      * @brief Demodulates IQ symbols into a bit sequence using LLR
@@ -76,7 +99,21 @@ public:
      */
     std::vector<byte> demodulate_llr(const complex<DTYPE>& symbols, const channel<DTYPE>& channel);
 
+    /**
+     * @brief Demodulates IQ symbols into a bit sequence using LLR with a given noise level
+     *        (e.g. the block estimate of a noise_estimator on recorded captures)
+     * @param symbols Input IQ symbols
+     * @param sigma Noise standard deviation per component
+     * @return Bit sequence
+     */
+    std::vector<byte> demodulate_llr(const complex<DTYPE>& symbols, DTYPE sigma);
+
 private:
+    /**
+     * @brief Rebuilds the table and slicer of the block API from the mapper
+     */
+    void update_table();
+
     /**
      * @brief Writes a group of bits to a byte array
      * @param bits Array of bytes
@@ -143,6 +180,8 @@ private:
     DTYPE calculate_llr_qam64(const complex_t<DTYPE>& symbol, size_t bit_position, DTYPE sigma);
     
     std::shared_ptr<mapper_base> mapper_m;
+    bool unit_energy_m = false;
+    std::optional<qam_slicer<DTYPE>> slicer_m;  // Decisions of the block API
 };
 
 // i know...
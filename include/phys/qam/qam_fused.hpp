@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "phys/qam/qam.hpp"
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/slicer.hpp"
+#include "phys/chan.hpp"
+#include "types/def.hpp"
+#include "types/complex.hpp"
+
+/**
+ * @class qam_fused_kernel
+ * @brief Fused modulate -> AWGN -> slice -> error count kernel
+ *
+ * For BER measurements the modulated symbols, the noisy symbols and the
+ * demodulated bits are never needed: every symbol is mapped, noised, sliced
+ * and compared against its source bit group in registers. The channel is
+ * consumed in the same order as channel::transmit(), so for the same channel
+ * state the error count equals the one of the unfused chain.
+ * @tparam DTYPE Data type for components of complex number
+ * @tparam ORDER Modulation order
+ */
+template<typename DTYPE, qam_order ORDER>
+class qam_fused_kernel { 
+public:
+    static constexpr uint32_t BITS_PER_SYMBOL = ext_get_bits_per_symbol(ORDER);
+
+    /**
+     * @brief Builds the kernel for the current constellation of a mapper
+     * @param mapper Mapper
+     * @param unit_energy Transmit the unit average energy constellation; the
+     *        slicer thresholds are built on the scaled levels, so no symbol is rescaled
+     */
+    explicit qam_fused_kernel(const qam_mapper<DTYPE, ORDER>& mapper, bool unit_energy = false);
+
+    /**
+     * @brief Runs a bit block through the fused chain
+     * @param bits Source bits, must hold a whole number of symbols
+     * @param chan Channel adding the noise
+     * @param bit_errors Optional per-bit-position error counters
+     *        (BITS_PER_SYMBOL entries, [0] is the MSB of the symbol), accumulated
+     * @return Number of bit errors in the block
+     */
+    uint64_t run(std::span<const byte> bits, channel<DTYPE>& chan, std::span<uint64_t> bit_errors = {});
+
+private:
+    qam_table<DTYPE>    table_m;
+    qam_slicer<DTYPE>   slicer_m;
+};
+
+QAM_TEMPLATES(qam_fused_kernel, qam_order::QPSK)
+QAM_TEMPLATES(qam_fused_kernel, qam_order::QAM16)
+QAM_TEMPLATES(qam_fused_kernel, qam_order::QAM64)
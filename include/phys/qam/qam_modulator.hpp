@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "phys/qam/qam.hpp"
@@ -36,10 +37,20 @@ public:
     
     /**
      * @brief Sets the mapper for modulation
+     *        (the block API copies its constellation: set the mapper again after changing it)
      * @param mapper_ptr Pointer to the mapper
      */
     void set_mapper(std::shared_ptr<mapper_base> mapper_ptr) override;
     
+    /**
+     * @brief Selects the unit average energy constellation for the block API
+     * @param unit_energy Maps bits onto the mapper's unit-energy table instead of its raw points
+     */
+    void set_unit_energy(bool unit_energy) {
+        unit_energy_m = unit_energy;
+        update_table();
+    }
+    
     /**
      * @brief Starts the modulation process
      */
@@ -64,7 +75,21 @@ public:
      */
     complex<DTYPE> modulate(const std::vector<byte>& bits);
 
+    /**
+     * @brief Modulates a bit block into a preallocated container
+     *        (same symbols as modulate(), through the table built by set_mapper())
+     * @param bits Input bit block
+     * @param symbols Output container, must hold ceil(bits * 8 / bits_per_symbol) symbols
+     * @return Number of symbols written
+     */
+    size_t modulate(std::span<const byte> bits, complex<DTYPE>& symbols);
+
 private:
+    /**
+     * @brief Rebuilds the table of the block API from the mapper
+     */
+    void update_table();
+
     /**
      * @brief Extracts a group of bits from a byte array
      * @param bits Byte array
@@ -104,6 +129,8 @@ private:
     complex_t<DTYPE> map_qam64(uint32_t bits);
     
     std::shared_ptr<mapper_base> mapper_m;
+    bool unit_energy_m = false;
+    qam_table<DTYPE> table_m;           // Constellation of the block API
 };
 
 QAM_MODEM_TEMPLATES(qam_modulator)
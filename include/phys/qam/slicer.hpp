@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "types/def.hpp"
+#include "types/complex.hpp"
+#include "phys/qam/mapper.hpp"
+
+/**
+ * @class qam_slicer
+ * @brief Hard-decision slicer for a constellation table
+ *
+ * Rectangular constellations (every combination of I and Q levels present,
+ * which holds for all default Gray mappings) are sliced per axis against the
+ * midpoints between adjacent levels, i.e. the same nearest point as the full
+ * distance search at a fraction of the cost. Anything else falls back to the
+ * exhaustive nearest-point search.
+ * @tparam DTYPE Data type for components of complex number
+ */
+template<typename DTYPE>
+class qam_slicer { 
+public:
+    static constexpr size_t MAX_LEVELS = 8;     // levels per axis (QAM64)
+
+    /**
+     * @brief Builds the slicer for a constellation table
+     * @param table Constellation table
+     */
+    explicit qam_slicer(const qam_table<DTYPE>& table) 
+        : indices_m(table.indices), points_m(table.points) {
+        build_grid();
+    }
+
+    /**
+     * @brief Whether the per-axis threshold path is used
+     */
+    bool is_grid() const { 
+        return grid_m;
+    }
+
+    /**
+     * @brief Finds the index of the nearest constellation point
+     * @param i In-phase component
+     * @param q Quadrature component
+     * @return Symbol index
+     */
+    uint32_t slice(DTYPE i, DTYPE q) const { 
+        if (grid_m) {
+            uint32_t level_i = 0;
+            uint32_t level_q = 0;
+            for (size_t k = 0; k + 1 < levels_i_m; k++) {
+                level_i += i > thresholds_i_m[k];
+            }
+            for (size_t k = 0; k + 1 < levels_q_m; k++) {
+                level_q += q > thresholds_q_m[k];
+            }
+            return grid_index_m[level_i * levels_q_m + level_q];
+        }
+
+        uint32_t nearest_index = 0;
+        DTYPE min_distance = std::numeric_limits<DTYPE>::max();
+        for (size_t p = 0; p < points_m.size(); p++) {
+            DTYPE di = i - points_m[p].i;
+            DTYPE dq = q - points_m[p].q;
+            DTYPE distance = di * di + dq * dq;
+            if (distance < min_distance) {
+                min_distance = distance;
+                nearest_index = indices_m[p];
+            }
+        }
+        return nearest_index;
+    }
+
+private:
+    void build_grid() { 
+        std::vector<DTYPE> levels_i;
+        std::vector<DTYPE> levels_q;
+        for (const auto& point : points_m) {
+            levels_i.push_back(point.i);
+            levels_q.push_back(point.q);
+        }
+
+        auto unique_sorted = [](std::vector<DTYPE>& levels) {
+            std::sort(levels.begin(), levels.end());
+            levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+        };
+        unique_sorted(levels_i);
+        unique_sorted(levels_q);
+
+        if (levels_i.size() > MAX_LEVELS || levels_q.size() > MAX_LEVELS ||
+            levels_i.size() * levels_q.size() != points_m.size()) {
+            return;
+        }
+
+        levels_i_m = levels_i.size();
+        levels_q_m = levels_q.size();
+        grid_index_m.assign(levels_i_m * levels_q_m, std::numeric_limits<uint32_t>::max());
+
+        for (size_t p = 0; p < points_m.size(); p++) {
+            size_t li = std::lower_bound(levels_i.begin(), levels_i.end(), points_m[p].i) - levels_i.begin();
+            size_t lq = std::lower_bound(levels_q.begin(), levels_q.end(), points_m[p].q) - levels_q.begin();
+            uint32_t& cell = grid_index_m[li * levels_q_m + lq];
+            if (cell != std::numeric_limits<uint32_t>::max()) {
+                return; // duplicated point, not a grid
+            }
+            cell = indices_m[p];
+        }
+
+        for (size_t k = 0; k + 1 < levels_i_m; k++) {
+            thresholds_i_m[k] = (levels_i[k] + levels_i[k + 1]) / 2;
+        }
+        for (size_t k = 0; k + 1 < levels_q_m; k++) {
+            thresholds_q_m[k] = (levels_q[k] + levels_q[k + 1]) / 2;
+        }
+
+        grid_m = true;
+    }
+
+    bool                                grid_m = false;
+    size_t                              levels_i_m = 0;
+    size_t                              levels_q_m = 0;
+    std::array<DTYPE, MAX_LEVELS - 1>   thresholds_i_m{};
+    std::array<DTYPE, MAX_LEVELS - 1>   thresholds_q_m{};
+    std::vector<uint32_t>               grid_index_m;
+
+    // exhaustive fallback
+    std::vector<uint32_t>               indices_m;
+    std::vector<complex_t<DTYPE>>       points_m;
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "types/def.hpp"
+
+/**
+ * @enum prbs_type
+ * @brief ITU-T O.150 pseudo-random binary sequences
+ */
+enum class prbs_type { 
+    PRBS7   = 7,    //< x^7  + x^6  + 1
+    PRBS15  = 15,   //< x^15 + x^14 + 1
+    PRBS23  = 23,   //< x^23 + x^18 + 1
+    PRBS31  = 31,   //< x^31 + x^28 + 1
+};
+
+/**
+ * @interface i_bit_source
+ * @brief Source of payload bits
+ */
+class i_bit_source { 
+public:
+    virtual ~i_bit_source() = default;
+
+    /**
+     * @brief Fills a buffer with the next bits of the source (MSB first)
+     * @param bits Output buffer
+     */
+    virtual void fill(std::span<byte> bits) = 0;
+};
+
+/**
+ * @class random_bit_source
+ * @brief Uniform random bits from xoshiro256**, 64 bits per step
+ *
+ * Streams are seeded deterministically from (seed, stream) through
+ * splitmix64, so every thread or shard can own an independent,
+ * reproducible stream. Not thread safe: one instance per thread.
+ */
+class random_bit_source : public i_bit_source { 
+public:
+    using ptr           = std::unique_ptr<random_bit_source>;
+    using state_type    = std::array<uint64_t, 4>;
+
+    /**
+     * @brief Constructor
+     * @param seed Experiment seed
+     * @param stream Stream index (thread, modulation, shard, ...)
+     */
+    explicit random_bit_source(uint64_t seed, uint64_t stream = 0);
+
+    /**
+     * @brief Creates a random bit source
+     * @param seed Experiment seed
+     * @param stream Stream index
+     * @return Smart pointer to the source
+     */
+    static ptr make(uint64_t seed, uint64_t stream = 0);
+
+    /**
+     * @brief Gets the next 64 random bits
+     */
+    uint64_t next_word() { 
+        const uint64_t result = rotl(state_m[1] * 5, 7) * 9;
+        const uint64_t t = state_m[1] << 17;
+
+        state_m[2] ^= state_m[0];
+        state_m[3] ^= state_m[1];
+        state_m[1] ^= state_m[2];
+        state_m[0] ^= state_m[3];
+        state_m[2] ^= t;
+        state_m[3] = rotl(state_m[3], 45);
+
+        words_m++;
+        return result;
+    }
+
+    void fill(std::span<byte> bits) override;
+
+    /**
+     * @brief Gets the number of 64-bit words drawn so far
+     */
+    uint64_t get_position() const { 
+        return words_m;
+    }
+
+    /**
+     * @brief Gets the generator state (to checkpoint the stream)
+     */
+    const state_type& get_state() const { 
+        return state_m;
+    }
+
+    /**
+     * @brief Restores a generator state saved with get_state()
+     * @param state Generator state
+     * @param position Number of words drawn at that state
+     */
+    void set_state(const state_type& state, uint64_t position);
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { 
+        return (x << k) | (x >> (64 - k));
+    }
+
+    state_type  state_m;
+    uint64_t    words_m = 0;
+};
+
+/**
+ * @class gaussian_source
+ * @brief Standard normal samples from xoshiro256**, ziggurat method
+ *
+ * The fast path takes one 64-bit word per sample: 7 bits pick one of the
+ * 128 layers of the ziggurat, 53 bits the abscissa, and about 99% of the
+ * draws fall inside the layer's rectangle. Seeded from (seed, stream) like
+ * random_bit_source but on separate sequences, so the noise of a stream is
+ * independent of its payload and never repeats. Not thread safe.
+ */
+class gaussian_source { 
+public:
+    static constexpr size_t LAYERS = 128;
+
+    /**
+     * @brief Constructor
+     * @param seed Experiment seed
+     * @param stream Stream index (thread, modulation, shard item, ...)
+     */
+    explicit gaussian_source(uint64_t seed, uint64_t stream = 0);
+
+    /**
+     * @brief Gets the next N(0, 1) sample
+     */
+    double next() { 
+        while (true) {
+            const uint64_t word = words_m.next_word();
+            const size_t layer = word & (LAYERS - 1);
+            const double u = 2.0 * to_unit(word) - 1.0;
+            if (std::fabs(u) < ratio_m[layer]) {
+                return u * edge_m[layer];
+            }
+            double x = 0.0;
+            if (next_outside(layer, u, x)) {
+                return x;
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the uniform words behind the samples (to checkpoint the stream)
+     */
+    random_bit_source& get_bit_source() { 
+        return words_m;
+    }
+
+    const random_bit_source& get_bit_source() const { 
+        return words_m;
+    }
+
+private:
+    // top 53 bits as a double in [0, 1)
+    static double to_unit(uint64_t word) { 
+        return static_cast<double>(word >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @brief Tail or wedge of a layer, rejection sampled
+     * @return false if the draw was rejected
+     */
+    bool next_outside(size_t layer, double u, double& x);
+
+    static const std::array<double, LAYERS + 1>  edge_m;     // Right edge of every layer, edge_m[LAYERS] = 0
+    static const std::array<double, LAYERS>      ratio_m;    // edge_m[i + 1] / edge_m[i], the rectangle part
+
+    random_bit_source   words_m;
+};
+
+/**
+ * @class prbs_bit_source
+ * @brief PRBS-7/15/23/31 generator for conformance-style tests
+ *
+ * The LFSR recurrence b[t] = b[t - k] ^ b[t - n] of x^n + x^k + 1 lets the
+ * next k bits be computed with one shift and one XOR of the register, so
+ * the sequence is produced k bits at a time instead of bit by bit.
+ */
+class prbs_bit_source : public i_bit_source { 
+public:
+    using ptr = std::unique_ptr<prbs_bit_source>;
+
+    /**
+     * @brief Constructor
+     * @param type Sequence type
+     * @param seed Initial register (n low bits used, must not be zero)
+     */
+    explicit prbs_bit_source(prbs_type type, uint32_t seed = 0xFFFFFFFF);
+
+    /**
+     * @brief Creates a PRBS source
+     * @param type Sequence type
+     * @param seed Initial register
+     * @return Smart pointer to the source
+     */
+    static ptr make(prbs_type type, uint32_t seed = 0xFFFFFFFF);
+
+    /**
+     * @brief Gets the period of the sequence in bits (2^n - 1)
+     */
+    uint64_t get_period() const { 
+        return (uint64_t(1) << degree_m) - 1;
+    }
+
+    void fill(std::span<byte> bits) override;
+
+private:
+    uint32_t    degree_m;       // n
+    uint32_t    tap_m;          // k
+    uint64_t    register_m;     // last n bits, oldest in bit 0
+    uint64_t    pending_m = 0;  // generated bits not yet emitted, oldest in bit 0
+    uint32_t    pending_bits_m = 0;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "sim/bit_source.hpp"
+#include "sim/engine.hpp"
+#include "sim/point.hpp"
+
+/**
+ * @struct checkpoint_record
+ * @brief Sufficient statistics of one sweep point plus the payload and noise stream positions
+ */
+struct checkpoint_record {
+    ber_point                       point;          // Accumulated bits / errors / frames
+    random_bit_source::state_type   rng_state{};    // Payload generator state after the last frame
+    uint64_t                        rng_position = 0;
+    random_bit_source::state_type   noise_state{};  // Noise generator state after the last frame
+    uint64_t                        noise_position = 0;
+};
+
+/**
+ * @class sweep_checkpoint
+ * @brief Compact binary checkpoint of a BER sweep
+ *
+ * Keeps one record per sigma and rewrites the file (temporary file +
+ * rename, so a kill never leaves a torn checkpoint) when a point is
+ * completed or the save interval has elapsed. Counts of a point can be
+ * extended later by running more frames and merging. The file carries the
+ * hash of the settings it was written with (ext_checkpoint_hash()); a
+ * checkpoint of other settings is rejected instead of resumed.
+ *
+ * File layout (native endianness):
+ *      "YQCK" | u32 version | u64 config_hash | u64 count | count x record
+ *      record: f64 sigma | u64 bits | u64 errors | u64 frames | u64 rng_state[4] | u64 rng_position
+ *              | u64 noise_state[4] | u64 noise_position
+ */
+class sweep_checkpoint { 
+public:
+    static constexpr uint32_t VERSION = 3;
+
+    /**
+     * @brief Constructor
+     * @param filename Checkpoint file
+     * @param config_hash Settings of the sweep (see ext_checkpoint_hash())
+     * @param interval Minimal time between two saves of partial points
+     */
+    sweep_checkpoint(const std::string& filename, uint64_t config_hash,
+                     std::chrono::seconds interval = std::chrono::seconds(10));
+
+    /**
+     * @brief Loads the checkpoint file
+     * @return true if a checkpoint was loaded, false if the file does not exist
+     * @throws std::runtime_error on a corrupted or incompatible file, or one
+     *         written with other settings
+     */
+    bool load();
+
+    /**
+     * @brief Writes the checkpoint file
+     */
+    void save();
+
+    /**
+     * @brief Deletes the checkpoint file and the records (the sweep is saved)
+     */
+    void remove();
+
+    /**
+     * @brief Finds the record of a point
+     * @param sigma Point sigma
+     * @return Record if the point was (partially) simulated
+     */
+    std::optional<checkpoint_record> find(double sigma) const;
+
+    /**
+     * @brief Replaces the record of a point
+     * @param record New record
+     * @param completed Point is finished: save regardless of the interval
+     */
+    void update(const checkpoint_record& record, bool completed);
+
+    const std::map<double, checkpoint_record>& get_records() const { 
+        return records_m;
+    }
+
+private:
+    std::string                             filename_m;
+    uint64_t                                config_hash_m;
+    std::chrono::seconds                    interval_m;
+    std::chrono::steady_clock::time_point   last_save_m;
+    std::map<double, checkpoint_record>     records_m;
+};
+
+/**
+ * @brief Hashes the engine settings the counts of a checkpoint depend on
+ *
+ * Covers the modulation, the sample type, frame and tile sizes, the
+ * energy normalisation and the kernel path. The seed is left out: a point
+ * continues from the stream states saved in its record.
+ */
+template<typename DTYPE>
+uint64_t ext_checkpoint_hash(const sim_engine<DTYPE>& engine);
+
+/**
+ * @brief Simulates a sweep point through a checkpoint
+ *
+ * A completed point is returned from the checkpoint, a partial one (or one
+ * with fewer frames than requested) continues from its saved counts and
+ * payload and noise stream positions, so it ends with the counts of an
+ * uninterrupted run. Progress is recorded every frames_per_save frames.
+ * @param engine Simulation engine
+ * @param checkpoint Checkpoint of the sweep
+ * @param sigma Point sigma
+ * @param frames Requested total number of frames
+ * @param frames_per_save Frames simulated between two checkpoint updates
+ * @return Accumulated point
+ */
+template<typename DTYPE>
+ber_point resume_point(sim_engine<DTYPE>& engine, sweep_checkpoint& checkpoint, 
+                       double sigma, uint64_t frames, uint64_t frames_per_save);
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "phys/chan.hpp"
+#include "phys/qam/qam.hpp"
+#include "phys/qam/qam_demodulator.hpp"
+#include "phys/qam/qam_fused.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "sim/bit_source.hpp"
+#include "sim/error_stats.hpp"
+#include "sim/evm.hpp"
+#include "sim/point.hpp"
+#include "sim/profile.hpp"
+#include "types/complex.hpp"
+#include "types/def.hpp"
+
+/**
+ * @struct engine_config
+ * @brief Parameters of the batched simulation engine
+ */
+struct engine_config {
+    size_t   frame_bytes    = 128 * 1024;   // Payload of one Monte-Carlo frame (~1 Mbit)
+    size_t   tile_bytes     = 1536;         // Bytes pushed through all stages at once (kept in L1/L2)
+    bool     fused          = true;         // Use qam_fused_kernel instead of the staged chain
+    uint64_t seed           = 0;            // Payload and noise seed, 0 picks a random one
+    uint64_t stream         = 0;            // Payload and noise stream index (one per thread / modulation)
+    bool     unit_energy    = false;        // Transmit unit average energy constellations (Es = 1)
+    bool     measure_quality = false;       // Data-aided EVM / MER / SNR of the received symbols (staged chain only)
+};
+
+/**
+ * @class sim_engine
+ * @brief Batched Monte-Carlo engine: bits -> modulate -> channel -> demodulate -> count
+ *
+ * Every frame is cut into tiles which go through all stages before the
+ * next tile is generated, so a tile stays cache resident for the whole chain.
+ * Frames and tiles are rounded down to multiples of 3 bytes, i.e. whole
+ * symbols for every QAM order, so tiling does not change the symbols seen
+ * by the channel and no frame ends with a zero-padded symbol. In fused mode
+ * a tile is handled by qam_fused_kernel and no intermediate buffer exists;
+ * it counts bit and per-position errors only.
+ * @tparam DTYPE Data type for components of complex number
+ */
+template<typename DTYPE>
+class sim_engine { 
+public:
+    using ptr           = std::unique_ptr<sim_engine>;
+    using bit_generator = std::function<void(std::span<byte>)>;
+    using fused_kernel  = std::function<uint64_t(std::span<const byte>, channel<DTYPE>&, std::span<uint64_t>)>;
+
+    /**
+     * @brief Constructor
+     * @param mapper Mapper shared by the modulator and the demodulator
+     * @param cfg Frame and tile sizes
+     */
+    explicit sim_engine(std::shared_ptr<mapper_base> mapper, const engine_config& cfg = engine_config());
+
+    /**
+     * @brief Creates an engine instance
+     * @param mapper Mapper shared by the modulator and the demodulator
+     * @param cfg Frame and tile sizes
+     * @return Smart pointer to the engine
+     */
+    static ptr make(std::shared_ptr<mapper_base> mapper, const engine_config& cfg = engine_config());
+
+    // the default bit generator refers to this engine
+    sim_engine(const sim_engine&) = delete;
+    sim_engine& operator=(const sim_engine&) = delete;
+
+    /**
+     * @brief Replaces the source of payload bits
+     * @param generator Callback filling a tile with payload bits
+     */
+    void set_bit_generator(bit_generator generator);
+
+    /**
+     * @brief Gets the default payload source (seeded from engine_config::seed / stream)
+     */
+    random_bit_source& get_bit_source() { 
+        return source_m;
+    }
+
+    /**
+     * @brief Gets the channel noise source (seeded from engine_config::seed / stream)
+     */
+    gaussian_source& get_noise_source() { 
+        return channel_m.get_noise_source();
+    }
+
+    /**
+     * @brief Restarts the payload and the noise at another stream
+     * @param seed Experiment seed
+     * @param stream Stream index (e.g. a work item)
+     */
+    void reseed(uint64_t seed, uint64_t stream);
+
+    /**
+     * @brief Gets the error statistics of all run() calls since the last reset_stats()
+     * @note SER and burst statistics are collected by the staged chain only
+     *       (engine_config::fused = false), the fused kernel leaves symbols at 0
+     */
+    const error_stats& get_error_stats() const { 
+        return counter_m.get_stats();
+    }
+
+    /**
+     * @brief Gets the modulation quality of all run() calls since the last reset_stats()
+     * @note Measured against the transmitted points by the staged chain with
+     *       engine_config::measure_quality only, empty otherwise
+     */
+    evm_stats get_quality() const { 
+        return meter_m ? meter_m->get_stats() : evm_stats();
+    }
+
+    /**
+     * @brief Clears the error statistics and the modulation quality
+     *        (a point simulated in chunks is reset once, before its first chunk)
+     */
+    void reset_stats();
+
+    /**
+     * @brief Gets the effective configuration (tile size aligned to whole symbols, seed drawn if 0)
+     */
+    const engine_config& get_config() const { 
+        return cfg_m;
+    }
+
+    /**
+     * @brief Gets the average energy of the transmitted symbols
+     * @return 1 with engine_config::unit_energy, the mapper's energy otherwise
+     */
+    double get_symbol_energy() const { 
+        return symbol_energy_m;
+    }
+
+    /**
+     * @brief Gets the bits per symbol of the simulated modulation
+     */
+    uint32_t get_bits_per_symbol() const { 
+        return counter_m.get_bits_per_symbol();
+    }
+
+    /**
+     * @brief Gets throughput and stage times accumulated since the last reset_profile()
+     * @note The per-stage split is recorded only when built with SIM_STAGE_TIMING
+     */
+    const stage_profile& get_profile() const { 
+        return profile_m;
+    }
+
+    /**
+     * @brief Clears the accumulated profile
+     */
+    void reset_profile() { 
+        profile_m.reset();
+    }
+
+    /**
+     * @brief Simulates a number of frames at the given noise level
+     * @param sigma Standard deviation of noise
+     * @param frames Number of frames
+     * @return Accumulated bits and errors
+     */
+    ber_point run(double sigma, size_t frames);
+
+private:
+    /**
+     * @brief Pushes one tile through all stages
+     * @param tile_bytes Payload bytes of the tile
+     * @return Number of bit errors in the tile
+     */
+    uint64_t run_tile(size_t tile_bytes);
+
+    engine_config                       cfg_m;
+    double                              symbol_energy_m = 1.0;
+    qam_modulator<DTYPE>                modulator_m;
+    qam_demodulator<DTYPE>              demodulator_m;
+    channel<DTYPE>                      channel_m;
+    error_counter                       counter_m;
+    random_bit_source                   source_m;
+    bit_generator                       generator_m;
+    fused_kernel                        fused_m;
+    stage_profile                       profile_m;
+    std::unique_ptr<evm_meter<DTYPE>>   meter_m;
+
+    std::vector<byte>                   tx_bits_m;
+    std::vector<byte>                   rx_bits_m;      // Staged chain only
+    complex<DTYPE>                      symbols_m;
+};
+
+SIM_TEMPLATES(sim_engine)
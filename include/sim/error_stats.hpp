@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "types/def.hpp"
+
+/**
+ * @struct error_stats
+ * @brief Bit, symbol and burst error statistics (mergeable across threads)
+ */
+struct error_stats {
+    static constexpr size_t MAX_BITS_PER_SYMBOL = 6;
+    static constexpr size_t BURST_BUCKETS       = 16;
+
+    uint64_t bits           = 0;    // Compared bits
+    uint64_t errors         = 0;    // Bit errors
+    uint64_t symbols        = 0;    // Compared symbols (0 if only bits were counted, see error_counter::add_counts)
+    uint64_t symbol_errors  = 0;    // Symbols with at least one bit error
+    uint64_t bursts         = 0;    // Runs of consecutive bit errors
+    uint64_t max_burst      = 0;    // Longest run of consecutive bit errors
+
+    // errors per bit position within the symbol, [0] is the MSB
+    std::array<uint64_t, MAX_BITS_PER_SYMBOL> bit_position_errors{};
+
+    // [n] counts bursts of n + 1 bits, the last bucket everything longer
+    std::array<uint64_t, BURST_BUCKETS> burst_histogram{};
+
+    double ber() const { 
+        return bits ? static_cast<double>(errors) / static_cast<double>(bits) : 0.0;
+    }
+
+    double ser() const { 
+        return symbols ? static_cast<double>(symbol_errors) / static_cast<double>(symbols) : 0.0;
+    }
+
+    double mean_burst() const { 
+        return bursts ? static_cast<double>(errors) / static_cast<double>(bursts) : 0.0;
+    }
+
+    /**
+     * @brief Adds the counts of another statistics object
+     * @param other Statistics to add
+     */
+    void merge(const error_stats& other);
+};
+
+/**
+ * @class error_counter
+ * @brief One-pass error statistics over transmitted / received bit streams
+ *
+ * The streams are compared 48 bits at a time (a whole number of symbols for
+ * 1, 2, 3, 4 and 6 bits per symbol): one XOR and popcounts against precomputed
+ * position masks give the bit, per-position and symbol errors of the chunk,
+ * burst lengths are walked only for chunks that contain errors. Bursts
+ * continue across accumulate() calls until flush().
+ */
+class error_counter { 
+public:
+    /**
+     * @brief Constructor
+     * @param bits_per_symbol Bits per symbol of the modulation (1, 2, 3, 4 or 6)
+     * @throws std::invalid_argument for other values
+     */
+    explicit error_counter(uint32_t bits_per_symbol);
+
+    /**
+     * @brief Compares the next block of the streams
+     * @param tx Transmitted bits (MSB first)
+     * @param rx Received bits, same size as tx
+     * @note The block must hold a whole number of symbols
+     */
+    void accumulate(std::span<const byte> tx, std::span<const byte> rx);
+
+    /**
+     * @brief Adds the counts of a block compared elsewhere (e.g. by qam_fused_kernel)
+     * @param bits Compared bits
+     * @param position_errors Errors per bit position, bits_per_symbol entries
+     * @note Symbol and burst statistics need the decisions and are not updated
+     */
+    void add_counts(uint64_t bits, std::span<const uint64_t> position_errors);
+
+    /**
+     * @brief Closes a burst left open at the end of the last block
+     */
+    void flush();
+
+    /**
+     * @brief Clears the statistics
+     */
+    void reset();
+
+    const error_stats& get_stats() const { 
+        return stats_m;
+    }
+
+    uint32_t get_bits_per_symbol() const { 
+        return bits_per_symbol_m;
+    }
+
+private:
+    static constexpr uint32_t CHUNK_BITS = 48;
+
+    void accumulate_chunk(uint64_t diff, uint32_t chunk_bits);
+    void close_burst();
+
+    uint32_t                                            bits_per_symbol_m;
+    std::array<uint64_t, error_stats::MAX_BITS_PER_SYMBOL> position_masks_m{};
+    uint64_t                                            symbol_start_mask_m = 0;
+
+    uint64_t                                            open_burst_m = 0;
+    error_stats                                         stats_m;
+};
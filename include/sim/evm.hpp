@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/slicer.hpp"
+#include "types/complex.hpp"
+#include "types/def.hpp"
+
+/**
+ * @struct evm_point_stats
+ * @brief Received symbols attributed to one constellation point
+ */
+struct evm_point_stats {
+    uint64_t    count       = 0;
+    double      sum_i       = 0.0;  // Sum of received I
+    double      sum_q       = 0.0;  // Sum of received Q
+    double      sum_power   = 0.0;  // Sum of |received|^2
+
+    /**
+     * @brief Gets the mean received point
+     */
+    complex_t<double> centroid() const;
+
+    /**
+     * @brief Gets the RMS distance of the received symbols from their centroid
+     */
+    double spread() const;
+};
+
+/**
+ * @struct evm_stats
+ * @brief Modulation quality of a symbol stream (mergeable across threads)
+ */
+struct evm_stats {
+    uint64_t                        symbols         = 0;
+    double                          error_power     = 0.0;  // Sum of |received - reference|^2
+    double                          reference_power = 0.0;  // Sum of |reference|^2
+    double                          peak_error_power = 0.0; // Largest |received - reference|^2
+    std::vector<evm_point_stats>    points;                 // Per symbol index of the constellation
+
+    /**
+     * @brief Gets the RMS EVM normalised to the mean reference power (0.1 = 10 %)
+     */
+    double rms_evm() const;
+
+    /**
+     * @brief Gets the peak EVM normalised to the mean reference power
+     */
+    double peak_evm() const;
+
+    /**
+     * @brief Gets the modulation error ratio in dB
+     */
+    double mer_db() const;
+
+    /**
+     * @brief Estimates the SNR in dB from the point clusters
+     *
+     * Signal is the power of the centroids, noise the spread around them,
+     * so a constant offset or gain error shows up in MER but not here.
+     */
+    double snr_db() const;
+
+    /**
+     * @brief Adds the counts of another statistics object
+     * @throws std::invalid_argument on a different constellation size
+     */
+    void merge(const evm_stats& other);
+
+    /**
+     * @brief Formats EVM, MER and SNR on one line
+     */
+    std::string report() const;
+};
+
+/**
+ * @class evm_meter
+ * @brief Streaming EVM / MER / SNR measurement against a constellation
+ *
+ * Every received symbol is compared once against its reference point:
+ * the transmitted point if it is known (data-aided) or the nearest point
+ * otherwise (decision-directed, see qam_slicer). Only sums are kept, so
+ * memory does not grow with the stream. Decision-directed results are
+ * optimistic once symbols start crossing decision boundaries.
+ * @tparam DTYPE Data type for components of complex number
+ */
+template<typename DTYPE>
+class evm_meter {
+public:
+    /**
+     * @brief Constructor
+     * @param mapper Mapper of the measured modulation
+     * @param unit_energy Compare against the unit-energy constellation
+     */
+    explicit evm_meter(std::shared_ptr<mapper_base> mapper, bool unit_energy = false);
+
+    /**
+     * @brief Measures against the nearest constellation points
+     * @param rx Received symbols
+     * @param count Number of symbols
+     */
+    void accumulate(const complex<DTYPE>& rx, size_t count);
+
+    /**
+     * @brief Measures against known reference symbols
+     * @param rx Received symbols
+     * @param ref Transmitted constellation points
+     * @param count Number of symbols
+     */
+    void accumulate(const complex<DTYPE>& rx, const complex<DTYPE>& ref, size_t count);
+
+    /**
+     * @brief Measures against the points of the transmitted bits
+     * @param rx Received symbols
+     * @param count Number of symbols
+     * @param bits Transmitted bits (MSB first), at least count symbols
+     */
+    void accumulate(const complex<DTYPE>& rx, size_t count, std::span<const byte> bits);
+
+    const evm_stats& get_stats() const {
+        return stats_m;
+    }
+
+    void reset();
+
+private:
+    void add(DTYPE i, DTYPE q, uint32_t index);
+
+    qam_table<DTYPE>    table_m;
+    qam_slicer<DTYPE>   slicer_m;
+    uint32_t            bits_per_symbol_m;
+    evm_stats           stats_m;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief FNV-1a offset basis, the initial value of a hash
+ */
+constexpr uint64_t FNV1A_BASIS = 0xCBF29CE484222325ULL;
+
+/**
+ * @brief Adds raw bytes to a FNV-1a hash
+ * @param hash Current hash
+ * @param data Bytes to add
+ * @param length Number of bytes
+ * @return Updated hash
+ */
+inline uint64_t fnv1a(uint64_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Adds the object representation of a value to a FNV-1a hash
+ * @param hash Current hash
+ * @param value Trivially copyable value
+ * @return Updated hash
+ */
+template<typename T>
+uint64_t fnv1a(uint64_t hash, const T& value) {
+    return fnv1a(hash, &value, sizeof(value));
+}
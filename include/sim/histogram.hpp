@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "file/iq_file.hpp"
+#include "types/complex.hpp"
+
+/**
+ * @struct histogram_config
+ * @brief Grid of an iq_histogram
+ */
+struct histogram_config {
+    size_t  bins    = 256;  // Bins per axis
+    double  limit   = 8.0;  // Both axes cover [-limit, limit), the range of the constellation plots
+};
+
+/**
+ * @class iq_histogram
+ * @brief Streaming 2D histogram of received I/Q symbols
+ *
+ * Memory is O(bins^2) whatever the number of symbols. accumulate() bins a
+ * tile in two passes: a branch-free loop computes the bin of every symbol
+ * (vectorised by the compiler, out-of-range and NaN symbols go to an
+ * overflow bin), then the counts are incremented. Threads fill their own
+ * histograms and merge() them at the end.
+ */
+class iq_histogram {
+public:
+    explicit iq_histogram(const histogram_config& cfg = histogram_config());
+
+    /**
+     * @brief Bins symbols given as planar components
+     * @param i In-phase components
+     * @param q Quadrature components, same size as i
+     */
+    template<typename DTYPE>
+    void accumulate(std::span<const DTYPE> i, std::span<const DTYPE> q);
+
+    /**
+     * @brief Bins the first count symbols of a container
+     */
+    template<typename DTYPE>
+    void accumulate(const complex<DTYPE>& symbols, size_t count);
+
+    /**
+     * @brief Adds the counts of a histogram with the same grid
+     * @throws std::invalid_argument on another grid
+     */
+    void merge(const iq_histogram& other);
+
+    void reset();
+
+    /**
+     * @brief Gets the count of a bin, x along I, y along Q, (0, 0) at (-limit, -limit)
+     */
+    uint64_t at(size_t x, size_t y) const {
+        return counts_m[y * cfg_m.bins + x];
+    }
+
+    /**
+     * @brief Gets the number of binned symbols, including those outside the grid
+     */
+    uint64_t total() const {
+        return total_m;
+    }
+
+    /**
+     * @brief Gets the number of symbols outside the grid (or NaN)
+     */
+    uint64_t outside() const {
+        return counts_m.back();
+    }
+
+    const histogram_config& get_config() const {
+        return cfg_m;
+    }
+
+    /**
+     * @brief Gets the centre of a bin along either axis
+     */
+    double bin_center(size_t index) const;
+
+    /**
+     * @brief Writes the counts as a gnuplot binary matrix (float32, bin centres in the first row and column)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save_matrix(const std::string& filename) const;
+
+    /**
+     * @brief Writes a log-scaled 8-bit heat map as a PGM image, +Q at the top
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save_pgm(const std::string& filename) const;
+
+    /**
+     * @brief Writes <base>.bin, <base>.pgm and a <base>.plt script drawing the heat map
+     * @return true if all files were written
+     */
+    bool save_and_plot(const std::string& base_filename, const std::string& title) const;
+
+private:
+    histogram_config        cfg_m;
+    std::vector<uint64_t>   counts_m;   // bins^2 grid, then the overflow bin
+    uint64_t                total_m = 0;
+};
+
+/**
+ * @brief Builds the histogram of a capture on several threads
+ *
+ * Every thread bins whole blocks of the mapping into its own histogram;
+ * the histograms are merged when all blocks are done.
+ * @param reader Mapped capture
+ * @param cfg Grid
+ * @param threads Worker threads, 0 = hardware concurrency
+ */
+template<typename DTYPE>
+iq_histogram ext_histogram_capture(const iq_reader<DTYPE>& reader, const histogram_config& cfg = histogram_config(),
+                                   size_t threads = 0);
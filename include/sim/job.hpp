@@ -0,0 +1,243 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "phys/qam/qam.hpp"
+#include "sim/engine.hpp"
+#include "sim/error_stats.hpp"
+#include "sim/point.hpp"
+#include "sim/result_cache.hpp"
+
+/**
+ * @enum sweep_axis
+ * @brief Quantity the sweep grid is defined on
+ */
+enum class sweep_axis {
+    SIGMA   = 0,    //< Noise standard deviation per component
+    EBN0_DB = 1,    //< Eb/N0 in dB on unit-energy constellations
+    ESN0_DB = 2,    //< Es/N0 in dB on unit-energy constellations
+};
+
+/**
+ * @enum sample_type
+ * @brief Component type of the simulated symbols
+ */
+enum class sample_type {
+    FLOAT   = 0,
+    DOUBLE  = 1,
+};
+
+/**
+ * @struct sweep_job
+ * @brief One BER sweep of a job specification
+ */
+struct sweep_job {
+    std::string     name;                                   // Job name (for logs)
+    qam_order       modulation      = qam_order::QPSK;      // Simulated modulation
+    sample_type     dtype           = sample_type::FLOAT;   // Symbol component type
+    sweep_axis      axis            = sweep_axis::SIGMA;    // Grid quantity
+    double          grid_start      = 0.0;                  // First grid value
+    double          grid_end        = 10.0;                 // Last grid value (inclusive)
+    double          grid_step       = 0.05;                 // Step of the fixed grid
+    bool            adaptive        = false;                // Refine the grid with adaptive_sweep (sigma only)
+    size_t          coarse_points   = 21;                   // adaptive_sweep::config::coarse_points
+    size_t          point_budget    = 64;                   // adaptive_sweep::config::point_budget
+    double          min_step        = 0.01;                 // adaptive_sweep::config::min_step
+    double          tolerance       = 0.05;                 // adaptive_sweep::config::tolerance
+    uint64_t        frames          = 50;                   // Frame budget per point
+    uint64_t        min_frames      = 1;                    // Frames simulated before the error target may stop a point
+    uint64_t        target_errors   = 0;                    // Stop a point after this many errors (0 = run the budget)
+    uint64_t        chunk_frames    = 10;                   // Frames between two checks of the stopping rule
+    bool            plan_frames     = false;                // Budget each point from the analytic BER (needs target_errors)
+    double          flag_sigma      = 5.0;                  // Flag points this many std. deviations off theory (0 = off)
+    engine_config   engine;                                 // Frame / tile sizes, kernel and seed
+    std::string     output;                                 // CSV file of the results
+
+    /**
+     * @brief Gets the values of the fixed grid
+     * @return grid_start, grid_start + grid_step, ... up to grid_end
+     */
+    std::vector<double> grid() const;
+
+    /**
+     * @brief Gets the result cache key of a point of this job
+     *
+     * Hashes what changes the statistics of the point: modulation, dtype,
+     * constellation energy, sigma, frame length and seed. Budgets, stopping
+     * rules, tiling and the kernel choice are not part of the key.
+     * @param sigma Channel sigma of the point
+     * @return Configuration hash
+     */
+    uint64_t point_key(double sigma) const;
+};
+
+/**
+ * @struct job_batch
+ * @brief Parsed job specification
+ */
+struct job_batch {
+    size_t                  threads = 1;    // Worker threads of the batch runner
+    std::string             cache;          // Result cache file (empty = no cache)
+    std::vector<sweep_job>  jobs;           // Jobs in file order
+};
+
+/**
+ * @struct job_result
+ * @brief Points of one finished job
+ */
+struct job_result {
+    sweep_job               job;
+    std::vector<double>     axis;       // Grid values on job.axis, parallel to points
+    std::vector<ber_point>  points;     // Simulated points (point.sigma is the channel sigma)
+    std::vector<error_stats> stats;     // Error statistics of the frames run by this batch, parallel to points
+    uint64_t                simulated_frames = 0;   // Frames run by this batch (the rest came from the cache)
+    std::vector<double>     theory_ber;             // Exact AWGN BER of each point (see constellation_theory)
+    std::vector<double>     deviation;              // Binomial deviation of each point from theory_ber
+    uint64_t                flagged = 0;            // Points with |deviation| > job.flag_sigma
+};
+
+/**
+ * @brief Parses a job specification
+ *
+ * The specification is a list of `key = value` lines. Keys before the first
+ * `[job]` section set batch options (`threads`) and defaults for every job;
+ * each `[job]` section starts a job. `modulation` and `dtype` take comma
+ * separated lists, a section expands into one job per combination and
+ * `{modulation}` / `{dtype}` in `output` are replaced accordingly. Grids
+ * are given as `sigma = start:end:step`, `ebn0_db = start:end:step` or
+ * `esn0_db = start:end:step`; Eb/N0 and Es/N0 grids always run on unit
+ * average energy constellations (`unit_energy = true`).
+ * `cache = file` enables the result cache for the batch. `#` starts a comment.
+ * @param in Stream with the specification
+ * @return Batch options and jobs
+ * @throws std::invalid_argument with the line number on malformed input
+ */
+job_batch parse_job_spec(std::istream& in);
+
+/**
+ * @brief Loads a job specification file
+ * @param filename Path to the file
+ * @return Batch options and jobs
+ */
+job_batch load_job_spec(const std::string& filename);
+
+/**
+ * @brief Writes the points of a job to its CSV output
+ * @param result Finished job
+ */
+void save_job_result(const job_result& result);
+
+/**
+ * @class batch_runner
+ * @brief Runs many sweep jobs on one warm thread pool
+ *
+ * Fixed-grid jobs are split into one task per point, adaptive jobs run as a
+ * single task. Mappers are shared by all workers, every worker keeps its
+ * engines (constellation tables and tile buffers) across tasks and jobs,
+ * so consecutive jobs of a batch only pay for the simulation.
+ * With a result cache, points are taken from the cache when they already
+ * satisfy the job budget; under-sampled points are topped up with the
+ * missing frames and stored back. Every top-up segment draws its payload
+ * and noise from its own stream (point key + frames already simulated).
+ * Every point is compared against the exact AWGN BER of the transmitted
+ * constellation; with plan_frames the same reference sizes its frame budget.
+ */
+class batch_runner {
+public:
+    using ptr = std::unique_ptr<batch_runner>;
+
+    /**
+     * @brief Constructor, starts the workers
+     * @param threads Number of worker threads (>= 1)
+     */
+    explicit batch_runner(size_t threads);
+
+    /**
+     * @brief Creates a batch runner instance
+     * @param threads Number of worker threads (>= 1)
+     * @return Smart pointer to the runner
+     */
+    static ptr make(size_t threads);
+
+    /**
+     * @brief Destructor, stops and joins the workers
+     */
+    ~batch_runner();
+
+    batch_runner(const batch_runner&) = delete;
+    batch_runner& operator=(const batch_runner&) = delete;
+
+    /**
+     * @brief Runs jobs and waits for all of them
+     * @param jobs Jobs to run
+     * @return One result per job, in input order
+     * @throws The first exception raised by a task
+     */
+    std::vector<job_result> run(const std::vector<sweep_job>& jobs);
+
+    /**
+     * @brief Sets the result cache used by the next runs
+     * @param cache Cache, nullptr to disable (not owned)
+     */
+    void set_cache(result_cache* cache) {
+        cache_m = cache;
+    }
+
+    /**
+     * @brief Gets the number of worker threads
+     */
+    size_t get_thread_count() const {
+        return workers_m.size();
+    }
+
+    /**
+     * @brief Gets the number of engines created so far (all workers, callable during a batch)
+     */
+    size_t get_engine_count() const;
+
+private:
+    struct worker_cache;
+    using task = std::function<void(worker_cache&)>;
+
+    /**
+     * @brief Main loop of a worker thread
+     * @param cache Engines owned by the worker
+     */
+    void worker_loop(worker_cache& cache);
+
+    /**
+     * @brief Queues a task
+     */
+    void submit(task t);
+
+    /**
+     * @brief Gets the shared mapper of a modulation and sample type
+     */
+    std::shared_ptr<mapper_base> get_mapper(qam_order order, sample_type dtype);
+
+    std::vector<std::thread>                    workers_m;
+    std::vector<std::unique_ptr<worker_cache>>  caches_m;
+
+    std::deque<task>                            queue_m;
+    mutable std::mutex                          mutex_m;
+    std::condition_variable                     work_cv_m;
+    std::condition_variable                     idle_cv_m;
+    size_t                                      busy_m = 0;
+    bool                                        stop_m = false;
+    std::exception_ptr                          error_m;
+    result_cache*                               cache_m = nullptr;
+
+    std::map<std::pair<qam_order, sample_type>, std::shared_ptr<mapper_base>> mappers_m;
+};
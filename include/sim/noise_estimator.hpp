@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/slicer.hpp"
+#include "types/complex.hpp"
+#include "types/def.hpp"
+
+/**
+ * @enum noise_method
+ * @brief Blind noise estimators of noise_estimator
+ */
+enum class noise_method {
+    DECISION,   //< Error to the nearest constellation point, biased low once symbols cross decision boundaries
+    M2M4,       //< Second and fourth moments of the received power, no decisions; best at low SNR
+};
+
+/**
+ * @struct noise_estimate
+ * @brief Signal and noise power estimated from received symbols
+ */
+struct noise_estimate {
+    uint64_t    symbols         = 0;
+    double      signal_power    = 0.0;  // Es
+    double      noise_power     = 0.0;  // N0 = 2 * sigma^2
+
+    /**
+     * @brief Gets the per-component noise sigma (the convention of channel::set_sigma)
+     */
+    double sigma() const;
+
+    /**
+     * @brief Gets Es/N0 in dB
+     */
+    double esn0_db() const;
+};
+
+/**
+ * @class noise_estimator
+ * @brief Streaming blind noise-variance estimator
+ *
+ * estimate() returns the estimate of one block and adds the block to the
+ * running totals, so the same pass gives a per-block sigma for the LLR
+ * demodulator and the estimate of the whole stream. M2M4 solves
+ *     M2 = S + N,  M4 = ka * S^2 + 4 * S * N + 2 * N^2
+ * for S and N, ka being the kurtosis of the constellation and 2 that of
+ * complex Gaussian noise; it costs two running sums per symbol. Without
+ * decisions it is unbiased at low SNR, where DECISION underestimates the
+ * noise, but at high SNR on constellations with several rings the noise is
+ * a small difference of large moments and DECISION is the better choice.
+ * @tparam DTYPE Data type for components of complex number
+ */
+template<typename DTYPE>
+class noise_estimator {
+public:
+    /**
+     * @brief Constructor
+     * @param mapper Mapper of the received modulation
+     * @param method Estimator
+     * @param unit_energy Received symbols use the unit-energy constellation
+     */
+    explicit noise_estimator(std::shared_ptr<mapper_base> mapper, noise_method method = noise_method::M2M4,
+                             bool unit_energy = false);
+
+    /**
+     * @brief Estimates the noise of a block and adds it to the totals
+     * @param symbols Received symbols
+     * @param count Number of symbols
+     * @return Estimate of this block only
+     */
+    noise_estimate estimate(const complex<DTYPE>& symbols, size_t count);
+
+    /**
+     * @brief Gets the estimate of all blocks since the last reset()
+     */
+    noise_estimate get_total() const {
+        return solve(total_m);
+    }
+
+    /**
+     * @brief Adds the totals of another estimator of the same modulation and method
+     */
+    void merge(const noise_estimator& other);
+
+    void reset() {
+        total_m = moments();
+    }
+
+    noise_method get_method() const {
+        return method_m;
+    }
+
+private:
+    struct moments {
+        uint64_t    symbols     = 0;
+        double      power       = 0.0;  // Sum of |r|^2
+        double      power_sq    = 0.0;  // Sum of |r|^4 (M2M4)
+        double      reference   = 0.0;  // Sum of |decision|^2 (DECISION)
+        double      error       = 0.0;  // Sum of |r - decision|^2 (DECISION)
+    };
+
+    noise_estimate solve(const moments& m) const;
+
+    qam_table<DTYPE>    table_m;
+    qam_slicer<DTYPE>   slicer_m;
+    noise_method        method_m;
+    double              kurtosis_m = 1.0;   // E|s|^4 / (E|s|^2)^2 of the constellation
+    moments             total_m;
+};
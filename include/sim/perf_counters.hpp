@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @enum perf_event_kind
+ * @brief Hardware events read by perf_counters
+ */
+enum class perf_event_kind : size_t {
+    CYCLES          = 0,    //< CPU cycles
+    INSTRUCTIONS    = 1,    //< Retired instructions
+    BRANCH_MISSES   = 2,    //< Mispredicted branches
+    L1D_MISSES      = 3,    //< L1 data cache read misses
+    LLC_MISSES      = 4,    //< Last level cache read misses
+};
+
+constexpr size_t PERF_EVENT_COUNT = 5;
+
+/**
+ * @struct perf_sample
+ * @brief Event counts of a measured region (scaled if the kernel multiplexed them)
+ */
+struct perf_sample {
+    std::array<uint64_t, PERF_EVENT_COUNT>  values{};   // Event counts
+    std::array<bool, PERF_EVENT_COUNT>      valid{};    // Event could be read
+    uint64_t                                regions = 0;  // Measured regions merged into the sample
+
+    /**
+     * @brief Checks whether an event was counted
+     */
+    bool has(perf_event_kind kind) const {
+        return valid[static_cast<size_t>(kind)];
+    }
+
+    /**
+     * @brief Gets the count of an event
+     */
+    uint64_t get(perf_event_kind kind) const {
+        return values[static_cast<size_t>(kind)];
+    }
+
+    /**
+     * @brief Adds the counts of another sample (an event stays valid if it is valid in all regions)
+     */
+    void merge(const perf_sample& other);
+
+    /**
+     * @brief Instructions per cycle, 0 if either event is missing
+     */
+    double ipc() const;
+
+    /**
+     * @brief Count of an event per unit of work (e.g. per symbol), 0 if missing
+     */
+    double per_unit(perf_event_kind kind, uint64_t units) const;
+
+    /**
+     * @brief Formats IPC and the events per unit on one line, missing events as n/a
+     */
+    std::string report(uint64_t units, const std::string& unit_name = "sym") const;
+
+    /**
+     * @brief Gets the printable name of an event
+     */
+    static const char* event_name(perf_event_kind kind);
+};
+
+/**
+ * @class perf_counters
+ * @brief Hardware performance counters of the calling thread (perf_event_open)
+ *
+ * Every event is opened on its own, user space only, so a PMU without LLC
+ * events or a container allowing just a few counters still yields the rest.
+ * Events that cannot be opened (no PMU, perf_event_paranoid, seccomp, not
+ * Linux) are reported as missing; nothing throws. The counters follow the
+ * thread that created the object: create one per worker thread.
+ */
+class perf_counters {
+public:
+    using ptr = std::unique_ptr<perf_counters>;
+
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    /**
+     * @brief Creates the counters of the calling thread
+     */
+    static ptr make();
+
+    /**
+     * @brief Checks whether at least one event could be opened
+     */
+    bool available() const;
+
+    /**
+     * @brief Checks whether an event could be opened
+     */
+    bool has(perf_event_kind kind) const {
+        return fds_m[static_cast<size_t>(kind)] >= 0;
+    }
+
+    /**
+     * @brief Resets and enables all opened events
+     */
+    void start();
+
+    /**
+     * @brief Disables the events and reads them
+     * @return Counts since start()
+     */
+    perf_sample stop();
+
+private:
+    std::array<int, PERF_EVENT_COUNT>   fds_m;
+};
+
+/**
+ * @class perf_scope
+ * @brief Adds the counts of its lifetime to a sample
+ */
+class perf_scope {
+public:
+    perf_scope(perf_counters& counters, perf_sample& sample) : counters_m(counters), sample_m(sample) {
+        counters_m.start();
+    }
+
+    ~perf_scope() {
+        sample_m.merge(counters_m.stop());
+    }
+
+    perf_scope(const perf_scope&) = delete;
+    perf_scope& operator=(const perf_scope&) = delete;
+
+private:
+    perf_counters&  counters_m;
+    perf_sample&    sample_m;
+};
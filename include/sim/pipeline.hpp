@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "phys/chan.hpp"
+#include "phys/qam/qam.hpp"
+#include "phys/qam/qam_demodulator.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "sim/bit_source.hpp"
+#include "sim/engine.hpp"
+#include "sim/error_stats.hpp"
+#include "sim/point.hpp"
+#include "sim/profile.hpp"
+#include "sim/spsc_ring.hpp"
+#include "types/complex.hpp"
+#include "types/def.hpp"
+
+/**
+ * @struct pipeline_config
+ * @brief Blocks, queues and threads of a sim_pipeline
+ */
+struct pipeline_config {
+    size_t  block_bytes     = 16 * 1024;    // Payload of one block, rounded down to whole symbols (multiple of 3)
+    size_t  depth           = 8;            // Blocks per queue between two stages (rounded up to a power of two)
+    bool    pin             = true;         // Pin every stage thread to its own core
+    size_t  first_core      = 0;            // Core of the first stage, the others follow (modulo the cores)
+};
+
+// generate, modulate, transmit, demodulate, count
+constexpr size_t PIPELINE_STAGES = 5;
+
+/**
+ * @struct pipeline_stage_stats
+ * @brief Activity of one pipeline stage
+ */
+struct pipeline_stage_stats {
+    uint64_t    blocks          = 0;    // Blocks processed
+    uint64_t    busy_ns         = 0;    // Time spent in the stage's kernel
+    uint64_t    input_waits     = 0;    // Polls of an empty input queue (starved)
+    uint64_t    output_waits    = 0;    // Polls of a full output queue (backpressure)
+    uint64_t    occupancy_sum   = 0;    // Input queue length at every pop, summed
+    size_t      occupancy_max   = 0;    // Longest input queue seen
+
+    /**
+     * @brief Gets the mean input queue length seen by the stage
+     */
+    double mean_occupancy() const {
+        return blocks ? static_cast<double>(occupancy_sum) / static_cast<double>(blocks) : 0.0;
+    }
+};
+
+/**
+ * @struct pipeline_stats
+ * @brief Per-stage activity and throughput of pipelined runs
+ */
+struct pipeline_stats {
+    std::array<pipeline_stage_stats, PIPELINE_STAGES>   stages{};   // Indexed by sim_stage GENERATE..COUNT
+    uint64_t                                            total_ns = 0;
+    uint64_t                                            bits     = 0;
+
+    const pipeline_stage_stats& at(sim_stage stage) const {
+        return stages[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Gets the bit throughput
+     * @return Bits per second, 0 if nothing was timed
+     */
+    double bits_per_second() const;
+
+    /**
+     * @brief Formats throughput and the utilisation / queue length of every stage
+     */
+    std::string report() const;
+
+    void reset() {
+        *this = pipeline_stats();
+    }
+};
+
+/**
+ * @class sim_pipeline
+ * @brief Monte-Carlo chain with every stage on its own thread
+ *
+ * Bit source, modulator, channel, demodulator and error counter run as
+ * stages connected by spsc_ring queues of block indices. Blocks are
+ * preallocated (4 * depth of them) and return from the counter to the
+ * source through a free queue; the modem tables are built once by the
+ * constructor, so nothing is allocated while running.
+ * A stage polls its input queue when starved and its output queue when
+ * the next stage is behind; the bounded queues propagate backpressure up
+ * to the source. Frames are cut into blocks like the tiles of sim_engine
+ * and every block goes through the kernels of its staged chain.
+ * @tparam DTYPE Data type for components of complex number
+ */
+template<typename DTYPE>
+class sim_pipeline {
+public:
+    using ptr = std::unique_ptr<sim_pipeline>;
+
+    // called by the transmit stage with the received symbols of every block
+    using symbol_tap = std::function<void(const complex<DTYPE>& symbols, size_t count)>;
+
+    /**
+     * @brief Constructor
+     * @param mapper Mapper shared by the modulator and the demodulator
+     * @param engine Frame size, seed, stream and energy (tile_bytes and fused are not used)
+     * @param cfg Blocks, queues and threads
+     */
+    sim_pipeline(std::shared_ptr<mapper_base> mapper, const engine_config& engine,
+                 const pipeline_config& cfg = pipeline_config());
+
+    static ptr make(std::shared_ptr<mapper_base> mapper, const engine_config& engine,
+                    const pipeline_config& cfg = pipeline_config());
+
+    sim_pipeline(const sim_pipeline&) = delete;
+    sim_pipeline& operator=(const sim_pipeline&) = delete;
+
+    /**
+     * @brief Simulates a number of frames at the given noise level
+     * @param sigma Standard deviation of noise
+     * @param frames Number of frames
+     * @return Accumulated bits and errors
+     * @throws The first exception of a stage, after all stages stopped
+     */
+    ber_point run(double sigma, size_t frames);
+
+    /**
+     * @brief Sets a tap on the received symbols (e.g. an evm_meter), empty to remove it
+     *        (runs on the transmit thread; an exception aborts the run)
+     */
+    void set_symbol_tap(symbol_tap tap) {
+        tap_m = std::move(tap);
+    }
+
+    /**
+     * @brief Gets the error statistics of the runs since the last reset_stats()
+     */
+    const error_stats& get_error_stats() const {
+        return errors_m;
+    }
+
+    /**
+     * @brief Gets the stage activity accumulated since the last reset_stats()
+     */
+    const pipeline_stats& get_stats() const {
+        return stats_m;
+    }
+
+    /**
+     * @brief Clears the stage activity and the error statistics
+     */
+    void reset_stats() {
+        stats_m.reset();
+        errors_m = error_stats();
+    }
+
+    const pipeline_config& get_config() const {
+        return cfg_m;
+    }
+
+private:
+    struct block {
+        std::vector<byte>   tx_bits;
+        std::vector<byte>   rx_bits;
+        complex<DTYPE>      symbols;
+        size_t              bytes = 0;  // Payload of this block
+        size_t              count = 0;  // Symbols of this block
+    };
+
+    using queue = spsc_ring<uint32_t>;
+
+    /**
+     * @brief Takes the next block index, polling while the queue is empty
+     */
+    uint32_t pop(queue& input, pipeline_stage_stats& stats);
+
+    /**
+     * @brief Hands a block index on, polling while the queue is full
+     */
+    void push(queue& output, uint32_t index, pipeline_stage_stats& stats);
+
+    engine_config                       engine_m;
+    pipeline_config                     cfg_m;
+    qam_modulator<DTYPE>                modulator_m;
+    qam_demodulator<DTYPE>              demodulator_m;
+    channel<DTYPE>                      channel_m;
+    error_counter                       counter_m;  // Current run, merged into errors_m when it succeeds
+    error_stats                         errors_m;
+    random_bit_source                   source_m;
+    pipeline_stats                      stats_m;
+    symbol_tap                          tap_m;
+
+    std::vector<block>                  blocks_m;
+    std::unique_ptr<queue>              free_m;     // count -> generate
+    std::array<std::unique_ptr<queue>, PIPELINE_STAGES - 1> links_m;
+    std::atomic<bool>                   abort_m{false};
+};
+
+SIM_TEMPLATES(sim_pipeline)
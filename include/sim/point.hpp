@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @struct ber_point
+ * @brief Monte-Carlo result for a single sweep point
+ */
+struct ber_point {
+    double   sigma  = 0.0;  // Noise standard deviation of the point
+    uint64_t bits   = 0;    // Number of simulated bits
+    uint64_t errors = 0;    // Number of bit errors
+    uint64_t frames = 0;    // Number of simulated frames
+
+    /**
+     * @brief Adds the counts of another run of the same point
+     * @param other Counts to add
+     */
+    void merge(const ber_point& other) {
+        bits   += other.bits;
+        errors += other.errors;
+        frames += other.frames;
+    }
+
+    /**
+     * @brief Gets the bit error rate of the point
+     * @return errors / bits, 0 if nothing was simulated
+     */
+    double ber() const {
+        return bits ? static_cast<double>(errors) / static_cast<double>(bits) : 0.0;
+    }
+
+    /**
+     * @brief Gets the BER with zero-error points clamped to the measurement resolution
+     * @return ber() or 0.5 / bits when no error was observed
+     */
+    double resolved_ber() const {
+        if (errors == 0) {
+            return bits ? 0.5 / static_cast<double>(bits) : 1.0;
+        }
+        return ber();
+    }
+};
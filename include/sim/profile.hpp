@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum sim_stage
+ * @brief Stages of the simulation chain
+ */
+enum class sim_stage : size_t {
+    GENERATE    = 0,    //< Payload bit generation
+    MODULATE    = 1,    //< Bits -> symbols
+    TRANSMIT    = 2,    //< AWGN channel
+    DEMODULATE  = 3,    //< Symbols -> bits
+    COUNT       = 4,    //< Error counting
+    FUSED       = 5,    //< Fused modulate / channel / slice / count kernel
+};
+
+constexpr size_t SIM_STAGE_COUNT = 6;
+
+/**
+ * @struct stage_profile
+ * @brief Throughput and per-stage time of simulated runs
+ *
+ * Owned by one engine, i.e. one thread: nothing is shared or locked on the
+ * hot path, profiles of several threads are combined with merge(). Total
+ * time and throughput are always recorded (two clock reads per run); the
+ * per-stage split is compiled in with SIM_STAGE_TIMING only.
+ */
+struct stage_profile {
+#ifdef SIM_STAGE_TIMING
+    static constexpr bool STAGES_ENABLED = true;
+#else
+    static constexpr bool STAGES_ENABLED = false;
+#endif
+
+    std::array<uint64_t, SIM_STAGE_COUNT>   stage_ns{};     // Time per stage
+    uint64_t                                total_ns = 0;   // Wall time of the runs
+    uint64_t                                symbols  = 0;   // Simulated symbols
+    uint64_t                                bits     = 0;   // Simulated payload bits
+
+    /**
+     * @brief Adds the counts of another profile
+     */
+    void merge(const stage_profile& other);
+
+    /**
+     * @brief Clears all counts
+     */
+    void reset() {
+        *this = stage_profile();
+    }
+
+    /**
+     * @brief Gets the symbol throughput
+     * @return Symbols per second, 0 if nothing was timed
+     */
+    double symbols_per_second() const;
+
+    /**
+     * @brief Gets the bit throughput
+     * @return Bits per second, 0 if nothing was timed
+     */
+    double bits_per_second() const;
+
+    /**
+     * @brief Gets the share of a stage in the total time
+     * @return stage_ns / total_ns, 0 if nothing was timed
+     */
+    double stage_share(sim_stage stage) const;
+
+    /**
+     * @brief Formats throughput and stage shares on one line
+     */
+    std::string report() const;
+
+    /**
+     * @brief Gets the printable name of a stage
+     */
+    static const char* stage_name(sim_stage stage);
+};
+
+/**
+ * @class stage_scope
+ * @brief Adds the lifetime of the scope to a stage of a profile
+ */
+class stage_scope {
+public:
+    stage_scope(stage_profile& profile, sim_stage stage) 
+        : profile_m(profile), stage_m(stage), start_m(std::chrono::steady_clock::now()) {}
+
+    ~stage_scope() {
+        auto elapsed = std::chrono::steady_clock::now() - start_m;
+        profile_m.stage_ns[static_cast<size_t>(stage_m)] += 
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    }
+
+    stage_scope(const stage_scope&) = delete;
+    stage_scope& operator=(const stage_scope&) = delete;
+
+private:
+    stage_profile&                          profile_m;
+    sim_stage                               stage_m;
+    std::chrono::steady_clock::time_point   start_m;
+};
+
+#define SIM_STAGE_CONCAT_IMPL(a, b) a##b
+#define SIM_STAGE_CONCAT(a, b) SIM_STAGE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Times the rest of the enclosing scope as a stage (no code without SIM_STAGE_TIMING)
+ */
+#ifdef SIM_STAGE_TIMING
+#define SIM_TIME_STAGE(profile, stage) stage_scope SIM_STAGE_CONCAT(stage_scope_, __LINE__)(profile, stage)
+#else
+#define SIM_TIME_STAGE(profile, stage) do {} while (0)
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+
+#include "file/iq_file.hpp"
+#include "phys/qam/qam.hpp"
+#include "sim/evm.hpp"
+#include "sim/noise_estimator.hpp"
+#include "types/def.hpp"
+
+/**
+ * @struct replay_config
+ * @brief Parameters of a capture replay
+ */
+struct replay_config {
+    size_t  chunk_samples   = 1 << 16;  // Symbols per work item, multiple of 8 (whole output bytes)
+    size_t  threads         = 0;        // Demodulator threads, 0 = hardware concurrency
+    size_t  max_in_flight   = 0;        // Chunks ahead of the writer, 0 = 4 per thread
+    bool    llr             = false;    // Decide by the LLR signs of demodulate_llr() instead of the slicer
+    double  sigma           = 0.0;      // Noise for the LLRs, 0 = header sigma (estimated per chunk if unknown)
+    bool    blind           = false;    // Estimate the noise of every chunk instead of using the header sigma
+    noise_method estimator  = noise_method::M2M4;
+    bool    unit_energy     = false;    // Capture uses the unit-energy constellation (not with llr)
+    bool    measure         = false;    // Decision-directed EVM / MER / SNR of the capture
+};
+
+/**
+ * @struct replay_stats
+ * @brief Throughput of a replay
+ */
+struct replay_stats {
+    uint64_t    samples     = 0;    // Demodulated symbols
+    uint64_t    chunks      = 0;    // Work items
+    uint64_t    bytes_in    = 0;    // Payload bytes read from the capture
+    uint64_t    bytes_out   = 0;    // Bit bytes handed to the sink
+    double      seconds     = 0.0;  // Wall time
+    evm_stats   quality;            // Modulation quality, if measured
+    noise_estimate noise;           // Noise of the whole capture, if estimated
+
+    double samples_per_second() const {
+        return seconds > 0 ? static_cast<double>(samples) / seconds : 0.0;
+    }
+
+    double read_bytes_per_second() const {
+        return seconds > 0 ? static_cast<double>(bytes_in) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Demodulates a recorded capture on all cores, output in capture order
+ *
+ * The capture is cut into symbol chunks which worker threads copy out of
+ * the mapping and demodulate with their own qam_demodulator. Finished
+ * chunks wait in a reorder buffer until all earlier ones were handed to
+ * the sink, which is called on the calling thread only; workers stall
+ * when they run max_in_flight chunks ahead of it, which bounds memory.
+ * With cfg.measure every worker also feeds its own evm_meter; the meters
+ * are merged into replay_stats::quality when the workers finish. Without
+ * a known sigma (or with cfg.blind) every chunk goes through a
+ * noise_estimator first and the LLRs of the chunk use its estimate.
+ * @tparam DTYPE Sample type of the capture
+ * @param reader Mapped capture
+ * @param mapper Mapper of the capture's modulation
+ * @param cfg Chunking and threads
+ * @param sink Receives the packed bits (MSB first) of consecutive chunks
+ * @return Throughput counters
+ * @throws std::invalid_argument on a bad chunk size or llr with unit_energy; worker errors are rethrown
+ */
+template<typename DTYPE>
+replay_stats ext_replay_capture(const iq_reader<DTYPE>& reader, std::shared_ptr<mapper_base> mapper,
+                                const replay_config& cfg, const std::function<void(std::span<const byte>)>& sink);
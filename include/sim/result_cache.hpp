@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "sim/point.hpp"
+
+/**
+ * @class result_cache
+ * @brief On-disk cache of simulated points keyed by a configuration hash
+ *
+ * The key is a hash of everything that changes the statistics of a point
+ * (see sweep_job::point_key); the value is its accumulated counts, so a
+ * point simulated with fewer frames than requested can be topped up and
+ * stored again. All methods are thread safe. save() writes a temporary
+ * file and renames it over the cache file.
+ *
+ * File layout (native endianness):
+ *      "YQRC" | u32 version | u64 count | count x entry
+ *      entry: u64 key | f64 sigma | u64 bits | u64 errors | u64 frames
+ */
+class result_cache { 
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @brief Constructor
+     * @param filename Cache file
+     */
+    explicit result_cache(const std::string& filename);
+
+    /**
+     * @brief Loads the cache file
+     * @return true if the file was loaded, false if it does not exist
+     * @throws std::runtime_error on a corrupted or incompatible file
+     */
+    bool load();
+
+    /**
+     * @brief Writes the cache file
+     */
+    void save() const;
+
+    /**
+     * @brief Looks up a point
+     * @param key Configuration hash of the point
+     * @return Cached counts if the point was simulated before
+     */
+    std::optional<ber_point> find(uint64_t key) const;
+
+    /**
+     * @brief Stores a point, replacing an entry with fewer frames
+     * @param key Configuration hash of the point
+     * @param point Accumulated counts
+     */
+    void store(uint64_t key, const ber_point& point);
+
+    /**
+     * @brief Gets the number of cached points
+     */
+    size_t size() const;
+
+private:
+    std::string                             filename_m;
+    mutable std::mutex                      mutex_m;
+    std::unordered_map<uint64_t, ber_point> entries_m;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "phys/qam/qam.hpp"
+#include "sim/engine.hpp"
+#include "sim/point.hpp"
+
+/**
+ * @struct shard_plan
+ * @brief Deterministic partition of a sweep over worker processes
+ *
+ * The sweep space is (modulation, sigma, block); work item n is owned by
+ * shard n % shard_count. Every item seeds its payload and noise streams
+ * from (engine.seed, n), so the merged result does not depend on how many
+ * shards ran it or on which machine.
+ */
+struct shard_plan {
+    std::vector<qam_order>  modulations;            // Simulated modulations
+    std::vector<double>     sigmas;                 // Sigma grid
+    uint32_t                blocks_per_point = 5;   // Work items per (modulation, sigma)
+    uint64_t                frames_per_block = 10;  // Frames per work item
+    uint32_t                shard_count      = 1;   // Number of shards
+    engine_config           engine;                 // Engine parameters (seed must be set)
+
+    /**
+     * @brief Gets the number of work items
+     */
+    uint64_t item_count() const { 
+        return static_cast<uint64_t>(modulations.size()) * sigmas.size() * blocks_per_point;
+    }
+
+    /**
+     * @brief Gets a hash of everything that influences the results
+     */
+    uint64_t hash() const;
+};
+
+/**
+ * @struct shard_cell
+ * @brief Partial counts of one (modulation, sigma) cell
+ */
+struct shard_cell {
+    qam_order   modulation = qam_order::QPSK;
+    ber_point   point;
+};
+
+/**
+ * @brief Runs the work items of one shard and writes its shard file
+ * @param plan Sweep partition
+ * @param shard_index Index of the shard (< plan.shard_count)
+ * @param filename Shard file to write
+ * @return Partial counts of the shard, one cell per (modulation, sigma)
+ */
+template<typename DTYPE>
+std::vector<shard_cell> run_shard(const shard_plan& plan, uint32_t shard_index, const std::string& filename);
+
+/**
+ * @brief Gets the file name of a shard
+ * @param directory Directory with shard files
+ * @param shard_index Index of the shard
+ */
+std::string shard_file_name(const std::string& directory, uint32_t shard_index);
+
+/**
+ * @brief Merges shard files into the final counts
+ * @param plan Sweep partition the shards were run with
+ * @param directory Directory with shard files (see shard_file_name)
+ * @return One cell per (modulation, sigma), ordered like the plan
+ * @throws std::runtime_error if a shard is missing or belongs to another plan
+ */
+std::vector<shard_cell> merge_shards(const shard_plan& plan, const std::string& directory);
+
+/**
+ * @brief Local stand-in launcher: forks one worker process per shard,
+ *        waits for all of them and merges their shard files
+ * @param plan Sweep partition
+ * @param directory Directory for shard files
+ * @return Merged cells
+ */
+template<typename DTYPE>
+std::vector<shard_cell> launch_local_shards(const shard_plan& plan, const std::string& directory);
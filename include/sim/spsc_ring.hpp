@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @class spsc_ring
+ * @brief Bounded lock-free queue between exactly one producer and one consumer thread
+ *
+ * The producer owns the tail, the consumer the head; each side keeps a
+ * cached copy of the other index and reloads it only when the ring looks
+ * full (or empty), so an uncontended push or pop touches no shared cache
+ * line. Indices are free-running, the capacity is rounded up to a power
+ * of two.
+ * @tparam T Trivially copyable element (e.g. a block index)
+ */
+template<typename T>
+class spsc_ring {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Elements the ring can hold, rounded up to a power of two
+     * @throws std::invalid_argument if capacity is 0
+     */
+    explicit spsc_ring(size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("capacity must be > 0");
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_m.resize(size);
+        mask_m = size - 1;
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    /**
+     * @brief Appends an element (producer thread only)
+     * @return false if the ring is full
+     */
+    bool try_push(const T& value) {
+        const size_t tail = tail_m.load(std::memory_order_relaxed);
+        if (tail - head_cache_m > mask_m) {
+            head_cache_m = head_m.load(std::memory_order_acquire);
+            if (tail - head_cache_m > mask_m) {
+                return false;
+            }
+        }
+        slots_m[tail & mask_m] = value;
+        tail_m.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element (consumer thread only)
+     * @return false if the ring is empty
+     */
+    bool try_pop(T& value) {
+        const size_t head = head_m.load(std::memory_order_relaxed);
+        if (head == tail_cache_m) {
+            tail_cache_m = tail_m.load(std::memory_order_acquire);
+            if (head == tail_cache_m) {
+                return false;
+            }
+        }
+        value = slots_m[head & mask_m];
+        head_m.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Gets the number of queued elements (exact on either side, a snapshot elsewhere)
+     */
+    size_t size() const {
+        return tail_m.load(std::memory_order_acquire) - head_m.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return slots_m.size();
+    }
+
+private:
+    // consumer side and producer side on separate cache lines
+    alignas(64) std::atomic<size_t>    head_m{0};
+    size_t                              tail_cache_m = 0;   // Consumer's copy of tail_m
+    alignas(64) std::atomic<size_t>    tail_m{0};
+    size_t                              head_cache_m = 0;   // Producer's copy of head_m
+    alignas(64) std::vector<T>          slots_m;
+    size_t                              mask_m = 0;
+};
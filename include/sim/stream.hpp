@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "file/async_io.hpp"
+#include "file/iq_file.hpp"
+#include "phys/qam/qam.hpp"
+
+/**
+ * @struct stream_config
+ * @brief Parameters of a streaming file-to-file modulation
+ */
+struct stream_config {
+    size_t      block_bytes     = 4 << 20;  // Payload bytes read per block (rounded up to IO_ALIGN)
+    bool        background      = true;     // Overlap symbol writes with the modulation
+    async_io_config io;                     // Read engine and depth (block_bytes is taken from above)
+    bool        unit_energy     = false;    // Modulate onto the unit-energy constellation
+    iq_metadata iq;                         // Layout of the output (modulation is taken from the mapper)
+};
+
+/**
+ * @struct stream_stats
+ * @brief Throughput of a streaming modulation
+ */
+struct stream_stats {
+    uint64_t    bytes_in    = 0;    // Payload bytes read
+    uint64_t    samples     = 0;    // Symbols written
+    uint64_t    blocks      = 0;    // Blocks read
+    double      seconds     = 0.0;  // Wall time
+
+    double bytes_per_second() const {
+        return seconds > 0 ? static_cast<double>(bytes_in) / seconds : 0.0;
+    }
+
+    double samples_per_second() const {
+        return seconds > 0 ? static_cast<double>(samples) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Modulates a payload file of any size into an IQ file in constant memory
+ *
+ * The payload is read in blocks of cfg.block_bytes. A block is modulated up
+ * to its last whole bit group; the remaining bytes (less than one group,
+ * e.g. 3 bytes = 4 symbols for QAM64) are carried in front of the next
+ * block, so the symbols equal those of one modulate() call over the whole
+ * file. The payload comes through a block_source, which keeps the next
+ * reads in flight; two symbol buffers alternate so the previous symbols
+ * are written while the current block is modulated.
+ * @tparam DTYPE Sample type of the output
+ * @param input Payload file (any bytes)
+ * @param output IQ file to create
+ * @param mapper Mapper of the modulation
+ * @param cfg Block size and output layout
+ * @return Throughput counters
+ * @throws std::runtime_error on I/O errors
+ * @throws std::invalid_argument on a null mapper or a zero block size
+ */
+template<typename DTYPE>
+stream_stats ext_stream_modulate(const std::string& input, const std::string& output,
+                                 std::shared_ptr<mapper_base> mapper, const stream_config& cfg = stream_config());
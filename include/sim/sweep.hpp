@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "sim/point.hpp"
+
+/**
+ * @class adaptive_sweep
+ * @brief BER vs sigma sweep with adaptive grid refinement
+ *
+ * Starts with a coarse uniform grid and recursively bisects the interval
+ * whose log10(BER) changes most, until the point budget is spent or the
+ * curve is resolved to the requested tolerance.
+ */
+class adaptive_sweep {
+public:
+    using evaluator = std::function<ber_point(double sigma)>;
+
+    /**
+     * @struct config
+     * @brief Sweep parameters
+     */
+    struct config {
+        double sigma_start   = 0.0;     // First grid point
+        double sigma_end     = 10.0;    // Last grid point (inclusive)
+        size_t coarse_points = 11;      // Points of the initial uniform grid (>= 2)
+        size_t point_budget  = 64;      // Total number of evaluated points
+        double min_step      = 0.01;    // Intervals narrower than this are not split
+        double tolerance     = 0.05;    // Intervals with smaller |d log10(BER)| are not split
+    };
+
+    /**
+     * @brief Constructor
+     * @param cfg Sweep parameters
+     */
+    explicit adaptive_sweep(const config& cfg);
+
+    /**
+     * @brief Runs the sweep
+     * @param eval Callback simulating one sigma point
+     * @return Evaluated points sorted by sigma
+     */
+    std::vector<ber_point> run(const evaluator& eval);
+
+    /**
+     * @brief Gets the refinement score of an interval
+     * @param left Left point
+     * @param right Right point
+     * @return |log10(BER_right) - log10(BER_left)|
+     */
+    static double interval_score(const ber_point& left, const ber_point& right);
+
+private:
+    config cfg_m;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "phys/qam/qam.hpp"
+#include "phys/qam/mapper.hpp"
+#include "sim/point.hpp"
+
+/**
+ * @struct theory_point
+ * @brief Analytic error rates of one AWGN operating point
+ */
+struct theory_point {
+    double ber = 0.0;   // Bit error rate
+    double ser = 0.0;   // Symbol error rate
+};
+
+/**
+ * @brief Gaussian tail probability Q(x) = 0.5 * erfc(x / sqrt(2))
+ */
+double ext_qfunc(double x);
+
+/**
+ * @brief BER of ideal Gray-labelled square QAM in AWGN
+ *
+ * Sum of the Q terms of all odd distances per axis; exact for QPSK,
+ * accurate to the first order in the number of bit errors per symbol
+ * error for QAM16 / QAM64.
+ * @param order Modulation order
+ * @param ebn0_db Eb/N0 in dB
+ * @return Bit error rate
+ */
+double ext_gray_qam_ber(qam_order order, double ebn0_db);
+
+/**
+ * @brief Vectorized ext_gray_qam_ber() over an Eb/N0 grid
+ */
+std::vector<double> ext_gray_qam_ber(qam_order order, std::span<const double> ebn0_db);
+
+/**
+ * @brief Exact SER of square QAM with a per-axis decision in AWGN
+ * @param order Modulation order
+ * @param esn0_db Es/N0 in dB
+ * @return Symbol error rate
+ */
+double ext_gray_qam_ser(qam_order order, double esn0_db);
+
+/**
+ * @brief Vectorized ext_gray_qam_ser() over an Es/N0 grid
+ */
+std::vector<double> ext_gray_qam_ser(qam_order order, std::span<const double> esn0_db);
+
+/**
+ * @class constellation_theory
+ * @brief Exact BER / SER of a rectangular constellation table in AWGN
+ *
+ * Decisions of the per-axis slicer are independent on I and Q, so the
+ * probability of deciding point t when s was sent is a product of two
+ * differences of Q functions. BER sums these transition probabilities
+ * weighted by the Hamming distance of the labels, which makes the result
+ * exact for any labelling of the table (Gray or not) at any sigma.
+ */
+class constellation_theory {
+public:
+    /**
+     * @brief Constructor
+     * @param table Constellation table (raw or unit energy, sigma refers to its scale)
+     * @param bits_per_symbol Bits per symbol
+     * @throws std::invalid_argument if the table is not a full rectangular grid
+     */
+    constellation_theory(const qam_table<double>& table, uint32_t bits_per_symbol);
+
+    /**
+     * @brief Error rates at a noise level
+     * @param sigma Noise standard deviation per component
+     */
+    theory_point at_sigma(double sigma) const;
+
+    /**
+     * @brief Vectorized at_sigma() over a sigma grid
+     */
+    std::vector<theory_point> at_sigma(std::span<const double> sigmas) const;
+
+    /**
+     * @brief Gets the average energy of the table
+     */
+    double get_symbol_energy() const {
+        return symbol_energy_m;
+    }
+
+private:
+    /**
+     * @brief Per-axis transition probabilities P(decide level j | sent level a)
+     */
+    std::vector<double> axis_transitions(const std::vector<double>& levels, double sigma) const;
+
+    uint32_t                bits_per_symbol_m;
+    double                  symbol_energy_m = 0.0;
+    std::vector<double>     levels_i_m;
+    std::vector<double>     levels_q_m;
+    std::vector<uint32_t>   grid_index_m;       // [level_i * levels_q + level_q] -> symbol index
+};
+
+/**
+ * @brief Frames needed to observe a number of errors at an expected BER
+ * @param expected_ber Expected bit error rate
+ * @param bits_per_frame Payload bits per frame
+ * @param target_errors Errors to observe
+ * @param min_frames Lower bound of the budget
+ * @param max_frames Upper bound of the budget
+ * @return ceil(target_errors / (expected_ber * bits_per_frame)) clamped to [min_frames, max_frames]
+ */
+uint64_t ext_plan_frames(double expected_ber, uint64_t bits_per_frame, uint64_t target_errors,
+                         uint64_t min_frames, uint64_t max_frames);
+
+/**
+ * @brief Deviation of a simulated point from its expected BER
+ * @param point Simulated point
+ * @param expected_ber Expected bit error rate
+ * @return (errors - bits * p) / sqrt(bits * p * (1 - p)), i.e. binomial standard deviations
+ */
+double ext_ber_deviation(const ber_point& point, double expected_ber);
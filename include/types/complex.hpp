@@ -87,6 +87,14 @@ public:
      *      - [1] - quadrature array components
      */
     std::array<std::span<DTYPE>, 2> decompose();
+
+    /**
+     * @brief Read-only version of decompose()
+     * @return std::array<2>
+     *      - [0] - in-phase array components
+     *      - [1] - quadrature array components
+     */
+    std::array<std::span<const DTYPE>, 2> decompose() const;
     
     /**
      * OPERATORS
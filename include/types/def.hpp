@@ -35,4 +35,11 @@ using byte  = unsigned char;
 
 #define QAM_MODEM_TEMPLATES(classname)                  \
     template class classname<float>;                    \
-    template class classname<double>;
\ No newline at end of file
+    template class classname<double>;
+
+/**
+ * sim templates
+ */
+#define SIM_TEMPLATES(classname)                        \
+    template class classname<float>;                    \
+    template class classname<double>;
@@ -1,18 +1,32 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
 
 #include "phys/qam/mapper.hpp"
-#include "phys/qam/qam_demodulator.hpp"
-#include "phys/qam/qam_modulator.hpp"
-#include "phys/chan.hpp"
-#include "file/csv_writer.hpp"
+#include "file/async_io.hpp"
+#include "file/file.hpp"
+#include "file/result_writer.hpp"
+#include "sim/checkpoint.hpp"
+#include "sim/engine.hpp"
+#include "sim/histogram.hpp"
+#include "sim/job.hpp"
+#include "sim/perf_counters.hpp"
+#include "sim/pipeline.hpp"
+#include "sim/replay.hpp"
+#include "sim/shard.hpp"
+#include "sim/stream.hpp"
+#include "sim/sweep.hpp"
 #include "types/def.hpp" 
 
 #define SYMBOL_DTYPE float
@@ -20,51 +34,50 @@
 // Mutex for thread-safe console output
 std::mutex cout_mutex;
 
-std::vector<byte> generate_random_bytes(size_t length) {
-    static std::mt19937 rng(static_cast<unsigned int>(std::time(nullptr)));
-    std::uniform_int_distribution<uint8_t> dist(0, 255);
-    
-    std::vector<byte> random_bytes(length);
-    
-    for (size_t i = 0; i < length; ++i) {
-        random_bytes[i] = dist(rng);
-    }
-    
-    return random_bytes;
-}
+// modulation of each worker thread / output file
+const qam_order modulations[] = {
+    qam_order::QPSK,
+    qam_order::QAM16,
+    qam_order::QAM64
+};
 
+// columns of the shard files
+const std::vector<result_column> ber_columns = {
+    {"sigma", 4},
+    {"ber",   15}
+};
 
-// i love xor
-size_t count_bit_errors(const std::vector<byte>& bits1, const std::vector<byte>& bits2) {
-    size_t errors = 0;
-    size_t min_size = std::min(bits1.size(), bits2.size());
-    
-    for (size_t i = 0; i < min_size; ++i) {
-        byte xor_result = bits1[i] ^ bits2[i];
-        for (int j = 0; j < 8; ++j) {
-            if ((xor_result >> j) & 1) {
-                errors++;
-            }
-        }
+// columns of the ber_sigma_*.csv files
+const std::vector<result_column> sweep_columns = {
+    {"sigma",      4},
+    {"ber",        15},
+    {"ser",        6, true},
+    {"mean_burst", 3}
+};
+
+// SER and bursts of the frames simulated by this process, empty without symbol statistics (fused kernel)
+std::string error_report(const error_stats& stats) {
+    if (stats.symbols == 0) {
+        return "";
     }
-    
-    return errors;
+    std::ostringstream oss;
+    oss << ", SER: " << std::scientific << std::setprecision(3) << stats.ser()
+        << ", bursts: " << stats.bursts << " (mean " << std::fixed << std::setprecision(2) << stats.mean_burst()
+        << ", max " << stats.max_burst << ")";
+    return oss.str();
 }
 
-void process_modulation(int modulation_index, double sigma_start, double sigma_end, double sigma_step, 
-                        int iterations, const std::string& filename) {
+void process_modulation(int modulation_index, const adaptive_sweep::config& sweep_cfg, 
+                        const engine_config& engine_cfg, size_t frames, size_t frames_per_save, 
+                        const std::string& filename, bool perf, bool pipelined) {
     std::string modulation_name;
-    int test_sequence_len;
     
     if (modulation_index == 0) {
         modulation_name = "QPSK";
-        test_sequence_len = 64;
     } else if (modulation_index == 1) {
         modulation_name = "QAM16";
-        test_sequence_len = 64;
     } else {
         modulation_name = "QAM64";
-        test_sequence_len = 64;
     }
     
     //?????
@@ -74,61 +87,106 @@ void process_modulation(int modulation_index, double sigma_start, double sigma_e
     }
     
     std::shared_ptr<mapper_base> mapper;
-    if (modulation_index == 0) {
+    if (modulations[modulation_index] == qam_order::QPSK) {
         mapper = qam_mapper<SYMBOL_DTYPE, qam_order::QPSK>::make();
-    } else if (modulation_index == 1) {
+    } else if (modulations[modulation_index] == qam_order::QAM16) {
         mapper = qam_mapper<SYMBOL_DTYPE, qam_order::QAM16>::make();
     } else {
         mapper = qam_mapper<SYMBOL_DTYPE, qam_order::QAM64>::make();
     }
     
     
-    auto modulator = qam_modulator<SYMBOL_DTYPE>::make();
-    auto demodulator = qam_demodulator<SYMBOL_DTYPE>::make();
+    // own payload stream per modulation thread
+    engine_config thread_cfg = engine_cfg;
+    thread_cfg.stream = static_cast<uint64_t>(modulation_index);
     
-    modulator->set_mapper(mapper);
-    demodulator->set_mapper(mapper);
+    auto engine = sim_engine<SYMBOL_DTYPE>::make(mapper, thread_cfg);
     
-    csv_writer writer;
-    writer.set_file_name(filename);
-    writer.set_headers("sigma,ber");
+    // stages of each modulation on their own cores
+    sim_pipeline<SYMBOL_DTYPE>::ptr pipeline;
+    if (pipelined) {
+        pipeline_config pipe_cfg;
+        pipe_cfg.first_core = static_cast<size_t>(modulation_index) * PIPELINE_STAGES;
+        pipeline = sim_pipeline<SYMBOL_DTYPE>::make(mapper, thread_cfg, pipe_cfg);
+    }
     
-    for (double sigma_iter = sigma_start; sigma_iter < sigma_end; sigma_iter += sigma_step) {
-        double result_ber = 0.0; 
-        size_t total_errors = 0;
-        size_t total_bits = 0;
-        
-        channel<SYMBOL_DTYPE> chan(sigma_iter);
-        
-        // Monte-Carlo iterations
-        for (int iter = 0; iter < iterations; ++iter) {
-            std::vector<byte> test_sequence = generate_random_bytes(test_sequence_len);
-            
-            complex<SYMBOL_DTYPE> modulated_symbols = modulator->modulate(test_sequence);
-            
-            complex<SYMBOL_DTYPE> noisy_symbols = chan.transmit(modulated_symbols);
-            
-            std::vector<byte> demodulated_bits = demodulator->demodulate(noisy_symbols);
+    // counters follow the thread that opens them
+    perf_counters::ptr counters = perf ? perf_counters::make() : nullptr;
+    
+    result_writer writer(filename, sweep_columns);
+    
+    // partial results survive a kill: completed points are taken from the
+    // checkpoint, an interrupted one continues from its saved frame count
+    sweep_checkpoint checkpoint(filename + ".ckpt", ext_checkpoint_hash(*engine));
+    try {
+        if (checkpoint.load()) {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << "Resuming " << modulation_name << " from " << filename << ".ckpt ("
+                      << checkpoint.get_records().size() << " points)" << std::endl;
+        }
+    } catch (const std::runtime_error& e) {
+        // another sweep's checkpoint: start over, the first save replaces it
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        std::cout << "Ignoring " << filename << ".ckpt: " << e.what() << std::endl;
+    }
+    
+    // frames restored from the checkpoint have no error statistics
+    std::map<double, error_stats> point_stats;
+    
+    auto simulate_point = [&](double sigma_iter) {
+        if (pipeline) {
+            // streaming shape: no checkpoints inside a point
+            pipeline->reset_stats();
+            ber_point point = pipeline->run(sigma_iter, frames);
+            point_stats[sigma_iter] = pipeline->get_error_stats();
             
-            size_t errors = count_bit_errors(test_sequence, demodulated_bits);
-            total_errors += errors;
-            total_bits += test_sequence_len * 8;
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << modulation_name << " - Sigma: " << std::fixed << std::setprecision(4) << sigma_iter 
+                      << ", BER: " << std::fixed << std::setprecision(15) << point.ber() 
+                      << error_report(point_stats[sigma_iter])
+                      << " (" << pipeline->get_stats().report() << ")" << std::endl;
+            return point;
         }
         
-        result_ber = static_cast<double>(total_errors) / total_bits;
-
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(2) << sigma_iter << ","
-            << std::fixed << std::setprecision(15) << result_ber;
-        
-        writer.push_data(oss.str());
+        // Monte-Carlo frames
+        engine->reset_profile();
+        engine->reset_stats();
+        perf_sample counts;
+        ber_point point;
+        if (counters) {
+            perf_scope scope(*counters, counts);
+            point = resume_point(*engine, checkpoint, sigma_iter, frames, frames_per_save);
+        } else {
+            point = resume_point(*engine, checkpoint, sigma_iter, frames, frames_per_save);
+        }
+        point_stats[sigma_iter] = engine->get_error_stats();
         
         {
             std::lock_guard<std::mutex> lock(cout_mutex);
-            std::cout << modulation_name << " - Sigma: " << std::fixed << std::setprecision(2) << sigma_iter 
-                      << ", BER: " << std::fixed << std::setprecision(15) << result_ber << std::endl;
+            std::cout << modulation_name << " - Sigma: " << std::fixed << std::setprecision(4) << sigma_iter 
+                      << ", BER: " << std::fixed << std::setprecision(15) << point.ber() 
+                      << error_report(point_stats[sigma_iter])
+                      << " (" << engine->get_profile().report() << ")" << std::endl;
+            if (counters) {
+                std::cout << "    " << counts.report(engine->get_profile().symbols) << std::endl;
+            }
         }
+        
+        return point;
+    };
+    
+    // points come back sorted by sigma, whatever order they were refined in
+    adaptive_sweep sweep(sweep_cfg);
+    for (const ber_point& point : sweep.run(simulate_point)) {
+        const error_stats& stats = point_stats[point.sigma];
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        writer.push({point.sigma, point.ber(), stats.symbols ? stats.ser() : none,
+                     stats.symbols ? stats.mean_burst() : none});
     }
+    writer.close();
+    
+    // the results are saved, a rerun must simulate again
+    checkpoint.remove();
     
     {
         std::lock_guard<std::mutex> lock(cout_mutex);
@@ -138,12 +196,139 @@ void process_modulation(int modulation_index, double sigma_start, double sigma_e
     }
 }
 
+void save_shard_cells(const std::vector<shard_cell>& cells, const std::string fnames[]) {
+    for (size_t i = 0; i < 3; ++i) {
+        result_writer writer(fnames[i], ber_columns);
+        
+        for (const auto& cell : cells) {
+            if (cell.modulation != modulations[i]) {
+                continue;
+            }
+            writer.push({cell.point.sigma, cell.point.ber()});
+        }
+        writer.close();
+        
+        std::cout << "Results saved to " << fnames[i] << std::endl;
+    }
+}
+
+void run_replay(const std::string& capture, const std::string& output, const replay_config& cfg) {
+    iq_reader<SYMBOL_DTYPE> reader(capture);
+    const auto order = static_cast<qam_order>(reader.get_header().modulation);
+    
+    // bits leave through asynchronous block writes while the next chunks are demodulated
+    std::unique_ptr<block_sink> out;
+    if (!output.empty()) {
+        out = block_sink::make(output);
+    }
+    
+    const replay_stats stats = ext_replay_capture<SYMBOL_DTYPE>(reader, ext_make_mapper<SYMBOL_DTYPE>(order), cfg,
+        [&](std::span<const byte> bits) {
+            if (out) {
+                out->write(bits);
+            }
+        });
+    
+    std::cout << "Replayed " << stats.samples << " symbols in " << stats.chunks << " chunks, " 
+              << std::fixed << std::setprecision(3) << stats.seconds << " s: " 
+              << std::setprecision(1) << stats.samples_per_second() / 1e6 << " Msym/s, "
+              << stats.read_bytes_per_second() / 1e6 << " MB/s read" << std::endl;
+    if (cfg.measure) {
+        std::cout << stats.quality.report() << std::endl;
+    }
+    if (stats.noise.symbols > 0) {
+        std::cout << "Estimated noise: sigma " << std::setprecision(4) << stats.noise.sigma() 
+                  << ", Es/N0 " << std::setprecision(2) << stats.noise.esn0_db() << " dB" << std::endl;
+    }
+    if (out) {
+        out->close();
+        std::cout << stats.bytes_out << " bytes of bits saved to " << output << std::endl;
+    }
+}
+
+void run_stream_modulate(const std::string& payload, const std::string& output, qam_order order) {
+    const stream_stats stats = ext_stream_modulate<SYMBOL_DTYPE>(payload, output, ext_make_mapper<SYMBOL_DTYPE>(order));
+    
+    std::cout << "Modulated " << stats.bytes_in << " bytes into " << stats.samples << " symbols, " 
+              << std::fixed << std::setprecision(3) << stats.seconds << " s: " 
+              << std::setprecision(1) << stats.bytes_per_second() / 1e6 << " MB/s, "
+              << stats.samples_per_second() / 1e6 << " Msym/s" << std::endl;
+    std::cout << "Symbols saved to " << output << std::endl;
+}
+
+void run_histogram(const std::string& capture, size_t threads) {
+    iq_reader<SYMBOL_DTYPE> reader(capture);
+    
+    const auto start = std::chrono::steady_clock::now();
+    const iq_histogram histogram = ext_histogram_capture<SYMBOL_DTYPE>(reader, histogram_config(), threads);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "Binned " << histogram.total() << " symbols (" << histogram.outside() << " outside the grid) in " 
+              << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+    
+    const std::string title = file_io::get_order_name(static_cast<qam_order>(reader.get_header().modulation));
+    if (!histogram.save_and_plot(capture + ".hist", title)) {
+        throw std::runtime_error("Could not save the histogram of " + capture);
+    }
+}
+
+// whole decimal number in [min, max], std::invalid_argument / std::out_of_range otherwise
+uint64_t parse_number(const std::string& value, uint64_t min = 0, 
+                      uint64_t max = std::numeric_limits<uint64_t>::max()) {
+    uint64_t number = 0;
+    const char* end = value.data() + value.size();
+    const auto [ptr, ec] = std::from_chars(value.data(), end, number);
+    if (ec == std::errc::result_out_of_range || (ec == std::errc() && ptr == end && (number < min || number > max))) {
+        throw std::out_of_range("Value out of range: " + value);
+    }
+    if (ec != std::errc() || ptr != end) {
+        throw std::invalid_argument("Not a number: " + value);
+    }
+    return number;
+}
+
+qam_order parse_order(const std::string& value) {
+    const uint64_t order = parse_number(value);
+    if (order != 4 && order != 16 && order != 64) {
+        throw std::invalid_argument("Unsupported modulation order: " + value);
+    }
+    return static_cast<qam_order>(order);
+}
+
+void print_usage(const char* app) {
+    std::cout << "Usage: " << app << " [options]\n"
+              << "  (no options)        adaptive sweep, one thread per modulation\n"
+              << "  --jobs FILE         run the jobs of a job spec file (see jobs/ber_sweep.job)\n"
+              << "  --shards N          fixed grid, N local worker processes, merged at the end\n"
+              << "  --shard K/N         run shard K of N only and write its shard file\n"
+              << "  --merge N           merge the files of N shards\n"
+              << "  --shard-dir DIR     directory of shard files (default: .)\n"
+              << "  --seed S            payload and noise seed of sharded sweeps (default: 1)\n"
+              << "  --perf              hardware counters per point of the adaptive sweep (IPC, misses per symbol)\n"
+              << "  --pipeline          adaptive sweep with every chain stage on its own core\n"
+              << "  --replay FILE       demodulate a recorded IQ capture on all cores\n"
+              << "  --replay-out FILE   write the replayed bits to FILE (packed, MSB first)\n"
+              << "  --llr               replay through the LLR demodulator (header sigma, estimated if unknown)\n"
+              << "  --evm               measure EVM / MER / SNR of the replayed capture\n"
+              << "  --estimate M        blind noise estimate per chunk (dd or m2m4), used by --llr\n"
+              << "  --threads N         replay / histogram threads (default: all cores)\n"
+              << "  --histogram FILE    constellation heat map of an IQ capture (FILE.hist.bin / .pgm / .plt)\n"
+              << "  --modulate FILE     modulate a payload file of any size into an IQ file\n"
+              << "  --iq-out FILE       IQ file of --modulate (default: FILE.iq)\n"
+              << "  --order M           modulation of --modulate: 4, 16 or 64 (default: 16)\n";
+}
+
 int main(int argc, char* argv[]) { 
     /**
      * SIM Settings
      */
-    // {sigma_start, sigma_end, sigma_step}
-    const std::tuple<double,double,double> sigma = {0, 10, 0.05};
+    // adaptive sigma grid: coarse uniform pass, then refinement of the waterfall
+    adaptive_sweep::config sweep_cfg;
+    sweep_cfg.sigma_start   = 0;
+    sweep_cfg.sigma_end     = 10;
+    sweep_cfg.coarse_points = 21;
+    sweep_cfg.point_budget  = 64;
+    sweep_cfg.min_step      = 0.01;
 
     // modulations filename
     const std::string fnames[] = {
@@ -152,16 +337,187 @@ int main(int argc, char* argv[]) {
         "ber_sigma_qam64.csv"
     };
 
-    // monte-carlo iterations
-    const int iterations_per_modulations = 100000;
+    // monte-carlo frames: 50 frames of 1 Mbit per sigma point
+    engine_config engine_cfg;
+    engine_cfg.frame_bytes = 128 * 1024;
+    engine_cfg.tile_bytes  = 1536;
+    engine_cfg.seed        = static_cast<uint64_t>(std::time(nullptr));
+    
+    const size_t frames_per_point = 50;
+    
+    // checkpoint granularity inside a point
+    const size_t frames_per_save = 10;
+    
+    // sharded sweeps: fixed grid, (modulation, sigma, block) items spread over processes
+    shard_plan plan;
+    plan.modulations      = {std::begin(modulations), std::end(modulations)};
+    plan.blocks_per_point = 5;
+    plan.frames_per_block = frames_per_point / plan.blocks_per_point;
+    plan.engine           = engine_cfg;
+    plan.engine.seed      = 1;
+    for (double sigma = sweep_cfg.sigma_start; sigma <= sweep_cfg.sigma_end + 1e-9; sigma += 0.1) {
+        plan.sigmas.push_back(sigma);
+    }
+    
+    std::string shard_dir = ".";
+    std::string job_file;
+    int shard_index = -1;
+    bool launch = false;
+    bool merge = false;
+    bool perf = false;
+    bool pipelined = false;
+    std::string replay_file;
+    std::string replay_out;
+    replay_config replay_cfg;
+    std::string histogram_file;
+    std::string modulate_file;
+    std::string iq_out;
+    qam_order modulate_order = qam_order::QAM16;
+    
+    // malformed values print the usage instead of terminating
+    try {
+        for (int a = 1; a < argc; ++a) {
+            std::string arg = argv[a];
+            std::string value = (a + 1 < argc) ? argv[a + 1] : "";
+        
+            if (arg == "--jobs" && !value.empty()) {
+                job_file = value;
+                ++a;
+            } else if (arg == "--shards" && !value.empty()) {
+                plan.shard_count = static_cast<uint32_t>(parse_number(value, 1, std::numeric_limits<uint32_t>::max()));
+                launch = true;
+                ++a;
+            } else if (arg == "--shard" && value.find('/') != std::string::npos) {
+                plan.shard_count = static_cast<uint32_t>(parse_number(value.substr(value.find('/') + 1), 1, std::numeric_limits<uint32_t>::max()));
+                shard_index = static_cast<int>(parse_number(value.substr(0, value.find('/')), 0, plan.shard_count - 1));
+                ++a;
+            } else if (arg == "--merge" && !value.empty()) {
+                plan.shard_count = static_cast<uint32_t>(parse_number(value, 1, std::numeric_limits<uint32_t>::max()));
+                merge = true;
+                ++a;
+            } else if (arg == "--shard-dir" && !value.empty()) {
+                shard_dir = value;
+                ++a;
+            } else if (arg == "--perf") {
+                perf = true;
+            } else if (arg == "--pipeline") {
+                pipelined = true;
+            } else if (arg == "--replay" && !value.empty()) {
+                replay_file = value;
+                ++a;
+            } else if (arg == "--replay-out" && !value.empty()) {
+                replay_out = value;
+                ++a;
+            } else if (arg == "--llr") {
+                replay_cfg.llr = true;
+            } else if (arg == "--evm") {
+                replay_cfg.measure = true;
+            } else if (arg == "--estimate" && (value == "dd" || value == "m2m4")) {
+                replay_cfg.blind = true;
+                replay_cfg.estimator = value == "dd" ? noise_method::DECISION : noise_method::M2M4;
+                ++a;
+            } else if (arg == "--threads" && !value.empty()) {
+                replay_cfg.threads = parse_number(value);
+                ++a;
+            } else if (arg == "--histogram" && !value.empty()) {
+                histogram_file = value;
+                ++a;
+            } else if (arg == "--modulate" && !value.empty()) {
+                modulate_file = value;
+                ++a;
+            } else if (arg == "--iq-out" && !value.empty()) {
+                iq_out = value;
+                ++a;
+            } else if (arg == "--order" && !value.empty()) {
+                modulate_order = parse_order(value);
+                ++a;
+            } else if (arg == "--seed" && !value.empty()) {
+                plan.engine.seed = parse_number(value, 1);
+                ++a;
+            } else {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    try {
+        if (!replay_file.empty()) {
+            run_replay(replay_file, replay_out, replay_cfg);
+            return EXIT_SUCCESS;
+        }
+        
+        if (!histogram_file.empty()) {
+            run_histogram(histogram_file, replay_cfg.threads);
+            return EXIT_SUCCESS;
+        }
+        
+        if (!modulate_file.empty()) {
+            run_stream_modulate(modulate_file, iq_out.empty() ? modulate_file + ".iq" : iq_out, modulate_order);
+            return EXIT_SUCCESS;
+        }
+        
+        if (!job_file.empty()) {
+            job_batch batch = load_job_spec(job_file);
+            auto runner = batch_runner::make(batch.threads);
+            
+            // points of earlier batches are reused / topped up
+            std::unique_ptr<result_cache> cache;
+            if (!batch.cache.empty()) {
+                cache = std::make_unique<result_cache>(batch.cache);
+                cache->load();
+                runner->set_cache(cache.get());
+            }
+            
+            for (const auto& result : runner->run(batch.jobs)) {
+                save_job_result(result);
+                std::cout << "Job " << result.job.name << ": " << result.points.size() 
+                          << " points (" << result.simulated_frames << " frames simulated) saved to " 
+                          << result.job.output << std::endl;
+                
+                for (size_t i = 0; i < result.points.size(); ++i) {
+                    if (result.job.flag_sigma > 0 && std::fabs(result.deviation[i]) > result.job.flag_sigma) {
+                        std::cout << "  warning: sigma " << result.points[i].sigma << " BER " << result.points[i].ber()
+                                  << " deviates from theory " << result.theory_ber[i] << " by "
+                                  << result.deviation[i] << " std. deviations" << std::endl;
+                    }
+                }
+            }
+            
+            if (cache) {
+                cache->save();
+            }
+            return EXIT_SUCCESS;
+        }
+        
+        if (shard_index >= 0) {
+            run_shard<SYMBOL_DTYPE>(plan, static_cast<uint32_t>(shard_index), shard_file_name(shard_dir, shard_index));
+            std::cout << "Shard " << shard_index << "/" << plan.shard_count << " saved to " 
+                      << shard_file_name(shard_dir, shard_index) << std::endl;
+            return EXIT_SUCCESS;
+        }
+        
+        if (launch || merge) {
+            auto cells = launch ? launch_local_shards<SYMBOL_DTYPE>(plan, shard_dir) 
+                                : merge_shards(plan, shard_dir);
+            save_shard_cells(cells, fnames);
+            return EXIT_SUCCESS;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
     
     // Create threads for each modulation type
     std::vector<std::thread> threads;
     
     for (int i = 0; i < 3; ++i) {
-        threads.emplace_back(process_modulation, i, 
-                             std::get<0>(sigma), std::get<1>(sigma), std::get<2>(sigma),
-                             iterations_per_modulations, fnames[i]);
+        threads.emplace_back(process_modulation, i, sweep_cfg, engine_cfg,
+                             frames_per_point, frames_per_save, fnames[i], perf, pipelined);
     }
     
     for (auto& thread : threads) {
@@ -0,0 +1,559 @@
+#include "file/async_io.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+size_t round_up(size_t bytes) {
+    return (bytes + IO_ALIGN - 1) / IO_ALIGN * IO_ALIGN;
+}
+
+std::string error_text(int error) {
+    return std::string(" (") + std::strerror(error) + ")";
+}
+
+/**
+ * @brief Opens with O_DIRECT if requested and supported, buffered otherwise
+ */
+int open_file(const std::string& filename, int flags, bool direct) {
+    if (direct) {
+        const int fd = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+        // tmpfs and some overlay file systems refuse O_DIRECT
+        if (fd >= 0 || errno != EINVAL) {
+            return fd;
+        }
+    }
+    return ::open(filename.c_str(), flags, 0644);
+}
+
+/**
+ * @class uring_engine
+ * @brief io_uring through io_uring_setup / io_uring_enter and the mapped rings
+ */
+class uring_engine : public io_engine {
+public:
+    explicit uring_engine(size_t depth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_m = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(depth), &params));
+        if (ring_fd_m < 0) {
+            throw std::runtime_error("io_uring is not available" + error_text(errno));
+        }
+        probe();
+
+        sq_bytes_m = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_bytes_m = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            sq_bytes_m = cq_bytes_m = std::max(sq_bytes_m, cq_bytes_m);
+        }
+        sqe_bytes_m = params.sq_entries * sizeof(io_uring_sqe);
+
+        sq_map_m = map(sq_bytes_m, IORING_OFF_SQ_RING);
+        cq_map_m = single ? sq_map_m : map(cq_bytes_m, IORING_OFF_CQ_RING);
+        sqes_m = static_cast<io_uring_sqe*>(map(sqe_bytes_m, IORING_OFF_SQES));
+
+        byte* sq = static_cast<byte*>(sq_map_m);
+        sq_head_m = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+        sq_tail_m = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+        sq_mask_m = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sq_array_m = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        sq_entries_m = params.sq_entries;
+
+        byte* cq = static_cast<byte*>(cq_map_m);
+        cq_head_m = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+        cq_tail_m = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+        cq_mask_m = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+        cqes_m = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~uring_engine() override {
+        release();
+    }
+
+    void submit(const io_request& request) override {
+        const uint32_t tail = *sq_tail_m;
+        if (tail - std::atomic_ref<uint32_t>(*sq_head_m).load(std::memory_order_acquire) >= sq_entries_m) {
+            throw std::runtime_error("io_uring submission queue is full");
+        }
+
+        const uint32_t index = tail & sq_mask_m;
+        io_uring_sqe& sqe = sqes_m[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = request.fd;
+        sqe.addr = reinterpret_cast<uint64_t>(request.data);
+        sqe.len = static_cast<uint32_t>(request.bytes);
+        sqe.off = request.offset;
+        sqe.user_data = request.tag;
+        sq_array_m[index] = index;
+        std::atomic_ref<uint32_t>(*sq_tail_m).store(tail + 1, std::memory_order_release);
+
+        while (::syscall(__NR_io_uring_enter, ring_fd_m, 1u, 0u, 0u, nullptr, 0) < 0) {
+            if (errno != EINTR && errno != EAGAIN) {
+                throw std::runtime_error("io_uring_enter failed" + error_text(errno));
+            }
+        }
+    }
+
+    io_completion wait() override {
+        while (true) {
+            const uint32_t head = *cq_head_m;
+            if (head != std::atomic_ref<uint32_t>(*cq_tail_m).load(std::memory_order_acquire)) {
+                const io_uring_cqe& cqe = cqes_m[head & cq_mask_m];
+                const io_completion completion{cqe.user_data, cqe.res};
+                std::atomic_ref<uint32_t>(*cq_head_m).store(head + 1, std::memory_order_release);
+                return completion;
+            }
+            if (::syscall(__NR_io_uring_enter, ring_fd_m, 0u, 1u, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR) {
+                throw std::runtime_error("io_uring_enter failed" + error_text(errno));
+            }
+        }
+    }
+
+    io_backend get_backend() const override {
+        return io_backend::URING;
+    }
+
+private:
+    /**
+     * @brief Checks that the ring runs IORING_OP_READ and IORING_OP_WRITE
+     *        (Linux 5.6+; older kernels create the ring but fail every request)
+     */
+    void probe() {
+        constexpr unsigned OPS = 256;
+        std::vector<byte> storage(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op), 0);
+        auto* ops = reinterpret_cast<io_uring_probe*>(storage.data());
+        const bool probed = ::syscall(__NR_io_uring_register, ring_fd_m, IORING_REGISTER_PROBE, ops, OPS) >= 0;
+        const int error = probed ? EOPNOTSUPP : errno;    // the probe itself is 5.6+ too
+
+        auto supported = [ops](unsigned op) {
+            return op <= ops->last_op && (ops->ops[op].flags & IO_URING_OP_SUPPORTED);
+        };
+        if (!probed || !supported(IORING_OP_READ) || !supported(IORING_OP_WRITE)) {
+            release();
+            throw std::runtime_error("io_uring has no IORING_OP_READ / IORING_OP_WRITE" + error_text(error));
+        }
+    }
+
+    void* map(size_t bytes, uint64_t offset) {
+        void* ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_m,
+                           static_cast<off_t>(offset));
+        if (ptr == MAP_FAILED) {
+            const int error = errno;
+            release();
+            throw std::runtime_error("Could not map io_uring" + error_text(error));
+        }
+        return ptr;
+    }
+
+    void release() {
+        if (sqes_m) {
+            ::munmap(sqes_m, sqe_bytes_m);
+        }
+        if (cq_map_m && cq_map_m != sq_map_m) {
+            ::munmap(cq_map_m, cq_bytes_m);
+        }
+        if (sq_map_m) {
+            ::munmap(sq_map_m, sq_bytes_m);
+        }
+        ::close(ring_fd_m);
+        sqes_m = nullptr;
+        sq_map_m = cq_map_m = nullptr;
+        ring_fd_m = -1;
+    }
+
+    int             ring_fd_m = -1;
+    void*           sq_map_m = nullptr;
+    void*           cq_map_m = nullptr;
+    size_t          sq_bytes_m = 0;
+    size_t          cq_bytes_m = 0;
+    size_t          sqe_bytes_m = 0;
+    io_uring_sqe*   sqes_m = nullptr;
+    uint32_t*       sq_head_m = nullptr;
+    uint32_t*       sq_tail_m = nullptr;
+    uint32_t*       sq_array_m = nullptr;
+    uint32_t        sq_mask_m = 0;
+    uint32_t        sq_entries_m = 0;
+    uint32_t*       cq_head_m = nullptr;
+    uint32_t*       cq_tail_m = nullptr;
+    uint32_t        cq_mask_m = 0;
+    io_uring_cqe*   cqes_m = nullptr;
+};
+
+/**
+ * @class thread_engine
+ * @brief Portable engine: worker threads run pread / pwrite
+ */
+class thread_engine : public io_engine {
+public:
+    explicit thread_engine(size_t depth) {
+        for (size_t t = 0; t < depth; ++t) {
+            workers_m.emplace_back(&thread_engine::worker_loop, this);
+        }
+    }
+
+    ~thread_engine() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_m);
+            stop_m = true;
+        }
+        requests_cv_m.notify_all();
+        for (auto& worker : workers_m) {
+            worker.join();
+        }
+    }
+
+    void submit(const io_request& request) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_m);
+            requests_m.push_back(request);
+        }
+        requests_cv_m.notify_one();
+    }
+
+    io_completion wait() override {
+        std::unique_lock<std::mutex> lock(mutex_m);
+        completions_cv_m.wait(lock, [this]() { return !completions_m.empty(); });
+        const io_completion completion = completions_m.front();
+        completions_m.pop_front();
+        return completion;
+    }
+
+    io_backend get_backend() const override {
+        return io_backend::THREADS;
+    }
+
+private:
+    void worker_loop() {
+        while (true) {
+            io_request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_m);
+                requests_cv_m.wait(lock, [this]() { return stop_m || !requests_m.empty(); });
+                if (stop_m) {
+                    return;
+                }
+                request = requests_m.front();
+                requests_m.pop_front();
+            }
+
+            ssize_t result;
+            do {
+                result = request.write ? ::pwrite(request.fd, request.data, request.bytes, static_cast<off_t>(request.offset))
+                                       : ::pread(request.fd, request.data, request.bytes, static_cast<off_t>(request.offset));
+            } while (result < 0 && errno == EINTR);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_m);
+                completions_m.push_back({request.tag, result < 0 ? -static_cast<int64_t>(errno) : result});
+            }
+            completions_cv_m.notify_one();
+        }
+    }
+
+    std::vector<std::thread>    workers_m;
+    std::mutex                  mutex_m;
+    std::condition_variable     requests_cv_m;
+    std::condition_variable     completions_cv_m;
+    std::deque<io_request>      requests_m;
+    std::deque<io_completion>   completions_m;
+    bool                        stop_m = false;
+};
+
+} // namespace
+
+io_engine::ptr io_engine::make(io_backend backend, size_t depth) {
+    if (depth == 0) {
+        throw std::invalid_argument("queue depth must be > 0");
+    }
+    if (backend != io_backend::THREADS) {
+        try {
+            return std::make_unique<uring_engine>(depth);
+        } catch (const std::runtime_error&) {
+            // seccomp filters and old kernels refuse io_uring
+            if (backend == io_backend::URING) {
+                throw;
+            }
+        }
+    }
+    return std::make_unique<thread_engine>(depth);
+}
+
+void aligned_deleter::operator()(byte* data) const {
+    std::free(data);
+}
+
+aligned_buffer ext_alloc_aligned(size_t bytes) {
+    void* data = std::aligned_alloc(IO_ALIGN, round_up(std::max<size_t>(bytes, 1)));
+    if (!data) {
+        throw std::bad_alloc();
+    }
+    return aligned_buffer(static_cast<byte*>(data));
+}
+
+block_source::block_source(const std::string& filename, const async_io_config& cfg)
+    : filename_m(filename), block_bytes_m(round_up(std::max<size_t>(cfg.block_bytes, 1))) {
+    engine_m = io_engine::make(cfg.backend, cfg.queue_depth);
+
+    fd_m = open_file(filename, O_RDONLY, cfg.direct);
+    if (fd_m < 0) {
+        throw std::runtime_error("Could not open file: " + filename + error_text(errno));
+    }
+    struct stat info;
+    if (::fstat(fd_m, &info) != 0) {
+        ::close(fd_m);
+        throw std::runtime_error("Could not stat file: " + filename + error_text(errno));
+    }
+    size_m = static_cast<uint64_t>(info.st_size);
+
+    for (size_t slot = 0; slot < cfg.queue_depth; ++slot) {
+        buffers_m.push_back(ext_alloc_aligned(block_bytes_m));
+    }
+    slot_block_m.assign(cfg.queue_depth, 0);
+    slot_filled_m.assign(cfg.queue_depth, 0);
+    slot_done_m.assign(cfg.queue_depth, false);
+    for (size_t slot = 0; slot < cfg.queue_depth; ++slot) {
+        submit(slot);
+    }
+}
+
+block_source::ptr block_source::make(const std::string& filename, const async_io_config& cfg) {
+    return std::make_unique<block_source>(filename, cfg);
+}
+
+block_source::~block_source() {
+    try {
+        while (in_flight_m > 0) {
+            engine_m->wait();
+            --in_flight_m;
+        }
+    } catch (...) {
+        // the engine is gone with the buffers, nothing else to clean up
+    }
+    ::close(fd_m);
+}
+
+size_t block_source::block_size(uint64_t block) const {
+    return static_cast<size_t>(std::min<uint64_t>(block_bytes_m, size_m - block * block_bytes_m));
+}
+
+void block_source::submit(size_t slot) {
+    const uint64_t block = next_submit_m;
+    if (block * block_bytes_m >= size_m) {
+        return;
+    }
+
+    slot_block_m[slot] = block;
+    slot_filled_m[slot] = 0;
+    slot_done_m[slot] = false;
+    ++next_submit_m;
+    read(slot);
+}
+
+void block_source::read(size_t slot) {
+    const uint64_t block = slot_block_m[slot];
+    const size_t filled = slot_filled_m[slot];
+
+    io_request request;
+    request.fd = fd_m;
+    request.data = buffers_m[slot].get() + filled;
+    // O_DIRECT lengths are aligned, the kernel stops at the end of the file
+    request.bytes = round_up(block_size(block)) - filled;
+    request.offset = block * block_bytes_m + filled;
+    request.tag = slot;
+    engine_m->submit(request);
+    ++in_flight_m;
+}
+
+std::span<const byte> block_source::next() {
+    const size_t depth = buffers_m.size();
+    if (held_m) {
+        // the consumer is done with the previous block, its slot loads the next one
+        held_m = false;
+        submit((next_emit_m - 1) % depth);
+    }
+    if (next_emit_m * block_bytes_m >= size_m) {
+        return {};
+    }
+
+    const size_t slot = next_emit_m % depth;
+    while (!slot_done_m[slot]) {
+        const io_completion completion = engine_m->wait();
+        --in_flight_m;
+        const size_t done = static_cast<size_t>(completion.tag);
+        if (completion.result < 0) {
+            throw std::runtime_error("Failed to read file: " + filename_m + error_text(static_cast<int>(-completion.result)));
+        }
+        if (completion.result == 0) {
+            throw std::runtime_error("Unexpected end of file: " + filename_m);
+        }
+
+        // reads may return early (signals, memory pressure): the slot reads the rest
+        slot_filled_m[done] += static_cast<size_t>(completion.result);
+        if (slot_filled_m[done] < block_size(slot_block_m[done])) {
+            read(done);
+            continue;
+        }
+        slot_done_m[done] = true;
+    }
+
+    const size_t bytes = block_size(next_emit_m);
+    ++next_emit_m;
+    held_m = true;
+    return std::span<const byte>(buffers_m[slot].get(), bytes);
+}
+
+block_sink::block_sink(const std::string& filename, const async_io_config& cfg)
+    : filename_m(filename), block_bytes_m(round_up(std::max<size_t>(cfg.block_bytes, 1))) {
+    engine_m = io_engine::make(cfg.backend, cfg.queue_depth);
+
+    fd_m = open_file(filename, O_WRONLY | O_CREAT | O_TRUNC, cfg.direct);
+    if (fd_m < 0) {
+        throw std::runtime_error("Could not create file: " + filename + error_text(errno));
+    }
+
+    for (size_t slot = 0; slot < cfg.queue_depth; ++slot) {
+        buffers_m.push_back(ext_alloc_aligned(block_bytes_m));
+        free_m.push_back(cfg.queue_depth - 1 - slot);
+    }
+}
+
+block_sink::ptr block_sink::make(const std::string& filename, const async_io_config& cfg) {
+    return std::make_unique<block_sink>(filename, cfg);
+}
+
+block_sink::~block_sink() {
+    try {
+        close();
+    } catch (...) {
+        // destructors do not throw, close() explicitly to see the error
+        while (in_flight_m > 0) {
+            try {
+                engine_m->wait();
+            } catch (...) {
+                break;
+            }
+            --in_flight_m;
+        }
+        if (fd_m >= 0) {
+            ::close(fd_m);
+        }
+    }
+}
+
+void block_sink::reap() {
+    const io_completion completion = engine_m->wait();
+    --in_flight_m;
+    const size_t slot = static_cast<size_t>(completion.tag >> 32);
+    const size_t bytes = static_cast<size_t>(completion.tag & 0xffffffffu);
+    free_m.push_back(slot);
+    if (completion.result < 0) {
+        throw std::runtime_error("Failed to write file: " + filename_m + error_text(static_cast<int>(-completion.result)));
+    }
+    if (static_cast<size_t>(completion.result) != bytes) {
+        throw std::runtime_error("Short write to file: " + filename_m);
+    }
+}
+
+std::span<byte> block_sink::acquire() {
+    if (fd_m < 0) {
+        throw std::runtime_error("File is closed: " + filename_m);
+    }
+    if (acquired_m < 0) {
+        while (free_m.empty()) {
+            reap();
+        }
+        acquired_m = static_cast<long>(free_m.back());
+        free_m.pop_back();
+    }
+    return std::span<byte>(buffers_m[static_cast<size_t>(acquired_m)].get(), block_bytes_m);
+}
+
+void block_sink::commit(size_t bytes) {
+    if (acquired_m < 0) {
+        throw std::logic_error("commit() without acquire()");
+    }
+    if (short_m) {
+        throw std::logic_error("Only the last block may be short");
+    }
+    if (bytes > block_bytes_m) {
+        throw std::out_of_range("commit() of more than a block");
+    }
+
+    const size_t slot = static_cast<size_t>(acquired_m);
+    acquired_m = -1;
+    staged_m = 0;
+    if (bytes == 0) {
+        free_m.push_back(slot);
+        return;
+    }
+
+    // a short last block is written padded and cut by close()
+    io_request request;
+    request.write = true;
+    request.fd = fd_m;
+    request.data = buffers_m[slot].get();
+    request.bytes = round_up(bytes);
+    request.offset = offset_m;
+    request.tag = (static_cast<uint64_t>(slot) << 32) | request.bytes;
+    engine_m->submit(request);
+    ++in_flight_m;
+
+    offset_m += bytes;
+    short_m = bytes < block_bytes_m;
+}
+
+void block_sink::write(std::span<const byte> data) {
+    while (!data.empty()) {
+        std::span<byte> block = acquire();
+        const size_t count = std::min(data.size(), block_bytes_m - staged_m);
+        std::copy_n(data.begin(), count, block.begin() + staged_m);
+        staged_m += count;
+        data = data.subspan(count);
+
+        if (staged_m == block_bytes_m) {
+            commit(block_bytes_m);
+        }
+    }
+}
+
+void block_sink::close() {
+    if (fd_m < 0) {
+        return;
+    }
+    if (acquired_m >= 0) {
+        commit(staged_m);
+    }
+    while (in_flight_m > 0) {
+        reap();
+    }
+
+    const int fd = fd_m;
+    fd_m = -1;
+    if (::ftruncate(fd, static_cast<off_t>(offset_m)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to truncate file: " + filename_m + error_text(error));
+    }
+    if (::close(fd) != 0) {
+        throw std::runtime_error("Failed to close file: " + filename_m + error_text(errno));
+    }
+}
@@ -1 +0,0 @@
-#include "file/csv_writer.hpp"
\ No newline at end of file
@@ -1,10 +1,90 @@
 #include "file/file.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <vector>
 #include "types/complex.hpp"
 
 namespace file_io {
 
+namespace {
+
+// bytes formatted before one write(), plus room for the record that crosses the mark
+constexpr size_t EXPORT_BUFFER_BYTES = 1 << 20;
+constexpr size_t EXPORT_RECORD_BYTES = 256;
+
+/**
+ * @class export_buffer
+ * @brief Formats records into a large buffer and writes it in one piece
+ *
+ * Values are formatted with std::to_chars in the notation of operator<<
+ * (general, 6 significant digits), so dumps look as before but skip the
+ * locale machinery and the per-line flush of std::endl.
+ */
+class export_buffer {
+public:
+    explicit export_buffer(std::ofstream& file)
+        : file_m(file), buffer_m(EXPORT_BUFFER_BYTES + EXPORT_RECORD_BYTES) {
+    }
+
+    void put(double value) {
+        used_m = std::to_chars(cursor(), end(), value, std::chars_format::general, 6).ptr - buffer_m.data();
+    }
+
+    void put(float value) {
+        used_m = std::to_chars(cursor(), end(), value, std::chars_format::general, 6).ptr - buffer_m.data();
+    }
+
+    void put(size_t value) {
+        used_m = std::to_chars(cursor(), end(), value).ptr - buffer_m.data();
+    }
+
+    void put(char c) {
+        buffer_m[used_m++] = c;
+    }
+
+    void put_raw(float value) {
+        std::memcpy(cursor(), &value, sizeof(value));
+        used_m += sizeof(value);
+    }
+
+    void put_raw(uint64_t value) {
+        std::memcpy(cursor(), &value, sizeof(value));
+        used_m += sizeof(value);
+    }
+
+    /**
+     * @brief Ends a record, writes the buffer once it is full
+     */
+    void end_record() {
+        if (used_m >= EXPORT_BUFFER_BYTES) {
+            flush();
+        }
+    }
+
+    void flush() {
+        file_m.write(buffer_m.data(), static_cast<std::streamsize>(used_m));
+        used_m = 0;
+    }
+
+private:
+    char* cursor() {
+        return buffer_m.data() + used_m;
+    }
+
+    char* end() {
+        return buffer_m.data() + buffer_m.size();
+    }
+
+    std::ofstream&      file_m;
+    std::vector<char>   buffer_m;
+    size_t              used_m = 0;
+};
+
+} // namespace
+
 std::string get_order_name(qam_order order) {
     switch (order) {
         case qam_order::QPSK: return "QPSK";
@@ -37,16 +117,22 @@ bool save_constellation_to_file(
         
         const auto& constellation = mapper->get_constellation();
         
+        export_buffer out(file);
         for (const auto& [index, symbol] : constellation) {
             if (include_indices) {
-                file << index << " " << symbol.i << " " << symbol.q << std::endl;
-            } else {
-                file << symbol.i << " " << symbol.q << std::endl;
+                out.put(static_cast<size_t>(index));
+                out.put(' ');
             }
+            out.put(symbol.i);
+            out.put(' ');
+            out.put(symbol.q);
+            out.put('\n');
+            out.end_record();
         }
+        out.flush();
         
         file.close();
-        return true;
+        return static_cast<bool>(file);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return false;
@@ -132,34 +218,58 @@ template<typename DTYPE>
 bool save_modulated_symbols_to_file(
     const complex<DTYPE>& symbols,
     const std::string& filename,
-    bool include_indices
+    bool include_indices,
+    const export_options& options
 ) {
     try {
-        std::ofstream file(filename);
+        if (options.decimation == 0) {
+            std::cerr << "Error: decimation must be > 0" << std::endl;
+            return false;
+        }
+        
+        std::ofstream file(filename, options.binary ? std::ios::out | std::ios::binary : std::ios::out);
         if (!file.is_open()) {
             std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
             return false;
         }
         
-        file << "# Modulated Symbols" << std::endl;
-        file << "# Format: ";
-        if (include_indices) {
-            file << "index i q" << std::endl;
-        } else {
-            file << "i q" << std::endl;
-        }
+        export_buffer out(file);
+        auto [in_i, in_q] = symbols.decompose();
         
-        for (size_t i = 0; i < symbols.size() / 2; ++i) {
-            auto symbol = symbols[i];
-            if (include_indices) {
-                file << i << " " << symbol.i << " " << symbol.q << std::endl;
-            } else {
-                file << symbol.i << " " << symbol.q << std::endl;
+        if (options.binary) {
+            // records of [uint64 index] float32 i, q, read with binary format='[%uint64]%float%float'
+            // (a float index is exact only up to 2^24)
+            for (size_t i = 0; i < symbols.size() / 2; i += options.decimation) {
+                if (include_indices) {
+                    out.put_raw(static_cast<uint64_t>(i));
+                }
+                out.put_raw(static_cast<float>(in_i[i]));
+                out.put_raw(static_cast<float>(in_q[i]));
+                out.end_record();
+            }
+        } else {
+            file << "# Modulated Symbols" << "\n";
+            if (options.decimation > 1) {
+                file << "# Decimation: every " << options.decimation << " symbols" << "\n";
+            }
+            file << "# Format: " << (include_indices ? "index i q" : "i q") << "\n";
+            
+            for (size_t i = 0; i < symbols.size() / 2; i += options.decimation) {
+                if (include_indices) {
+                    out.put(i);
+                    out.put(' ');
+                }
+                out.put(in_i[i]);
+                out.put(' ');
+                out.put(in_q[i]);
+                out.put('\n');
+                out.end_record();
             }
         }
+        out.flush();
         
         file.close();
-        return true;
+        return static_cast<bool>(file);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return false;
@@ -170,7 +280,8 @@ bool create_modulated_gnuplot_script(
     const std::string& data_filename,
     const std::string& script_filename,
     const std::string& title,
-    bool include_indices
+    bool include_indices,
+    const export_options& options
 ) {
     try {
         std::ofstream file(script_filename);
@@ -193,7 +304,12 @@ bool create_modulated_gnuplot_script(
         file << "# Настройки точек\n";
         file << "set style line 1 lc rgb '#FF4500' pt 7 ps 1.5\n\n";
         
-        if (include_indices) {
+        if (options.binary) {
+            // labels of millions of points are unreadable, the index column is skipped
+            file << "# Отображение точек из бинарного файла\n";
+            file << "plot '" << data_filename << "' binary format='" << (include_indices ? "%uint64%float%float" : "%float%float")
+                 << "' using " << (include_indices ? "2:3" : "1:2") << " with points ls 1 title '" << title << " modulated symbols'\n";
+        } else if (include_indices) {
             file << "# Отображение точек с индексами\n";
             file << "plot '" << data_filename << "' using 2:3:1 with points ls 1 title '" << title << " modulated symbols', \\\n";
             file << "     '" << data_filename << "' using 2:3:1 with labels offset 0.5,0.5 title ''\n";
@@ -216,22 +332,66 @@ bool create_modulated_gnuplot_script(
     }
 }
 
+bool create_histogram_gnuplot_script(
+    const std::string& data_filename,
+    const std::string& script_filename,
+    const std::string& title,
+    double limit
+) {
+    try {
+        std::ofstream file(script_filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file " << script_filename << " for writing" << std::endl;
+            return false;
+        }
+        
+        file << "set terminal wxt enhanced font 'Arial,12' size 800,700 persist\n\n";
+        
+        file << "# Настройки графика\n";
+        file << "set title '" << title << " Constellation Histogram'\n";
+        file << "set xlabel 'In-phase (I)'\n";
+        file << "set ylabel 'Quadrature (Q)'\n";
+        file << "set size square\n";
+        file << "set xrange [" << -limit << ":" << limit << "]\n";
+        file << "set yrange [" << -limit << ":" << limit << "]\n\n";
+        
+        file << "# Логарифмическая шкала плотности, пустые ячейки не рисуются\n";
+        file << "set logscale cb\n";
+        file << "set cblabel 'symbols per bin'\n";
+        file << "set palette defined (0 'white', 1 '#0060ad', 2 '#FF4500', 3 'yellow')\n\n";
+        
+        file << "plot '" << data_filename << "' binary matrix with image title ''\n";
+        file << "pause -1 'Press ENTER for close'\n";
+        
+        file.close();
+        
+        std::cout << "Gnuplot script created: " << script_filename << std::endl;
+        std::cout << "To run the script, use: gnuplot " << script_filename << std::endl;
+        
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 template<typename DTYPE>
 bool save_and_plot_modulated_symbols(
     const complex<DTYPE>& symbols,
     const std::string& base_filename,
     const std::string& title,
-    bool include_indices
+    bool include_indices,
+    const export_options& options
 ) {
-    std::string data_filename = base_filename + ".dat";
+    std::string data_filename = base_filename + (options.binary ? ".bin" : ".dat");
     std::string script_filename = base_filename + ".plt";
     
-    bool data_saved = save_modulated_symbols_to_file(symbols, data_filename, include_indices);
+    bool data_saved = save_modulated_symbols_to_file(symbols, data_filename, include_indices, options);
     if (!data_saved) {
         return false;
     }
     
-    bool script_created = create_modulated_gnuplot_script(data_filename, script_filename, title, include_indices);
+    bool script_created = create_modulated_gnuplot_script(data_filename, script_filename, title, include_indices, options);
     return script_created;
 }
 
@@ -0,0 +1,322 @@
+#include "file/iq_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string sigmf_datatype(iq_dtype dtype) {
+    return dtype == iq_dtype::FLOAT32 ? "cf32_le" : "cf64_le";
+}
+
+} // namespace
+
+template<typename DTYPE>
+iq_writer<DTYPE>::iq_writer(const std::string& filename, const iq_metadata& meta)
+    : filename_m(filename), meta_m(meta) {
+    if (meta_m.block_samples == 0) {
+        throw std::invalid_argument("block_samples must be > 0");
+    }
+    if (meta_m.sigmf && meta_m.layout != iq_layout::INTERLEAVED) {
+        throw std::invalid_argument("SigMF sidecars describe interleaved files only");
+    }
+
+    header_m.dtype = ext_iq_dtype<DTYPE>();
+    header_m.layout = meta_m.layout;
+    header_m.block_samples = meta_m.block_samples;
+    header_m.modulation = static_cast<uint32_t>(meta_m.modulation);
+    header_m.sample_rate = meta_m.sample_rate;
+    header_m.sigma = meta_m.sigma;
+    header_m.payload_offset = IQ_PAYLOAD_OFFSET;
+
+    fd_m = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_m < 0) {
+        throw std::runtime_error("Could not create IQ file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+
+    std::vector<char> header(IQ_PAYLOAD_OFFSET, 0);
+    std::memcpy(header.data(), &header_m, sizeof(header_m));
+    write_all(header.data(), header.size(), 0);
+
+    block_m.resize(meta_m.block_samples * 2);
+}
+
+template<typename DTYPE>
+typename iq_writer<DTYPE>::ptr iq_writer<DTYPE>::make(const std::string& filename, const iq_metadata& meta) {
+    return std::make_unique<iq_writer>(filename, meta);
+}
+
+template<typename DTYPE>
+iq_writer<DTYPE>::~iq_writer() {
+    try {
+        close();
+    } catch (...) {
+        // destructors do not throw, close() explicitly to see the error
+    }
+}
+
+template<typename DTYPE>
+void iq_writer<DTYPE>::append(std::span<const DTYPE> i, std::span<const DTYPE> q) {
+    if (fd_m < 0) {
+        throw std::runtime_error("IQ file is closed: " + filename_m);
+    }
+    if (i.size() != q.size()) {
+        throw std::invalid_argument("I and Q must have the same size");
+    }
+
+    const size_t block = meta_m.block_samples;
+    size_t done = 0;
+    while (done < i.size()) {
+        const size_t count = std::min(block - staged_m, i.size() - done);
+        if (meta_m.layout == iq_layout::PLANAR) {
+            std::copy_n(i.begin() + done, count, block_m.begin() + staged_m);
+            std::copy_n(q.begin() + done, count, block_m.begin() + block + staged_m);
+        } else {
+            DTYPE* out = block_m.data() + staged_m * 2;
+            for (size_t s = 0; s < count; ++s) {
+                out[2 * s] = i[done + s];
+                out[2 * s + 1] = q[done + s];
+            }
+        }
+        staged_m += count;
+        done += count;
+
+        if (staged_m == block) {
+            write_block();
+        }
+    }
+}
+
+template<typename DTYPE>
+void iq_writer<DTYPE>::append(const complex<DTYPE>& symbols, size_t count) {
+    if (count > symbols.size() / 2) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    auto [i, q] = symbols.decompose();
+    append(i.first(count), q.first(count));
+}
+
+template<typename DTYPE>
+void iq_writer<DTYPE>::write_block() {
+    if (staged_m == 0) {
+        return;
+    }
+
+    const size_t bytes = staged_m * sizeof(DTYPE);
+    if (meta_m.layout == iq_layout::PLANAR) {
+        // a short last block keeps [I | Q] contiguous
+        write_all(block_m.data(), bytes, offset_m);
+        write_all(block_m.data() + meta_m.block_samples, bytes, offset_m + bytes);
+    } else {
+        write_all(block_m.data(), 2 * bytes, offset_m);
+    }
+
+    offset_m += 2 * bytes;
+    header_m.sample_count += staged_m;
+    staged_m = 0;
+}
+
+template<typename DTYPE>
+void iq_writer<DTYPE>::write_all(const void* data, size_t bytes, uint64_t offset) {
+    const char* ptr = static_cast<const char*>(data);
+    while (bytes > 0) {
+        const ssize_t written = ::pwrite(fd_m, ptr, bytes, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write IQ file: " + filename_m + " (" + std::strerror(errno) + ")");
+        }
+        ptr += written;
+        offset += static_cast<uint64_t>(written);
+        bytes -= static_cast<size_t>(written);
+    }
+}
+
+template<typename DTYPE>
+void iq_writer<DTYPE>::close() {
+    if (fd_m < 0) {
+        return;
+    }
+
+    try {
+        write_block();
+        write_all(&header_m, sizeof(header_m), 0);
+        if (meta_m.sigmf) {
+            write_sigmf();
+        }
+    } catch (...) {
+        ::close(fd_m);
+        fd_m = -1;
+        throw;
+    }
+
+    if (::close(fd_m) != 0) {
+        fd_m = -1;
+        throw std::runtime_error("Failed to close IQ file: " + filename_m);
+    }
+    fd_m = -1;
+}
+
+template<typename DTYPE>
+void iq_writer<DTYPE>::write_sigmf() const {
+    const std::string meta_name = filename_m + ".sigmf-meta";
+    std::ofstream file(meta_name);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not create SigMF sidecar: " + meta_name);
+    }
+
+    // non-conforming dataset: the samples follow our header in the data file
+    const std::string dataset = filename_m.substr(filename_m.find_last_of('/') + 1);
+    file << "{\n"
+         << "  \"global\": {\n"
+         << "    \"core:datatype\": \"" << sigmf_datatype(header_m.dtype) << "\",\n"
+         << "    \"core:version\": \"1.0.0\",\n"
+         << "    \"core:dataset\": \"" << dataset << "\"";
+    if (header_m.sample_rate > 0) {
+        file << ",\n    \"core:sample_rate\": " << header_m.sample_rate;
+    }
+    file << "\n  },\n"
+         << "  \"captures\": [\n"
+         << "    {\"core:sample_start\": 0, \"core:header_bytes\": " << header_m.payload_offset << "}\n"
+         << "  ],\n"
+         << "  \"annotations\": []\n"
+         << "}\n";
+    if (!file) {
+        throw std::runtime_error("Failed to write SigMF sidecar: " + meta_name);
+    }
+}
+
+template<typename DTYPE>
+iq_reader<DTYPE>::iq_reader(const std::string& filename) {
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open IQ file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(iq_header)) {
+        ::close(fd);
+        throw std::runtime_error("Not an IQ file: " + filename);
+    }
+    map_bytes_m = static_cast<size_t>(info.st_size);
+
+    void* map = ::mmap(nullptr, map_bytes_m, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("Could not map IQ file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+    map_m = static_cast<const byte*>(map);
+    ::madvise(map, map_bytes_m, MADV_SEQUENTIAL);
+
+    std::memcpy(&header_m, map_m, sizeof(header_m));
+    const iq_header reference;
+    std::string error;
+    if (std::memcmp(header_m.magic, reference.magic, sizeof(reference.magic)) != 0) {
+        error = "Not an IQ file: ";
+    } else if (header_m.version != reference.version) {
+        error = "Unsupported IQ file version: ";
+    } else if (header_m.dtype != ext_iq_dtype<DTYPE>()) {
+        error = "IQ file has another sample type: ";
+    } else if (header_m.block_samples == 0 || header_m.payload_offset < sizeof(iq_header) ||
+               header_m.payload_offset % alignof(DTYPE) != 0) {
+        error = "Corrupt IQ file header: ";
+    } else if (header_m.payload_offset > map_bytes_m ||
+               header_m.sample_count > (map_bytes_m - header_m.payload_offset) / (2 * sizeof(DTYPE))) {
+        // no products or sums of header fields: a corrupt header must not wrap around
+        error = "Truncated IQ file: ";
+    }
+
+    if (!error.empty()) {
+        ::munmap(const_cast<byte*>(map_m), map_bytes_m);
+        throw std::runtime_error(error + filename);
+    }
+}
+
+template<typename DTYPE>
+typename iq_reader<DTYPE>::ptr iq_reader<DTYPE>::make(const std::string& filename) {
+    return std::make_unique<iq_reader>(filename);
+}
+
+template<typename DTYPE>
+iq_reader<DTYPE>::~iq_reader() {
+    if (map_m) {
+        ::munmap(const_cast<byte*>(map_m), map_bytes_m);
+    }
+}
+
+template<typename DTYPE>
+size_t iq_reader<DTYPE>::block_count() const {
+    return (header_m.sample_count + header_m.block_samples - 1) / header_m.block_samples;
+}
+
+template<typename DTYPE>
+const DTYPE* iq_reader<DTYPE>::block_data(size_t index) const {
+    // every block but the last is full, so blocks sit at fixed offsets
+    const size_t offset = header_m.payload_offset + index * header_m.block_samples * 2 * sizeof(DTYPE);
+    return reinterpret_cast<const DTYPE*>(map_m + offset);
+}
+
+template<typename DTYPE>
+iq_view<DTYPE> iq_reader<DTYPE>::block(size_t index) const {
+    if (index >= block_count()) {
+        throw std::out_of_range("IQ block index out of range");
+    }
+
+    iq_view<DTYPE> view;
+    view.first = index * header_m.block_samples;
+    view.count = std::min<size_t>(header_m.block_samples, header_m.sample_count - view.first);
+
+    const DTYPE* data = block_data(index);
+    if (header_m.layout == iq_layout::PLANAR) {
+        view.i = std::span<const DTYPE>(data, view.count);
+        view.q = std::span<const DTYPE>(data + view.count, view.count);
+    } else {
+        view.interleaved = std::span<const DTYPE>(data, view.count * 2);
+    }
+    return view;
+}
+
+template<typename DTYPE>
+void iq_reader<DTYPE>::read(size_t first, size_t count, complex<DTYPE>& out) const {
+    if (first + count > size() || count > out.size() / 2) {
+        throw std::out_of_range("IQ read range out of range");
+    }
+
+    auto [out_i, out_q] = out.decompose();
+    size_t done = 0;
+    while (done < count) {
+        const size_t sample = first + done;
+        const iq_view<DTYPE> view = block(sample / header_m.block_samples);
+        const size_t offset = sample - view.first;
+        const size_t n = std::min(view.count - offset, count - done);
+
+        if (header_m.layout == iq_layout::PLANAR) {
+            std::copy_n(view.i.begin() + offset, n, out_i.begin() + done);
+            std::copy_n(view.q.begin() + offset, n, out_q.begin() + done);
+        } else {
+            const DTYPE* in = view.interleaved.data() + offset * 2;
+            for (size_t s = 0; s < n; ++s) {
+                out_i[done + s] = in[2 * s];
+                out_q[done + s] = in[2 * s + 1];
+            }
+        }
+        done += n;
+    }
+}
+
+template<typename DTYPE>
+std::span<const byte> iq_reader<DTYPE>::payload() const {
+    return std::span<const byte>(map_m + header_m.payload_offset, header_m.sample_count * 2 * sizeof(DTYPE));
+}
+
+SIM_TEMPLATES(iq_writer)
+SIM_TEMPLATES(iq_reader)
@@ -0,0 +1,293 @@
+#include "file/result_writer.hpp"
+
+#include <array>
+#include <charconv>
+#include <stdexcept>
+
+#include "file/binary_io.hpp"
+
+namespace {
+
+constexpr const char* KIND = "result";
+constexpr char MAGIC[4] = {'Y', 'Q', 'R', 'W'};
+constexpr uint32_t VERSION = 1;
+
+// longest fixed-notation double: 309 integer digits, sign, point and the precision
+constexpr int MAX_PRECISION = 64;
+constexpr size_t MAX_FIELD = 384;
+
+template<typename T>
+void append_value(std::vector<char>& buffer, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+} // namespace
+
+result_writer::result_writer(const std::string& filename, std::vector<result_column> columns,
+                             result_format format, const result_writer_config& cfg)
+    : columns_m(std::move(columns)), format_m(format), cfg_m(cfg) {
+    if (columns_m.empty()) {
+        throw std::invalid_argument("result_writer needs at least one column");
+    }
+    for (const auto& column : columns_m) {
+        if (column.precision < 0 || column.precision > MAX_PRECISION) {
+            throw std::invalid_argument("Column precision must be in [0, 64]: " + column.name);
+        }
+    }
+    if (cfg_m.buffer_bytes == 0) {
+        throw std::invalid_argument("buffer_bytes must be > 0");
+    }
+
+    file_m.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file_m.is_open()) {
+        throw std::runtime_error("Could not open result file: " + filename);
+    }
+
+    active_m.reserve(cfg_m.buffer_bytes + columns_m.size() * MAX_FIELD);
+    write_header();
+
+    if (cfg_m.background) {
+        thread_m = std::thread(&result_writer::writer_loop, this);
+    }
+}
+
+result_writer::ptr result_writer::make(const std::string& filename, std::vector<result_column> columns,
+                                       result_format format, const result_writer_config& cfg) {
+    return std::make_unique<result_writer>(filename, std::move(columns), format, cfg);
+}
+
+result_writer::~result_writer() {
+    try {
+        close();
+    } catch (...) {
+        // destructors do not throw, close() explicitly to see the error
+    }
+}
+
+void result_writer::write_header() {
+    if (format_m == result_format::CSV) {
+        for (size_t c = 0; c < columns_m.size(); ++c) {
+            if (c) {
+                active_m.push_back(',');
+            }
+            active_m.insert(active_m.end(), columns_m[c].name.begin(), columns_m[c].name.end());
+        }
+        active_m.push_back('\n');
+        return;
+    }
+
+    active_m.insert(active_m.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    append_value(active_m, VERSION);
+    append_value(active_m, static_cast<uint32_t>(columns_m.size()));
+    for (const auto& column : columns_m) {
+        append_value(active_m, static_cast<uint32_t>(column.name.size()));
+        active_m.insert(active_m.end(), column.name.begin(), column.name.end());
+    }
+}
+
+void result_writer::push(std::span<const double> values) {
+    if (closed_m) {
+        throw std::runtime_error("result_writer is closed");
+    }
+    if (values.size() != columns_m.size()) {
+        throw std::invalid_argument("Record has " + std::to_string(values.size()) + " values, expected " +
+                                    std::to_string(columns_m.size()));
+    }
+    rethrow();
+
+    if (format_m == result_format::CSV) {
+        append_csv(values);
+    } else {
+        const char* bytes = reinterpret_cast<const char*>(values.data());
+        active_m.insert(active_m.end(), bytes, bytes + values.size_bytes());
+    }
+    records_m++;
+
+    if (active_m.size() >= cfg_m.buffer_bytes) {
+        submit();
+    }
+}
+
+void result_writer::append_csv(std::span<const double> values) {
+    std::array<char, MAX_FIELD> field;
+
+    for (size_t c = 0; c < values.size(); ++c) {
+        const result_column& column = columns_m[c];
+        const auto notation = column.scientific ? std::chars_format::scientific : std::chars_format::fixed;
+        const auto [end, ec] = std::to_chars(field.data(), field.data() + field.size(), values[c], notation, column.precision);
+        if (ec != std::errc()) {
+            throw std::runtime_error("Could not format value of column " + column.name);
+        }
+
+        if (c) {
+            active_m.push_back(',');
+        }
+        active_m.insert(active_m.end(), field.data(), end);
+    }
+    active_m.push_back('\n');
+}
+
+void result_writer::submit() {
+    if (active_m.empty()) {
+        return;
+    }
+
+    if (!cfg_m.background) {
+        write_buffer(active_m);
+        active_m.clear();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_m);
+        // at most one buffer in flight: a slow disk throttles the producer
+        cv_m.wait(lock, [this]() { return !has_pending_m; });
+        pending_m.swap(active_m);
+        active_m.swap(spare_m);
+        has_pending_m = true;
+    }
+    cv_m.notify_all();
+
+    active_m.clear();
+    active_m.reserve(cfg_m.buffer_bytes + columns_m.size() * MAX_FIELD);
+}
+
+void result_writer::write_buffer(const std::vector<char>& buffer) {
+    file_m.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file_m) {
+        throw std::runtime_error("Failed to write result file");
+    }
+}
+
+void result_writer::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_m);
+    while (true) {
+        cv_m.wait(lock, [this]() { return has_pending_m || stop_m; });
+        if (!has_pending_m) {
+            return;
+        }
+
+        std::vector<char> buffer;
+        buffer.swap(pending_m);
+        lock.unlock();
+
+        std::exception_ptr failure;
+        try {
+            write_buffer(buffer);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        lock.lock();
+        if (failure && !error_m) {
+            error_m = failure;
+        }
+        buffer.clear();
+        spare_m.swap(buffer);
+        has_pending_m = false;
+        cv_m.notify_all();
+    }
+}
+
+void result_writer::rethrow() {
+    std::lock_guard<std::mutex> lock(mutex_m);
+    if (error_m) {
+        std::rethrow_exception(error_m);
+    }
+}
+
+void result_writer::flush() {
+    if (closed_m) {
+        return;
+    }
+    submit();
+
+    std::unique_lock<std::mutex> lock(mutex_m);
+    cv_m.wait(lock, [this]() { return !has_pending_m; });
+    if (error_m) {
+        std::rethrow_exception(error_m);
+    }
+    file_m.flush();
+    if (!file_m) {
+        throw std::runtime_error("Failed to flush result file");
+    }
+}
+
+void result_writer::close() {
+    if (closed_m) {
+        return;
+    }
+
+    std::exception_ptr failure;
+    try {
+        flush();
+    } catch (...) {
+        failure = std::current_exception();
+    }
+
+    if (thread_m.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_m);
+            stop_m = true;
+        }
+        cv_m.notify_all();
+        thread_m.join();
+    }
+    file_m.close();
+    closed_m = true;
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+result_table result_writer::load_binary(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open result file: " + filename);
+    }
+
+    if (!ext_read_magic(file, MAGIC)) {
+        throw std::runtime_error("Not a binary result file: " + filename);
+    }
+
+    uint32_t version = 0;
+    uint32_t count = 0;
+    ext_read_value(file, version, KIND);
+    ext_read_value(file, count, KIND);
+    if (version != VERSION) {
+        throw std::runtime_error("Unsupported result file version: " + std::to_string(version));
+    }
+    if (count == 0) {
+        throw std::runtime_error("Result file without columns: " + filename);
+    }
+
+    result_table table;
+    for (uint32_t c = 0; c < count; ++c) {
+        uint32_t length = 0;
+        ext_read_value(file, length, KIND);
+        std::string name(length, '\0');
+        file.read(name.data(), length);
+        if (!file) {
+            throw std::runtime_error("Truncated result file");
+        }
+        table.columns.push_back(std::move(name));
+    }
+
+    const std::streampos data_start = file.tellg();
+    file.seekg(0, std::ios::end);
+    const size_t data_bytes = static_cast<size_t>(file.tellg() - data_start);
+    const size_t record_bytes = count * sizeof(double);
+    if (data_bytes % record_bytes) {
+        throw std::runtime_error("Truncated result file");
+    }
+
+    table.values.resize(data_bytes / sizeof(double));
+    file.seekg(data_start);
+    file.read(reinterpret_cast<char*>(table.values.data()), static_cast<std::streamsize>(data_bytes));
+    if (!file) {
+        throw std::runtime_error("Truncated result file");
+    }
+    return table;
+}
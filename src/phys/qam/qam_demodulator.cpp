@@ -1,4 +1,5 @@
 #include "phys/qam/qam_demodulator.hpp"
+#include "phys/qam/slicer.hpp"
 
 #include <stdexcept>
 #include <cmath>
@@ -17,6 +18,14 @@ void qam_demodulator<DTYPE>::set_mapper(std::shared_ptr<mapper_base> mapper_ptr)
     if (!mapper_ptr) {
         throw std::invalid_argument("Mapper cannot be null");
     }
+    update_table();
+}
+
+template<typename DTYPE>
+void qam_demodulator<DTYPE>::update_table() {
+    if (mapper_m) {
+        slicer_m.emplace(ext_make_table<DTYPE>(mapper_m, unit_energy_m));
+    }
 }
 
 template<typename DTYPE>
@@ -67,12 +76,52 @@ std::vector<byte> qam_demodulator<DTYPE>::demodulate(const complex<DTYPE>& symbo
 }
 
 template<typename DTYPE>
-std::vector<byte> qam_demodulator<DTYPE>::demodulate_llr(const complex<DTYPE>& symbols, const channel<DTYPE>& channel) {
+void qam_demodulator<DTYPE>::demodulate(const complex<DTYPE>& symbols, size_t count, std::span<byte> bits) {
     if (!mapper_m) {
         throw std::runtime_error("Mapper not set");
     }
     
-    DTYPE sigma = channel.get_quality();
+    const uint32_t bits_per_symbol = mapper_m->get_bits_per_symbol();
+    
+    if (count > symbols.size() / 2) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    
+    auto [in_i, in_q] = symbols.decompose();
+    const qam_slicer<DTYPE>& slicer = *slicer_m;
+    
+    // bit accumulator, MSB first (same layout as write_bits)
+    uint64_t acc = 0;
+    uint32_t acc_bits = 0;
+    size_t byte_pos = 0;
+    
+    for (size_t i = 0; i < count && byte_pos < bits.size(); i++) {
+        uint32_t nearest_index = slicer.slice(in_i[i], in_q[i]);
+        
+        acc = (acc << bits_per_symbol) | nearest_index;
+        acc_bits += bits_per_symbol;
+        
+        while (acc_bits >= 8 && byte_pos < bits.size()) {
+            bits[byte_pos++] = static_cast<byte>(acc >> (acc_bits - 8));
+            acc_bits -= 8;
+        }
+    }
+    
+    if (acc_bits > 0 && byte_pos < bits.size()) {
+        bits[byte_pos] = static_cast<byte>(acc << (8 - acc_bits));
+    }
+}
+
+template<typename DTYPE>
+std::vector<byte> qam_demodulator<DTYPE>::demodulate_llr(const complex<DTYPE>& symbols, const channel<DTYPE>& channel) {
+    return demodulate_llr(symbols, channel.get_quality());
+}
+
+template<typename DTYPE>
+std::vector<byte> qam_demodulator<DTYPE>::demodulate_llr(const complex<DTYPE>& symbols, DTYPE sigma) {
+    if (!mapper_m) {
+        throw std::runtime_error("Mapper not set");
+    }
     
     qam_order order = mapper_m->get_order();
     uint32_t bits_per_symbol = mapper_m->get_bits_per_symbol();
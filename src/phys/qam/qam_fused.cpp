@@ -0,0 +1,51 @@
+#include "phys/qam/qam_fused.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+template<typename DTYPE, qam_order ORDER>
+qam_fused_kernel<DTYPE, ORDER>::qam_fused_kernel(const qam_mapper<DTYPE, ORDER>& mapper, bool unit_energy) 
+    : table_m(ext_make_table(mapper, unit_energy)), slicer_m(table_m) {}
+
+template<typename DTYPE, qam_order ORDER>
+uint64_t qam_fused_kernel<DTYPE, ORDER>::run(std::span<const byte> bits, channel<DTYPE>& chan, std::span<uint64_t> bit_errors) {
+    if ((bits.size() * 8) % BITS_PER_SYMBOL != 0) {
+        throw std::invalid_argument("bit block must hold a whole number of symbols");
+    }
+    if (!bit_errors.empty() && bit_errors.size() < BITS_PER_SYMBOL) {
+        throw std::invalid_argument("bit_errors must hold BITS_PER_SYMBOL counters");
+    }
+
+    constexpr uint32_t symbol_mask = (1u << BITS_PER_SYMBOL) - 1;
+    const complex_t<DTYPE>* lut = table_m.lut.data();
+    const size_t num_symbols = bits.size() * 8 / BITS_PER_SYMBOL;
+    const bool per_position = !bit_errors.empty();
+
+    uint64_t errors = 0;
+    uint64_t acc = 0;
+    uint32_t acc_bits = 0;
+    size_t byte_pos = 0;
+
+    for (size_t s = 0; s < num_symbols; s++) {
+        if (acc_bits < BITS_PER_SYMBOL) {
+            acc = (acc << 8) | bits[byte_pos++];
+            acc_bits += 8;
+        }
+
+        const uint32_t bit_group = static_cast<uint32_t>(acc >> (acc_bits - BITS_PER_SYMBOL)) & symbol_mask;
+        acc_bits -= BITS_PER_SYMBOL;
+
+        const complex_t<DTYPE> noisy = chan.transmit(lut[bit_group]);
+        const uint32_t diff = (bit_group ^ slicer_m.slice(noisy.i, noisy.q)) & symbol_mask;
+
+        errors += std::popcount(diff);
+
+        if (per_position && diff) {
+            for (uint32_t b = 0; b < BITS_PER_SYMBOL; b++) {
+                bit_errors[b] += (diff >> (BITS_PER_SYMBOL - 1 - b)) & 0x1;
+            }
+        }
+    }
+
+    return errors;
+}
@@ -13,6 +13,14 @@ void qam_modulator<DTYPE>::set_mapper(std::shared_ptr<mapper_base> mapper_ptr) {
     if (!mapper_ptr) {
         throw std::invalid_argument("Mapper cannot be null");
     }
+    update_table();
+}
+
+template<typename DTYPE>
+void qam_modulator<DTYPE>::update_table() {
+    if (mapper_m) {
+        table_m = ext_make_table<DTYPE>(mapper_m, unit_energy_m);
+    }
 }
 
 template<typename DTYPE>
@@ -64,6 +72,47 @@ complex<DTYPE> qam_modulator<DTYPE>::modulate(const std::vector<byte>& bits) {
     return symbols;
 }
 
+template<typename DTYPE>
+size_t qam_modulator<DTYPE>::modulate(std::span<const byte> bits, complex<DTYPE>& symbols) {
+    if (!mapper_m) {
+        throw std::runtime_error("Mapper not set");
+    }
+    
+    const qam_table<DTYPE>& table = table_m;
+    const uint32_t bits_per_symbol = mapper_m->get_bits_per_symbol();
+    const uint32_t symbol_mask = static_cast<uint32_t>(table.lut.size() - 1);
+    
+    size_t num_symbols = (bits.size() * 8 + bits_per_symbol - 1) / bits_per_symbol;
+    if (num_symbols > symbols.size() / 2) {
+        throw std::out_of_range("symbol container is too small for the bit block");
+    }
+    
+    auto [out_i, out_q] = symbols.decompose();
+    
+    // bit accumulator, MSB first (same grouping as extract_bits)
+    uint64_t acc = 0;
+    uint32_t acc_bits = 0;
+    size_t byte_pos = 0;
+    
+    for (size_t i = 0; i < num_symbols; i++) {
+        while (acc_bits < bits_per_symbol && byte_pos < bits.size()) {
+            acc = (acc << 8) | bits[byte_pos++];
+            acc_bits += 8;
+        }
+        
+        // the last group may be incomplete: it is taken as a shorter number
+        uint32_t take = acc_bits < bits_per_symbol ? acc_bits : bits_per_symbol;
+        uint32_t bit_group = static_cast<uint32_t>(acc >> (acc_bits - take)) & ((1u << take) - 1);
+        acc_bits -= take;
+        
+        const complex_t<DTYPE>& point = table.lut[bit_group & symbol_mask];
+        out_i[i] = point.i;
+        out_q[i] = point.q;
+    }
+    
+    return num_symbols;
+}
+
 template<typename DTYPE>
 uint32_t qam_modulator<DTYPE>::extract_bits(const std::vector<byte>& bits, size_t start_bit, size_t num_bits) {
     uint32_t result = 0;
@@ -0,0 +1,173 @@
+#include "sim/bit_source.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// separates the noise sequences from the payload sequences of the same (seed, stream)
+constexpr uint64_t GAUSSIAN_DOMAIN = 0x6A09E667F3BCC909ULL;
+
+// 128-layer ziggurat of Marsaglia & Tsang, tables as in Doornik's ZIGNOR
+constexpr double ZIGGURAT_TAIL = 3.442619855899;          // Start of the tail
+constexpr double ZIGGURAT_AREA = 9.91256303526217e-3;     // Area of every layer
+
+std::array<double, gaussian_source::LAYERS + 1> make_edges() {
+    std::array<double, gaussian_source::LAYERS + 1> edge{};
+    double f = std::exp(-0.5 * ZIGGURAT_TAIL * ZIGGURAT_TAIL);
+    edge[0] = ZIGGURAT_AREA / f;    // base layer: rectangle plus tail
+    edge[1] = ZIGGURAT_TAIL;
+    for (size_t i = 2; i < gaussian_source::LAYERS; ++i) {
+        edge[i] = std::sqrt(-2.0 * std::log(ZIGGURAT_AREA / edge[i - 1] + f));
+        f = std::exp(-0.5 * edge[i] * edge[i]);
+    }
+    edge[gaussian_source::LAYERS] = 0.0;
+    return edge;
+}
+
+std::array<double, gaussian_source::LAYERS> make_ratios(const std::array<double, gaussian_source::LAYERS + 1>& edge) {
+    std::array<double, gaussian_source::LAYERS> ratio{};
+    for (size_t i = 0; i < gaussian_source::LAYERS; ++i) {
+        ratio[i] = edge[i + 1] / edge[i];
+    }
+    return ratio;
+}
+
+// MSB-first byte from 8 bits stored oldest-in-bit-0
+byte reverse_bits(uint64_t bits) {
+    uint32_t b = static_cast<uint32_t>(bits & 0xFF);
+    b = ((b & 0xF0) >> 4) | ((b & 0x0F) << 4);
+    b = ((b & 0xCC) >> 2) | ((b & 0x33) << 2);
+    b = ((b & 0xAA) >> 1) | ((b & 0x55) << 1);
+    return static_cast<byte>(b);
+}
+
+} // namespace
+
+/**
+ * random_bit_source
+ */
+
+random_bit_source::random_bit_source(uint64_t seed, uint64_t stream) {
+    uint64_t x = seed ^ (stream * 0xD1342543DE82EF95ULL);
+    splitmix64(x);
+    for (auto& word : state_m) {
+        word = splitmix64(x);
+    }
+}
+
+random_bit_source::ptr random_bit_source::make(uint64_t seed, uint64_t stream) {
+    return std::make_unique<random_bit_source>(seed, stream);
+}
+
+void random_bit_source::fill(std::span<byte> bits) {
+    byte* out = bits.data();
+    size_t i = 0;
+
+    for (; i + 4 * sizeof(uint64_t) <= bits.size(); i += 4 * sizeof(uint64_t)) {
+        const uint64_t words[4] = {next_word(), next_word(), next_word(), next_word()};
+        std::memcpy(out + i, words, sizeof(words));
+    }
+
+    for (; i + sizeof(uint64_t) <= bits.size(); i += sizeof(uint64_t)) {
+        const uint64_t word = next_word();
+        std::memcpy(out + i, &word, sizeof(word));
+    }
+
+    if (i < bits.size()) {
+        const uint64_t word = next_word();
+        std::memcpy(out + i, &word, bits.size() - i);
+    }
+}
+
+void random_bit_source::set_state(const state_type& state, uint64_t position) {
+    if (state[0] == 0 && state[1] == 0 && state[2] == 0 && state[3] == 0) {
+        throw std::invalid_argument("xoshiro state cannot be all zero");
+    }
+    state_m = state;
+    words_m = position;
+}
+
+/**
+ * gaussian_source
+ */
+
+const std::array<double, gaussian_source::LAYERS + 1> gaussian_source::edge_m = make_edges();
+const std::array<double, gaussian_source::LAYERS> gaussian_source::ratio_m = make_ratios(gaussian_source::edge_m);
+
+gaussian_source::gaussian_source(uint64_t seed, uint64_t stream) : words_m(seed ^ GAUSSIAN_DOMAIN, stream) {}
+
+bool gaussian_source::next_outside(size_t layer, double u, double& x) {
+    // uniform in (0, 1), safe for log()
+    auto open_unit = [this]() {
+        return (static_cast<double>(words_m.next_word() >> 11) + 0.5) * 0x1.0p-53;
+    };
+
+    if (layer == 0) {
+        double t = 0.0;
+        double y = 0.0;
+        do {
+            t = std::log(open_unit()) / ZIGGURAT_TAIL;
+            y = std::log(open_unit());
+        } while (-2.0 * y < t * t);
+        x = u < 0 ? t - ZIGGURAT_TAIL : ZIGGURAT_TAIL - t;
+        return true;
+    }
+
+    x = u * edge_m[layer];
+    const double f0 = std::exp(-0.5 * (edge_m[layer] * edge_m[layer] - x * x));
+    const double f1 = std::exp(-0.5 * (edge_m[layer + 1] * edge_m[layer + 1] - x * x));
+    return f1 + to_unit(words_m.next_word()) * (f0 - f1) < 1.0;
+}
+
+/**
+ * prbs_bit_source
+ */
+
+prbs_bit_source::prbs_bit_source(prbs_type type, uint32_t seed) : degree_m(static_cast<uint32_t>(type)) {
+    switch (type) {
+        case prbs_type::PRBS7:  tap_m = 6;  break;
+        case prbs_type::PRBS15: tap_m = 14; break;
+        case prbs_type::PRBS23: tap_m = 18; break;
+        case prbs_type::PRBS31: tap_m = 28; break;
+        default:
+            throw std::invalid_argument("Unsupported PRBS type");
+    }
+
+    register_m = seed & ((uint64_t(1) << degree_m) - 1);
+    if (register_m == 0) {
+        throw std::invalid_argument("PRBS seed cannot be zero");
+    }
+}
+
+prbs_bit_source::ptr prbs_bit_source::make(prbs_type type, uint32_t seed) {
+    return std::make_unique<prbs_bit_source>(type, seed);
+}
+
+void prbs_bit_source::fill(std::span<byte> bits) {
+    const uint64_t register_mask = (uint64_t(1) << degree_m) - 1;
+    const uint64_t chunk_mask = (uint64_t(1) << tap_m) - 1;
+
+    for (auto& out : bits) {
+        while (pending_bits_m < 8) {
+            // b[t + i] = b[t + i - n] ^ b[t + i - k], i < k
+            const uint64_t chunk = (register_m ^ (register_m >> (degree_m - tap_m))) & chunk_mask;
+            register_m = ((register_m >> tap_m) | (chunk << (degree_m - tap_m))) & register_mask;
+
+            pending_m |= chunk << pending_bits_m;
+            pending_bits_m += tap_m;
+        }
+
+        out = reverse_bits(pending_m);
+        pending_m >>= 8;
+        pending_bits_m -= 8;
+    }
+}
@@ -0,0 +1,171 @@
+#include "sim/checkpoint.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "file/binary_io.hpp"
+#include "sim/hash.hpp"
+
+namespace {
+
+constexpr const char* KIND = "checkpoint";
+constexpr char MAGIC[4] = {'Y', 'Q', 'C', 'K'};
+
+} // namespace
+
+sweep_checkpoint::sweep_checkpoint(const std::string& filename, uint64_t config_hash, std::chrono::seconds interval) 
+    : filename_m(filename), config_hash_m(config_hash), interval_m(interval), 
+      last_save_m(std::chrono::steady_clock::now()) {}
+
+bool sweep_checkpoint::load() {
+    std::ifstream file(filename_m, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    if (!ext_read_magic(file, MAGIC)) {
+        throw std::runtime_error("Not a checkpoint file: " + filename_m);
+    }
+
+    uint32_t version = 0;
+    ext_read_value(file, version, KIND);
+    if (version != VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version in " + filename_m);
+    }
+
+    uint64_t config_hash = 0;
+    ext_read_value(file, config_hash, KIND);
+    if (config_hash != config_hash_m) {
+        throw std::runtime_error("Checkpoint " + filename_m + " was written with other settings");
+    }
+
+    uint64_t count = 0;
+    ext_read_value(file, count, KIND);
+
+    records_m.clear();
+    for (uint64_t n = 0; n < count; ++n) {
+        checkpoint_record record;
+        ext_read_value(file, record.point.sigma, KIND);
+        ext_read_value(file, record.point.bits, KIND);
+        ext_read_value(file, record.point.errors, KIND);
+        ext_read_value(file, record.point.frames, KIND);
+        for (auto& word : record.rng_state) {
+            ext_read_value(file, word, KIND);
+        }
+        ext_read_value(file, record.rng_position, KIND);
+        for (auto& word : record.noise_state) {
+            ext_read_value(file, word, KIND);
+        }
+        ext_read_value(file, record.noise_position, KIND);
+
+        records_m[record.point.sigma] = record;
+    }
+
+    return true;
+}
+
+void sweep_checkpoint::save() {
+    ext_replace_file(filename_m, [this](std::ofstream& file) {
+        file.write(MAGIC, sizeof(MAGIC));
+        ext_write_value(file, VERSION);
+        ext_write_value(file, config_hash_m);
+        ext_write_value(file, static_cast<uint64_t>(records_m.size()));
+
+        for (const auto& [sigma, record] : records_m) {
+            ext_write_value(file, record.point.sigma);
+            ext_write_value(file, record.point.bits);
+            ext_write_value(file, record.point.errors);
+            ext_write_value(file, record.point.frames);
+            for (auto word : record.rng_state) {
+                ext_write_value(file, word);
+            }
+            ext_write_value(file, record.rng_position);
+            for (auto word : record.noise_state) {
+                ext_write_value(file, word);
+            }
+            ext_write_value(file, record.noise_position);
+        }
+    }, KIND);
+
+    last_save_m = std::chrono::steady_clock::now();
+}
+
+void sweep_checkpoint::remove() {
+    records_m.clear();
+    if (std::remove(filename_m.c_str()) != 0 && errno != ENOENT) {
+        throw std::runtime_error("Could not remove checkpoint file: " + filename_m);
+    }
+}
+
+std::optional<checkpoint_record> sweep_checkpoint::find(double sigma) const {
+    auto it = records_m.find(sigma);
+    if (it == records_m.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void sweep_checkpoint::update(const checkpoint_record& record, bool completed) {
+    records_m[record.point.sigma] = record;
+
+    if (completed || std::chrono::steady_clock::now() - last_save_m >= interval_m) {
+        save();
+    }
+}
+
+template<typename DTYPE>
+uint64_t ext_checkpoint_hash(const sim_engine<DTYPE>& engine) {
+    const engine_config& cfg = engine.get_config();
+    uint64_t h = FNV1A_BASIS;
+    h = fnv1a(h, engine.get_bits_per_symbol());
+    h = fnv1a(h, static_cast<uint32_t>(sizeof(DTYPE)));
+    h = fnv1a(h, static_cast<uint64_t>(cfg.frame_bytes));
+    h = fnv1a(h, static_cast<uint64_t>(cfg.tile_bytes));
+    h = fnv1a(h, static_cast<uint32_t>(cfg.unit_energy));
+    h = fnv1a(h, static_cast<uint32_t>(cfg.fused));
+    return h;
+}
+
+template<typename DTYPE>
+ber_point resume_point(sim_engine<DTYPE>& engine, sweep_checkpoint& checkpoint, 
+                       double sigma, uint64_t frames, uint64_t frames_per_save) {
+    if (frames_per_save == 0) {
+        throw std::invalid_argument("frames_per_save must be > 0");
+    }
+
+    random_bit_source& source = engine.get_bit_source();
+    random_bit_source& noise_source = engine.get_noise_source().get_bit_source();
+
+    checkpoint_record record;
+    record.point.sigma = sigma;
+
+    if (auto saved = checkpoint.find(sigma)) {
+        record = *saved;
+        if (record.point.frames >= frames) {
+            return record.point;
+        }
+        source.set_state(record.rng_state, record.rng_position);
+        noise_source.set_state(record.noise_state, record.noise_position);
+    }
+
+    while (record.point.frames < frames) {
+        uint64_t chunk = std::min(frames_per_save, frames - record.point.frames);
+        record.point.merge(engine.run(sigma, chunk));
+        record.rng_state = source.get_state();
+        record.rng_position = source.get_position();
+        record.noise_state = noise_source.get_state();
+        record.noise_position = noise_source.get_position();
+
+        checkpoint.update(record, record.point.frames >= frames);
+    }
+
+    return record.point;
+}
+
+template uint64_t ext_checkpoint_hash<float>(const sim_engine<float>&);
+template uint64_t ext_checkpoint_hash<double>(const sim_engine<double>&);
+template ber_point resume_point<float>(sim_engine<float>&, sweep_checkpoint&, double, uint64_t, uint64_t);
+template ber_point resume_point<double>(sim_engine<double>&, sweep_checkpoint&, double, uint64_t, uint64_t);
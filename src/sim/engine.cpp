@@ -0,0 +1,182 @@
+#include "sim/engine.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// whole symbols for 2, 4 and 6 bits per symbol
+constexpr size_t TILE_ALIGN_BYTES = 3;
+
+// a random seed is drawn once, payload and noise streams share it
+uint64_t resolve_seed(engine_config& cfg) {
+    if (cfg.seed == 0) {
+        cfg.seed = std::random_device{}();
+    }
+    return cfg.seed;
+}
+
+template<typename DTYPE, qam_order ORDER>
+typename sim_engine<DTYPE>::fused_kernel make_fused(const std::shared_ptr<mapper_base>& mapper, bool unit_energy) {
+    auto typed = std::dynamic_pointer_cast<qam_mapper<DTYPE, ORDER>>(mapper);
+    if (!typed) {
+        throw std::runtime_error("Failed to cast mapper to the fused kernel type");
+    }
+
+    auto kernel = std::make_shared<qam_fused_kernel<DTYPE, ORDER>>(*typed, unit_energy);
+    return [kernel](std::span<const byte> bits, channel<DTYPE>& chan, std::span<uint64_t> bit_errors) {
+        return kernel->run(bits, chan, bit_errors);
+    };
+}
+
+} // namespace
+
+template<typename DTYPE>
+sim_engine<DTYPE>::sim_engine(std::shared_ptr<mapper_base> mapper, const engine_config& cfg) 
+    : cfg_m(cfg), 
+      counter_m(mapper ? mapper->get_bits_per_symbol() : 1),
+      source_m(resolve_seed(cfg_m), cfg.stream) {
+    if (cfg_m.frame_bytes < TILE_ALIGN_BYTES) {
+        throw std::invalid_argument("frame_bytes must be >= 3");
+    }
+    if (cfg_m.tile_bytes < TILE_ALIGN_BYTES) {
+        throw std::invalid_argument("tile_bytes must be >= 3");
+    }
+
+    // no padded symbol at the end of a frame: its bits could not be recovered
+    cfg_m.frame_bytes -= cfg_m.frame_bytes % TILE_ALIGN_BYTES;
+    cfg_m.tile_bytes -= cfg_m.tile_bytes % TILE_ALIGN_BYTES;
+    if (cfg_m.tile_bytes > cfg_m.frame_bytes) {
+        cfg_m.tile_bytes = cfg_m.frame_bytes;
+    }
+
+    modulator_m.set_mapper(mapper);
+    demodulator_m.set_mapper(mapper);
+    modulator_m.set_unit_energy(cfg_m.unit_energy);
+    demodulator_m.set_unit_energy(cfg_m.unit_energy);
+
+    symbol_energy_m = cfg_m.unit_energy ? 1.0 : mapper->get_symbol_energy();
+    channel_m.set_channel_response_model(noise<DTYPE>(0.0, cfg_m.seed, cfg_m.stream));
+    channel_m.set_signal_energy(symbol_energy_m);
+
+    tx_bits_m.resize(cfg_m.tile_bytes);
+
+    if (cfg_m.fused) {
+        switch (mapper->get_order()) {
+            case qam_order::QPSK:   fused_m = make_fused<DTYPE, qam_order::QPSK>(mapper, cfg_m.unit_energy);  break;
+            case qam_order::QAM16:  fused_m = make_fused<DTYPE, qam_order::QAM16>(mapper, cfg_m.unit_energy); break;
+            case qam_order::QAM64:  fused_m = make_fused<DTYPE, qam_order::QAM64>(mapper, cfg_m.unit_energy); break;
+            default:
+                throw std::invalid_argument("Unsupported modulation order");
+        }
+    } else {
+        const size_t max_symbols = (cfg_m.tile_bytes * 8 + 1) / 2;
+        rx_bits_m.resize(cfg_m.tile_bytes);
+        symbols_m = complex<DTYPE>::make(max_symbols * 2);
+        if (cfg_m.measure_quality) {
+            meter_m = std::make_unique<evm_meter<DTYPE>>(mapper, cfg_m.unit_energy);
+        }
+    }
+
+    generator_m = [this](std::span<byte> bits) {
+        source_m.fill(bits);
+    };
+}
+
+template<typename DTYPE>
+typename sim_engine<DTYPE>::ptr sim_engine<DTYPE>::make(std::shared_ptr<mapper_base> mapper, const engine_config& cfg) {
+    return std::make_unique<sim_engine>(mapper, cfg);
+}
+
+template<typename DTYPE>
+void sim_engine<DTYPE>::set_bit_generator(bit_generator generator) {
+    if (!generator) {
+        throw std::invalid_argument("Bit generator cannot be null");
+    }
+    generator_m = std::move(generator);
+}
+
+template<typename DTYPE>
+void sim_engine<DTYPE>::reseed(uint64_t seed, uint64_t stream) {
+    source_m = random_bit_source(seed, stream);
+    channel_m.set_seed(seed, stream);
+}
+
+template<typename DTYPE>
+void sim_engine<DTYPE>::reset_stats() {
+    counter_m.reset();
+    if (meter_m) {
+        meter_m->reset();
+    }
+}
+
+template<typename DTYPE>
+ber_point sim_engine<DTYPE>::run(double sigma, size_t frames) {
+    channel_m.set_sigma(sigma);
+
+    ber_point point;
+    point.sigma = sigma;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (size_t offset = 0; offset < cfg_m.frame_bytes; offset += cfg_m.tile_bytes) {
+            size_t tile_bytes = std::min(cfg_m.tile_bytes, cfg_m.frame_bytes - offset);
+            point.errors += run_tile(tile_bytes);
+        }
+        point.bits += cfg_m.frame_bytes * 8;
+        point.frames++;
+    }
+
+    counter_m.flush();
+
+    profile_m.total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    profile_m.bits += point.bits;
+    profile_m.symbols += point.bits / counter_m.get_bits_per_symbol();
+    return point;
+}
+
+template<typename DTYPE>
+uint64_t sim_engine<DTYPE>::run_tile(size_t tile_bytes) {
+    std::span<byte> tx_bits(tx_bits_m.data(), tile_bytes);
+
+    {
+        SIM_TIME_STAGE(profile_m, sim_stage::GENERATE);
+        generator_m(tx_bits);
+    }
+
+    if (fused_m) {
+        // per-position counts stay in the kernel's loop, no decisions are written
+        std::array<uint64_t, error_stats::MAX_BITS_PER_SYMBOL> position_errors{};
+        SIM_TIME_STAGE(profile_m, sim_stage::FUSED);
+        const uint64_t errors = fused_m(tx_bits, channel_m, position_errors);
+        counter_m.add_counts(tile_bytes * 8, position_errors);
+        return errors;
+    }
+
+    std::span<byte> rx_bits(rx_bits_m.data(), tile_bytes);
+    size_t count = 0;
+    {
+        SIM_TIME_STAGE(profile_m, sim_stage::MODULATE);
+        count = modulator_m.modulate(std::span<const byte>(tx_bits), symbols_m);
+    }
+    {
+        SIM_TIME_STAGE(profile_m, sim_stage::TRANSMIT);
+        channel_m.transmit(symbols_m, symbols_m, count);
+    }
+    {
+        SIM_TIME_STAGE(profile_m, sim_stage::DEMODULATE);
+        demodulator_m.demodulate(symbols_m, count, rx_bits);
+    }
+
+    SIM_TIME_STAGE(profile_m, sim_stage::COUNT);
+    const uint64_t errors_before = counter_m.get_stats().errors;
+    counter_m.accumulate(tx_bits, rx_bits);
+    if (meter_m) {
+        meter_m->accumulate(symbols_m, count, tx_bits);
+    }
+    return counter_m.get_stats().errors - errors_before;
+}
@@ -0,0 +1,158 @@
+#include "sim/error_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+void error_stats::merge(const error_stats& other) {
+    bits            += other.bits;
+    errors          += other.errors;
+    symbols         += other.symbols;
+    symbol_errors   += other.symbol_errors;
+    bursts          += other.bursts;
+    max_burst        = std::max(max_burst, other.max_burst);
+
+    for (size_t i = 0; i < bit_position_errors.size(); ++i) {
+        bit_position_errors[i] += other.bit_position_errors[i];
+    }
+    for (size_t i = 0; i < burst_histogram.size(); ++i) {
+        burst_histogram[i] += other.burst_histogram[i];
+    }
+}
+
+error_counter::error_counter(uint32_t bits_per_symbol) : bits_per_symbol_m(bits_per_symbol) {
+    // divisors of the chunk only: a symbol must not straddle two chunks
+    if (bits_per_symbol == 0 || bits_per_symbol > error_stats::MAX_BITS_PER_SYMBOL || 
+        CHUNK_BITS % bits_per_symbol != 0) {
+        throw std::invalid_argument("bits_per_symbol must be 1, 2, 3, 4 or 6");
+    }
+
+    // chunk bit j (stream order) lives at word bit 63 - j
+    for (uint32_t j = 0; j < CHUNK_BITS; ++j) {
+        const uint64_t bit = uint64_t(1) << (63 - j);
+        position_masks_m[j % bits_per_symbol] |= bit;
+    }
+    symbol_start_mask_m = position_masks_m[0];
+}
+
+void error_counter::accumulate(std::span<const byte> tx, std::span<const byte> rx) {
+    if (tx.size() != rx.size()) {
+        throw std::invalid_argument("tx and rx blocks must have the same size");
+    }
+    if ((tx.size() * 8) % bits_per_symbol_m != 0) {
+        throw std::invalid_argument("block must hold a whole number of symbols");
+    }
+
+    constexpr size_t chunk_bytes = CHUNK_BITS / 8;
+    const size_t length = tx.size();
+    size_t i = 0;
+
+    constexpr uint64_t chunk_mask = ~uint64_t(0) << (64 - CHUNK_BITS);
+
+    // 8-byte XOR, the top 48 bits (stream order) form the chunk
+    for (; i + sizeof(uint64_t) <= length; i += chunk_bytes) {
+        uint64_t a, b;
+        std::memcpy(&a, tx.data() + i, sizeof(a));
+        std::memcpy(&b, rx.data() + i, sizeof(b));
+
+        uint64_t diff = a ^ b;
+        if constexpr (std::endian::native == std::endian::little) {
+            diff = __builtin_bswap64(diff);
+        }
+        accumulate_chunk(diff & chunk_mask, CHUNK_BITS);
+    }
+
+    for (; i + chunk_bytes <= length; i += chunk_bytes) {
+        uint64_t diff = 0;
+        for (size_t b = 0; b < chunk_bytes; ++b) {
+            diff = (diff << 8) | static_cast<byte>(tx[i + b] ^ rx[i + b]);
+        }
+        accumulate_chunk(diff << (64 - CHUNK_BITS), CHUNK_BITS);
+    }
+
+    if (i < length) {
+        uint64_t diff = 0;
+        const size_t tail = length - i;
+        for (size_t b = 0; b < tail; ++b) {
+            diff = (diff << 8) | static_cast<byte>(tx[i + b] ^ rx[i + b]);
+        }
+        accumulate_chunk(diff << (64 - tail * 8), static_cast<uint32_t>(tail * 8));
+    }
+
+    stats_m.bits += length * 8;
+    stats_m.symbols += length * 8 / bits_per_symbol_m;
+}
+
+void error_counter::accumulate_chunk(uint64_t diff, uint32_t chunk_bits) {
+    if (diff == 0) {
+        close_burst();
+        return;
+    }
+
+    stats_m.errors += std::popcount(diff);
+
+    uint64_t symbol_flags = diff;
+    for (uint32_t s = 1; s < bits_per_symbol_m; ++s) {
+        symbol_flags |= diff << s;
+    }
+    stats_m.symbol_errors += std::popcount(symbol_flags & symbol_start_mask_m);
+
+    for (uint32_t p = 0; p < bits_per_symbol_m; ++p) {
+        stats_m.bit_position_errors[p] += std::popcount(diff & position_masks_m[p]);
+    }
+
+    // walk the runs of ones in stream order (from the MSB)
+    uint32_t pos = 0;
+    while (pos < chunk_bits) {
+        uint64_t rest = diff << pos;
+        if (rest == 0) {
+            break;
+        }
+
+        uint32_t zeros = std::countl_zero(rest);
+        if (zeros > 0) {
+            close_burst();
+            pos += zeros;
+        }
+
+        uint32_t ones = std::countl_one(diff << pos);
+        open_burst_m += ones;
+        pos += ones;
+    }
+
+    if (pos < chunk_bits) {
+        close_burst();
+    }
+}
+
+void error_counter::close_burst() {
+    if (open_burst_m == 0) {
+        return;
+    }
+
+    stats_m.bursts++;
+    stats_m.max_burst = std::max(stats_m.max_burst, open_burst_m);
+
+    size_t bucket = std::min<uint64_t>(open_burst_m, error_stats::BURST_BUCKETS) - 1;
+    stats_m.burst_histogram[bucket]++;
+
+    open_burst_m = 0;
+}
+
+void error_counter::add_counts(uint64_t bits, std::span<const uint64_t> position_errors) {
+    stats_m.bits += bits;
+    for (uint32_t b = 0; b < bits_per_symbol_m && b < position_errors.size(); ++b) {
+        stats_m.bit_position_errors[b] += position_errors[b];
+        stats_m.errors += position_errors[b];
+    }
+}
+
+void error_counter::flush() {
+    close_burst();
+}
+
+void error_counter::reset() {
+    open_burst_m = 0;
+    stats_m = error_stats();
+}
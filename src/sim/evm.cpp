@@ -0,0 +1,174 @@
+#include "sim/evm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+double to_db(double ratio) {
+    return ratio > 0 ? 10.0 * std::log10(ratio) : -std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+complex_t<double> evm_point_stats::centroid() const {
+    if (count == 0) {
+        return complex_t<double>(0.0, 0.0);
+    }
+    return complex_t<double>(sum_i / static_cast<double>(count), sum_q / static_cast<double>(count));
+}
+
+double evm_point_stats::spread() const {
+    if (count == 0) {
+        return 0.0;
+    }
+    const complex_t<double> c = centroid();
+    const double variance = sum_power / static_cast<double>(count) - (c.i * c.i + c.q * c.q);
+    return std::sqrt(std::max(variance, 0.0));
+}
+
+double evm_stats::rms_evm() const {
+    return reference_power > 0 ? std::sqrt(error_power / reference_power) : 0.0;
+}
+
+double evm_stats::peak_evm() const {
+    return reference_power > 0 ? std::sqrt(peak_error_power * static_cast<double>(symbols) / reference_power) : 0.0;
+}
+
+double evm_stats::mer_db() const {
+    if (error_power == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return to_db(reference_power / error_power);
+}
+
+double evm_stats::snr_db() const {
+    double signal = 0.0;
+    double noise = 0.0;
+    for (const auto& point : points) {
+        const complex_t<double> c = point.centroid();
+        const double centroid_power = static_cast<double>(point.count) * (c.i * c.i + c.q * c.q);
+        signal += centroid_power;
+        noise += std::max(point.sum_power - centroid_power, 0.0);
+    }
+    if (noise == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return to_db(signal / noise);
+}
+
+void evm_stats::merge(const evm_stats& other) {
+    if (points.empty()) {
+        points.resize(other.points.size());
+    }
+    if (!other.points.empty() && other.points.size() != points.size()) {
+        throw std::invalid_argument("Cannot merge EVM statistics of different constellations");
+    }
+
+    symbols += other.symbols;
+    error_power += other.error_power;
+    reference_power += other.reference_power;
+    peak_error_power = std::max(peak_error_power, other.peak_error_power);
+    for (size_t k = 0; k < other.points.size(); ++k) {
+        points[k].count += other.points[k].count;
+        points[k].sum_i += other.points[k].sum_i;
+        points[k].sum_q += other.points[k].sum_q;
+        points[k].sum_power += other.points[k].sum_power;
+    }
+}
+
+std::string evm_stats::report() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "EVM " << rms_evm() * 100 << " % rms, " << peak_evm() * 100 << " % peak, "
+        << "MER " << mer_db() << " dB, SNR " << snr_db() << " dB (" << symbols << " symbols)";
+    return oss.str();
+}
+
+template<typename DTYPE>
+evm_meter<DTYPE>::evm_meter(std::shared_ptr<mapper_base> mapper, bool unit_energy)
+    : table_m(ext_make_table<DTYPE>(mapper, unit_energy)),
+      slicer_m(table_m),
+      bits_per_symbol_m(mapper->get_bits_per_symbol()) {
+    stats_m.points.resize(table_m.lut.size());
+}
+
+template<typename DTYPE>
+void evm_meter<DTYPE>::add(DTYPE i, DTYPE q, uint32_t index) {
+    const complex_t<DTYPE>& ref = table_m.lut[index];
+    const double ei = static_cast<double>(i) - static_cast<double>(ref.i);
+    const double eq = static_cast<double>(q) - static_cast<double>(ref.q);
+    const double error = ei * ei + eq * eq;
+
+    stats_m.error_power += error;
+    stats_m.reference_power += static_cast<double>(ref.i) * ref.i + static_cast<double>(ref.q) * ref.q;
+    stats_m.peak_error_power = std::max(stats_m.peak_error_power, error);
+
+    evm_point_stats& point = stats_m.points[index];
+    point.count++;
+    point.sum_i += i;
+    point.sum_q += q;
+    point.sum_power += static_cast<double>(i) * i + static_cast<double>(q) * q;
+}
+
+template<typename DTYPE>
+void evm_meter<DTYPE>::accumulate(const complex<DTYPE>& rx, size_t count) {
+    if (count > rx.size() / 2) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    auto [in_i, in_q] = rx.decompose();
+    for (size_t k = 0; k < count; ++k) {
+        add(in_i[k], in_q[k], slicer_m.slice(in_i[k], in_q[k]));
+    }
+    stats_m.symbols += count;
+}
+
+template<typename DTYPE>
+void evm_meter<DTYPE>::accumulate(const complex<DTYPE>& rx, const complex<DTYPE>& ref, size_t count) {
+    if (count > rx.size() / 2 || count > ref.size() / 2) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    auto [in_i, in_q] = rx.decompose();
+    auto [ref_i, ref_q] = ref.decompose();
+    for (size_t k = 0; k < count; ++k) {
+        // reference symbols sit on the points, the slicer only recovers their index
+        add(in_i[k], in_q[k], slicer_m.slice(ref_i[k], ref_q[k]));
+    }
+    stats_m.symbols += count;
+}
+
+template<typename DTYPE>
+void evm_meter<DTYPE>::accumulate(const complex<DTYPE>& rx, size_t count, std::span<const byte> bits) {
+    if (count > rx.size() / 2 || count * bits_per_symbol_m > bits.size() * 8) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    auto [in_i, in_q] = rx.decompose();
+    const uint32_t mask = static_cast<uint32_t>(table_m.lut.size() - 1);
+
+    // bit accumulator, MSB first (same grouping as the modulator)
+    uint64_t acc = 0;
+    uint32_t acc_bits = 0;
+    size_t byte_pos = 0;
+    for (size_t k = 0; k < count; ++k) {
+        while (acc_bits < bits_per_symbol_m) {
+            acc = (acc << 8) | bits[byte_pos++];
+            acc_bits += 8;
+        }
+        acc_bits -= bits_per_symbol_m;
+        add(in_i[k], in_q[k], static_cast<uint32_t>(acc >> acc_bits) & mask);
+    }
+    stats_m.symbols += count;
+}
+
+template<typename DTYPE>
+void evm_meter<DTYPE>::reset() {
+    const size_t points = stats_m.points.size();
+    stats_m = evm_stats();
+    stats_m.points.resize(points);
+}
+
+SIM_TEMPLATES(evm_meter)
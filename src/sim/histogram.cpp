@@ -0,0 +1,213 @@
+#include "sim/histogram.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "file/file.hpp"
+
+namespace {
+
+// symbols binned per pass, the bin indices stay in L1
+constexpr size_t HISTOGRAM_TILE = 1024;
+
+} // namespace
+
+iq_histogram::iq_histogram(const histogram_config& cfg) : cfg_m(cfg) {
+    if (cfg_m.bins == 0 || cfg_m.bins > 4096) {
+        throw std::invalid_argument("bins must be in 1..4096");
+    }
+    if (!(cfg_m.limit > 0)) {
+        throw std::invalid_argument("limit must be > 0");
+    }
+    counts_m.assign(cfg_m.bins * cfg_m.bins + 1, 0);
+}
+
+template<typename DTYPE>
+void iq_histogram::accumulate(std::span<const DTYPE> i, std::span<const DTYPE> q) {
+    if (i.size() != q.size()) {
+        throw std::invalid_argument("I and Q must have the same size");
+    }
+
+    const DTYPE limit = static_cast<DTYPE>(cfg_m.limit);
+    const DTYPE scale = static_cast<DTYPE>(cfg_m.bins) / (2 * limit);
+    const DTYPE bins = static_cast<DTYPE>(cfg_m.bins);
+    const uint32_t width = static_cast<uint32_t>(cfg_m.bins);
+    const uint32_t overflow = width * width;
+
+    uint32_t index[HISTOGRAM_TILE];
+    for (size_t first = 0; first < i.size(); first += HISTOGRAM_TILE) {
+        const size_t count = std::min(HISTOGRAM_TILE, i.size() - first);
+        const DTYPE* in_i = i.data() + first;
+        const DTYPE* in_q = q.data() + first;
+
+        // pass 1: branch-free bin indices (NaN fails every comparison and lands in the overflow bin)
+        for (size_t k = 0; k < count; ++k) {
+            const DTYPE x = (in_i[k] + limit) * scale;
+            const DTYPE y = (in_q[k] + limit) * scale;
+            const bool inside = (x >= 0) & (x < bins) & (y >= 0) & (y < bins);
+            const int32_t bx = static_cast<int32_t>(inside ? x : 0);
+            const int32_t by = static_cast<int32_t>(inside ? y : 0);
+            index[k] = inside ? static_cast<uint32_t>(by) * width + static_cast<uint32_t>(bx) : overflow;
+        }
+
+        // pass 2: scatter
+        for (size_t k = 0; k < count; ++k) {
+            ++counts_m[index[k]];
+        }
+    }
+    total_m += i.size();
+}
+
+template<typename DTYPE>
+void iq_histogram::accumulate(const complex<DTYPE>& symbols, size_t count) {
+    if (count > symbols.size() / 2) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    auto [i, q] = symbols.decompose();
+    accumulate<DTYPE>(i.first(count), q.first(count));
+}
+
+void iq_histogram::merge(const iq_histogram& other) {
+    if (other.cfg_m.bins != cfg_m.bins || other.cfg_m.limit != cfg_m.limit) {
+        throw std::invalid_argument("Cannot merge histograms of different grids");
+    }
+    for (size_t k = 0; k < counts_m.size(); ++k) {
+        counts_m[k] += other.counts_m[k];
+    }
+    total_m += other.total_m;
+}
+
+void iq_histogram::reset() {
+    std::fill(counts_m.begin(), counts_m.end(), 0);
+    total_m = 0;
+}
+
+double iq_histogram::bin_center(size_t index) const {
+    const double width = 2 * cfg_m.limit / static_cast<double>(cfg_m.bins);
+    return -cfg_m.limit + (static_cast<double>(index) + 0.5) * width;
+}
+
+void iq_histogram::save_matrix(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not create histogram file: " + filename);
+    }
+
+    // gnuplot binary matrix: <N> <x0 .. xN-1>, then per row <y> <values>
+    const size_t bins = cfg_m.bins;
+    std::vector<float> row(bins + 1);
+    row[0] = static_cast<float>(bins);
+    for (size_t x = 0; x < bins; ++x) {
+        row[x + 1] = static_cast<float>(bin_center(x));
+    }
+    file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(float)));
+
+    for (size_t y = 0; y < bins; ++y) {
+        row[0] = static_cast<float>(bin_center(y));
+        for (size_t x = 0; x < bins; ++x) {
+            row[x + 1] = static_cast<float>(at(x, y));
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(float)));
+    }
+
+    if (!file) {
+        throw std::runtime_error("Failed to write histogram file: " + filename);
+    }
+}
+
+void iq_histogram::save_pgm(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not create image file: " + filename);
+    }
+
+    const size_t bins = cfg_m.bins;
+    const uint64_t peak = *std::max_element(counts_m.begin(), counts_m.end() - 1);
+    const double norm = peak > 0 ? 255.0 / std::log1p(static_cast<double>(peak)) : 0.0;
+
+    file << "P5\n" << bins << " " << bins << "\n255\n";
+    std::vector<unsigned char> row(bins);
+    for (size_t line = 0; line < bins; ++line) {
+        const size_t y = bins - 1 - line;
+        for (size_t x = 0; x < bins; ++x) {
+            row[x] = static_cast<unsigned char>(std::lround(std::log1p(static_cast<double>(at(x, y))) * norm));
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+
+    if (!file) {
+        throw std::runtime_error("Failed to write image file: " + filename);
+    }
+}
+
+bool iq_histogram::save_and_plot(const std::string& base_filename, const std::string& title) const {
+    try {
+        save_matrix(base_filename + ".bin");
+        save_pgm(base_filename + ".pgm");
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+    return file_io::create_histogram_gnuplot_script(base_filename + ".bin", base_filename + ".plt", title, cfg_m.limit);
+}
+
+template<typename DTYPE>
+iq_histogram ext_histogram_capture(const iq_reader<DTYPE>& reader, const histogram_config& cfg, size_t threads) {
+    const size_t workers = std::min(threads ? threads : std::max(1u, std::thread::hardware_concurrency()),
+                                    std::max<size_t>(reader.block_count(), 1));
+
+    std::vector<iq_histogram> partial(workers, iq_histogram(cfg));
+    std::atomic<size_t> next_block{0};
+    std::vector<std::exception_ptr> errors(workers);
+
+    auto worker = [&](size_t id) {
+        try {
+            // interleaved blocks are split into a planar copy first
+            const bool planar = reader.get_header().layout == iq_layout::PLANAR;
+            complex<DTYPE> copy(planar ? 2 : reader.get_header().block_samples * 2);
+            for (size_t block = next_block.fetch_add(1); block < reader.block_count(); block = next_block.fetch_add(1)) {
+                const iq_view<DTYPE> view = reader.block(block);
+                if (planar) {
+                    partial[id].accumulate<DTYPE>(view.i, view.q);
+                } else {
+                    reader.read(view.first, view.count, copy);
+                    partial[id].accumulate(copy, view.count);
+                }
+            }
+        } catch (...) {
+            errors[id] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < workers; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (size_t t = 1; t < workers; ++t) {
+        partial[0].merge(partial[t]);
+    }
+    return partial[0];
+}
+
+template void iq_histogram::accumulate<float>(std::span<const float>, std::span<const float>);
+template void iq_histogram::accumulate<double>(std::span<const double>, std::span<const double>);
+template void iq_histogram::accumulate<float>(const complex<float>&, size_t);
+template void iq_histogram::accumulate<double>(const complex<double>&, size_t);
+
+template iq_histogram ext_histogram_capture<float>(const iq_reader<float>&, const histogram_config&, size_t);
+template iq_histogram ext_histogram_capture<double>(const iq_reader<double>&, const histogram_config&, size_t);
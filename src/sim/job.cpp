@@ -0,0 +1,633 @@
+#include "sim/job.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include "file/result_writer.hpp"
+#include "phys/qam/mapper.hpp"
+#include "sim/hash.hpp"
+#include "sim/sweep.hpp"
+#include "sim/theory.hpp"
+
+namespace {
+
+using engine_key = std::tuple<qam_order, size_t, size_t, bool, bool>;
+
+struct spec_value {
+    std::string value;
+    size_t      line = 0;
+};
+
+using spec_section = std::map<std::string, spec_value>;
+
+std::string trim(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    const size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(trim(part));
+    }
+    return parts;
+}
+
+[[noreturn]] void spec_error(size_t line, const std::string& message) {
+    throw std::invalid_argument("job spec line " + std::to_string(line) + ": " + message);
+}
+
+double parse_double(const spec_value& v) {
+    try {
+        size_t used = 0;
+        double value = std::stod(v.value, &used);
+        if (used == v.value.size()) {
+            return value;
+        }
+    } catch (const std::exception&) {
+    }
+    spec_error(v.line, "not a number: '" + v.value + "'");
+}
+
+uint64_t parse_uint(const spec_value& v) {
+    try {
+        size_t used = 0;
+        unsigned long long value = std::stoull(v.value, &used);
+        if (used == v.value.size() && v.value[0] != '-') {
+            return value;
+        }
+    } catch (const std::exception&) {
+    }
+    spec_error(v.line, "not an unsigned integer: '" + v.value + "'");
+}
+
+bool parse_bool(const spec_value& v) {
+    if (v.value == "true" || v.value == "1" || v.value == "yes") {
+        return true;
+    }
+    if (v.value == "false" || v.value == "0" || v.value == "no") {
+        return false;
+    }
+    spec_error(v.line, "not a boolean: '" + v.value + "'");
+}
+
+qam_order parse_modulation(const std::string& name, size_t line) {
+    if (name == "QPSK")  return qam_order::QPSK;
+    if (name == "QAM16") return qam_order::QAM16;
+    if (name == "QAM64") return qam_order::QAM64;
+    spec_error(line, "unknown modulation '" + name + "'");
+}
+
+sample_type parse_dtype(const std::string& name, size_t line) {
+    if (name == "float")  return sample_type::FLOAT;
+    if (name == "double") return sample_type::DOUBLE;
+    spec_error(line, "unknown dtype '" + name + "'");
+}
+
+std::string modulation_name(qam_order order) {
+    switch (order) {
+        case qam_order::QPSK:   return "qpsk";
+        case qam_order::QAM16:  return "qam16";
+        case qam_order::QAM64:  return "qam64";
+        default:                return "unknown";
+    }
+}
+
+std::string replace_all(std::string text, const std::string& from, const std::string& to) {
+    for (size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size())) {
+        text.replace(pos, from.size(), to);
+    }
+    return text;
+}
+
+void parse_grid(sweep_job& job, const spec_value& v, sweep_axis axis) {
+    auto parts = split(v.value, ':');
+    if (parts.size() != 3) {
+        spec_error(v.line, "grid must be start:end:step");
+    }
+
+    job.axis = axis;
+    job.grid_start = parse_double({parts[0], v.line});
+    job.grid_end = parse_double({parts[1], v.line});
+    job.grid_step = parse_double({parts[2], v.line});
+
+    if (job.grid_step <= 0 || job.grid_end < job.grid_start) {
+        spec_error(v.line, "grid needs step > 0 and end >= start");
+    }
+}
+
+/**
+ * @brief Builds the jobs of one section (defaults overlaid with the section keys)
+ */
+void expand_section(const spec_section& section, std::vector<sweep_job>& jobs) {
+    sweep_job base;
+    std::vector<std::pair<qam_order, std::string>> modulations = {{qam_order::QPSK, "qpsk"}};
+    std::vector<std::pair<sample_type, std::string>> dtypes = {{sample_type::FLOAT, "float"}};
+    size_t section_line = 0;
+
+    for (const auto& [key, v] : section) {
+        section_line = std::max(section_line, v.line);
+
+        if (key == "name")                  base.name = v.value;
+        else if (key == "output")           base.output = v.value;
+        else if (key == "sigma")            parse_grid(base, v, sweep_axis::SIGMA);
+        else if (key == "ebn0_db")          parse_grid(base, v, sweep_axis::EBN0_DB);
+        else if (key == "esn0_db")          parse_grid(base, v, sweep_axis::ESN0_DB);
+        else if (key == "unit_energy")      base.engine.unit_energy = parse_bool(v);
+        else if (key == "adaptive")         base.adaptive = parse_bool(v);
+        else if (key == "coarse_points")    base.coarse_points = parse_uint(v);
+        else if (key == "point_budget")     base.point_budget = parse_uint(v);
+        else if (key == "min_step")         base.min_step = parse_double(v);
+        else if (key == "tolerance")        base.tolerance = parse_double(v);
+        else if (key == "frames")           base.frames = parse_uint(v);
+        else if (key == "min_frames")       base.min_frames = parse_uint(v);
+        else if (key == "target_errors")    base.target_errors = parse_uint(v);
+        else if (key == "chunk_frames")     base.chunk_frames = parse_uint(v);
+        else if (key == "plan_frames")      base.plan_frames = parse_bool(v);
+        else if (key == "flag_sigma")       base.flag_sigma = parse_double(v);
+        else if (key == "frame_bytes")      base.engine.frame_bytes = parse_uint(v);
+        else if (key == "tile_bytes")       base.engine.tile_bytes = parse_uint(v);
+        else if (key == "fused")            base.engine.fused = parse_bool(v);
+        else if (key == "seed")             base.engine.seed = parse_uint(v);
+        else if (key == "modulation") {
+            modulations.clear();
+            for (const auto& name : split(v.value, ',')) {
+                modulations.emplace_back(parse_modulation(name, v.line), modulation_name(parse_modulation(name, v.line)));
+            }
+        } else if (key == "dtype") {
+            dtypes.clear();
+            for (const auto& name : split(v.value, ',')) {
+                dtypes.emplace_back(parse_dtype(name, v.line), name);
+            }
+        } else {
+            spec_error(v.line, "unknown key '" + key + "'");
+        }
+    }
+
+    if (base.output.empty()) {
+        spec_error(section_line, "job without output");
+    }
+    if (base.frames == 0 || base.chunk_frames == 0) {
+        spec_error(section_line, "frames and chunk_frames must be > 0");
+    }
+    if (base.plan_frames && base.target_errors == 0) {
+        spec_error(section.at("plan_frames").line, "plan_frames needs target_errors");
+    }
+    if (base.axis != sweep_axis::SIGMA) {
+        // Eb/N0 and Es/N0 grids are comparable between modulations only on unit-energy tables
+        base.engine.unit_energy = true;
+        if (base.adaptive) {
+            spec_error(section_line, "adaptive grids are defined on sigma only");
+        }
+    }
+
+    const bool unique_output = base.output.find('{') == std::string::npos;
+    if (unique_output && modulations.size() * dtypes.size() > 1) {
+        spec_error(section.at("output").line, "several modulations / dtypes need {modulation} / {dtype} in output");
+    }
+
+    for (const auto& [order, order_name] : modulations) {
+        for (const auto& [dtype, dtype_name] : dtypes) {
+            sweep_job job = base;
+            job.modulation = order;
+            job.dtype = dtype;
+            job.output = replace_all(replace_all(base.output, "{modulation}", order_name), "{dtype}", dtype_name);
+            if (job.name.empty()) {
+                job.name = order_name + "_" + dtype_name;
+            }
+            jobs.push_back(job);
+        }
+    }
+}
+
+bool point_done(const sweep_job& job, const ber_point& point) {
+    if (point.frames >= job.frames) {
+        return true;
+    }
+    return job.target_errors && point.errors >= job.target_errors && point.frames >= job.min_frames;
+}
+
+/**
+ * @brief Simulates a point, starting from its cached counts if there are any
+ * @return Point satisfying the budget / stopping rule of the job
+ */
+template<typename DTYPE>
+ber_point evaluate_point(sim_engine<DTYPE>& engine, const sweep_job& job, uint64_t seed, 
+                         double sigma, result_cache* cache, uint64_t& simulated_frames) {
+    const uint64_t key = job.point_key(sigma);
+
+    ber_point point;
+    point.sigma = sigma;
+    if (cache) {
+        if (auto cached = cache->find(key)) {
+            point = *cached;
+        }
+    }
+
+    if (point_done(job, point)) {
+        return point;
+    }
+
+    // a top-up must not replay the payload and noise of the cached frames
+    engine.reseed(seed, key + point.frames);
+
+    const uint64_t cached_frames = point.frames;
+    while (!point_done(job, point)) {
+        const uint64_t chunk = std::min(job.chunk_frames, job.frames - point.frames);
+        point.merge(engine.run(sigma, chunk));
+    }
+    simulated_frames += point.frames - cached_frames;
+
+    if (cache) {
+        cache->store(key, point);
+    }
+    return point;
+}
+
+} // namespace
+
+/**
+ * @struct batch_runner::worker_cache
+ * @brief Engines of one worker, keyed by everything their buffers depend on
+ *
+ * The maps belong to the worker thread; other threads only read the count.
+ */
+struct batch_runner::worker_cache {
+    std::map<engine_key, sim_engine<float>::ptr>   float_engines;
+    std::map<engine_key, sim_engine<double>::ptr>  double_engines;
+    std::atomic<size_t>                            engine_count{0};
+
+    template<typename DTYPE>
+    sim_engine<DTYPE>& get(const sweep_job& job, const std::shared_ptr<mapper_base>& mapper) {
+        auto& engines = [this]() -> auto& {
+            if constexpr (std::is_same_v<DTYPE, float>) {
+                return float_engines;
+            } else {
+                return double_engines;
+            }
+        }();
+
+        engine_key key{job.modulation, job.engine.frame_bytes, job.engine.tile_bytes, job.engine.fused, job.engine.unit_energy};
+        auto it = engines.find(key);
+        if (it == engines.end()) {
+            it = engines.emplace(key, sim_engine<DTYPE>::make(mapper, job.engine)).first;
+            engine_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return *it->second;
+    }
+};
+
+std::vector<double> sweep_job::grid() const {
+    std::vector<double> values;
+    const size_t count = static_cast<size_t>(std::floor((grid_end - grid_start) / grid_step + 1e-9)) + 1;
+    for (size_t i = 0; i < count; ++i) {
+        values.push_back(grid_start + i * grid_step);
+    }
+    return values;
+}
+
+uint64_t sweep_job::point_key(double sigma) const {
+    uint64_t h = FNV1A_BASIS;
+    h = fnv1a(h, static_cast<uint32_t>(modulation));
+    h = fnv1a(h, static_cast<uint32_t>(dtype));
+    h = fnv1a(h, static_cast<uint32_t>(engine.unit_energy));
+    h = fnv1a(h, sigma);
+    h = fnv1a(h, static_cast<uint64_t>(engine.frame_bytes));
+    h = fnv1a(h, engine.seed);
+    return h;
+}
+
+job_batch parse_job_spec(std::istream& in) {
+    job_batch batch;
+    spec_section defaults;
+    std::vector<spec_section> sections;
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line == "[job]") {
+            sections.emplace_back();
+            continue;
+        }
+        if (line.front() == '[') {
+            spec_error(line_number, "unknown section " + line);
+        }
+
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            spec_error(line_number, "expected key = value");
+        }
+
+        std::string key = trim(line.substr(0, eq));
+        spec_value value{trim(line.substr(eq + 1)), line_number};
+        if (key.empty() || value.value.empty()) {
+            spec_error(line_number, "expected key = value");
+        }
+
+        if (sections.empty()) {
+            if (key == "cache") {
+                batch.cache = value.value;
+            } else if (key == "threads") {
+                batch.threads = parse_uint(value);
+                if (batch.threads == 0) {
+                    spec_error(line_number, "threads must be > 0");
+                }
+            } else {
+                defaults[key] = value;
+            }
+        } else {
+            sections.back()[key] = value;
+        }
+    }
+
+    for (const auto& section : sections) {
+        spec_section merged = defaults;
+        for (const auto& [key, value] : section) {
+            merged[key] = value;
+        }
+        expand_section(merged, batch.jobs);
+    }
+
+    return batch;
+}
+
+job_batch load_job_spec(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open job spec: " + filename);
+    }
+    return parse_job_spec(file);
+}
+
+void save_job_result(const job_result& result) {
+    std::vector<result_column> columns;
+    if (result.job.axis == sweep_axis::EBN0_DB) {
+        columns.push_back({"ebn0_db", 4});
+    } else if (result.job.axis == sweep_axis::ESN0_DB) {
+        columns.push_back({"esn0_db", 4});
+    }
+    columns.push_back({"sigma", 4});
+    columns.push_back({"ber", 15});
+    columns.push_back({"theory_ber", 6, true});
+    columns.push_back({"ser", 6, true});
+    columns.push_back({"mean_burst", 3});
+
+    const bool snr_axis = result.job.axis != sweep_axis::SIGMA;
+    result_writer writer(result.job.output, columns);
+
+    std::vector<double> record;
+    for (size_t i = 0; i < result.points.size(); ++i) {
+        record.clear();
+        if (snr_axis) {
+            record.push_back(result.axis[i]);
+        }
+        record.push_back(result.points[i].sigma);
+        record.push_back(result.points[i].ber());
+        record.push_back(i < result.theory_ber.size() ? result.theory_ber[i] : std::numeric_limits<double>::quiet_NaN());
+
+        // cached points and fused jobs have no symbol statistics
+        const bool counted = i < result.stats.size() && result.stats[i].symbols > 0;
+        record.push_back(counted ? result.stats[i].ser() : std::numeric_limits<double>::quiet_NaN());
+        record.push_back(counted ? result.stats[i].mean_burst() : std::numeric_limits<double>::quiet_NaN());
+        writer.push(record);
+    }
+    writer.close();
+}
+
+batch_runner::batch_runner(size_t threads) {
+    if (threads == 0) {
+        throw std::invalid_argument("threads must be > 0");
+    }
+
+    for (size_t i = 0; i < threads; ++i) {
+        caches_m.push_back(std::make_unique<worker_cache>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers_m.emplace_back(&batch_runner::worker_loop, this, std::ref(*caches_m[i]));
+    }
+}
+
+batch_runner::ptr batch_runner::make(size_t threads) {
+    return std::make_unique<batch_runner>(threads);
+}
+
+batch_runner::~batch_runner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        stop_m = true;
+    }
+    work_cv_m.notify_all();
+
+    for (auto& worker : workers_m) {
+        worker.join();
+    }
+}
+
+size_t batch_runner::get_engine_count() const {
+    // caches_m is fixed by the constructor, the maps may grow meanwhile
+    size_t count = 0;
+    for (const auto& cache : caches_m) {
+        count += cache->engine_count.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+void batch_runner::worker_loop(worker_cache& cache) {
+    while (true) {
+        task t;
+        {
+            std::unique_lock<std::mutex> lock(mutex_m);
+            work_cv_m.wait(lock, [this] { return stop_m || !queue_m.empty(); });
+            if (queue_m.empty()) {
+                return;
+            }
+            t = std::move(queue_m.front());
+            queue_m.pop_front();
+            ++busy_m;
+        }
+
+        try {
+            t(cache);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_m);
+            if (!error_m) {
+                error_m = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_m);
+            --busy_m;
+        }
+        idle_cv_m.notify_all();
+    }
+}
+
+void batch_runner::submit(task t) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        queue_m.push_back(std::move(t));
+    }
+    work_cv_m.notify_one();
+}
+
+std::shared_ptr<mapper_base> batch_runner::get_mapper(qam_order order, sample_type dtype) {
+    auto key = std::make_pair(order, dtype);
+    auto it = mappers_m.find(key);
+    if (it == mappers_m.end()) {
+        auto mapper = (dtype == sample_type::FLOAT) ? ext_make_mapper<float>(order) : ext_make_mapper<double>(order);
+        it = mappers_m.emplace(key, mapper).first;
+    }
+    return it->second;
+}
+
+std::vector<job_result> batch_runner::run(const std::vector<sweep_job>& jobs) {
+    std::vector<job_result> results(jobs.size());
+    std::vector<std::map<double, error_stats>> stats(jobs.size());   // by sigma, written under mutex_m
+
+    // everything that may throw happens before the first task references results
+    std::vector<std::shared_ptr<mapper_base>> mappers;
+    std::vector<std::shared_ptr<const constellation_theory>> theories;
+    for (const auto& job : jobs) {
+        mappers.push_back(get_mapper(job.modulation, job.dtype));
+
+        // exact reference for the labelling and scale the job actually transmits
+        auto reference = get_mapper(job.modulation, sample_type::DOUBLE);
+        theories.push_back(std::make_shared<const constellation_theory>(
+            ext_make_table<double>(reference, job.engine.unit_energy), reference->get_bits_per_symbol()));
+    }
+
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const sweep_job& job = jobs[j];
+        job_result& result = results[j];
+        result.job = job;
+
+        auto mapper = mappers[j];
+        const bool use_float = job.dtype == sample_type::FLOAT;
+        const uint64_t seed = job.engine.seed ? job.engine.seed : std::random_device{}();
+        result_cache* cache = cache_m;
+
+        auto theory = theories[j];
+
+        auto& job_stats = stats[j];
+        auto evaluate = [this, &result, &job_stats, mapper, theory, use_float, seed, cache](worker_cache& workers,
+                                                                                          double sigma) {
+            uint64_t simulated = 0;
+            error_stats point_stats;
+
+            auto run_point = [&](auto& engine) {
+                sweep_job planned = result.job;
+                if (planned.plan_frames) {
+                    // frames expected to collect target_errors, within [min_frames, frames]
+                    planned.frames = ext_plan_frames(theory->at_sigma(sigma).ber, engine.get_config().frame_bytes * 8,
+                                                     planned.target_errors, planned.min_frames, planned.frames);
+                }
+
+                engine.reset_stats();
+                ber_point point = evaluate_point(engine, planned, seed, sigma, cache, simulated);
+                point_stats = engine.get_error_stats();
+                return point;
+            };
+
+            ber_point point = use_float ? run_point(workers.get<float>(result.job, mapper))
+                                        : run_point(workers.get<double>(result.job, mapper));
+
+            std::lock_guard<std::mutex> lock(mutex_m);
+            result.simulated_frames += simulated;
+            job_stats[sigma] = point_stats;
+            return point;
+        };
+
+        if (job.adaptive) {
+            submit([&result, evaluate](worker_cache& workers) {
+                const sweep_job& job = result.job;
+                adaptive_sweep::config cfg;
+                cfg.sigma_start = job.grid_start;
+                cfg.sigma_end = job.grid_end;
+                cfg.coarse_points = job.coarse_points;
+                cfg.point_budget = job.point_budget;
+                cfg.min_step = job.min_step;
+                cfg.tolerance = job.tolerance;
+
+                adaptive_sweep sweep(cfg);
+                result.points = sweep.run([&](double sigma) {
+                    return evaluate(workers, sigma);
+                });
+
+                result.axis.clear();
+                for (const auto& point : result.points) {
+                    result.axis.push_back(point.sigma);
+                }
+            });
+            continue;
+        }
+
+        result.axis = job.grid();
+        result.points.resize(result.axis.size());
+
+        const double energy = job.engine.unit_energy ? 1.0 : mapper->get_symbol_energy();
+
+        // one task per point: results land in preallocated slots
+        for (size_t i = 0; i < result.axis.size(); ++i) {
+            double sigma = result.axis[i];
+            if (job.axis == sweep_axis::EBN0_DB) {
+                sigma = ext_ebn0_to_sigma(result.axis[i], mapper->get_bits_per_symbol(), energy);
+            } else if (job.axis == sweep_axis::ESN0_DB) {
+                sigma = ext_esn0_to_sigma(result.axis[i], energy);
+            }
+
+            submit([&result, evaluate, i, sigma](worker_cache& workers) {
+                result.points[i] = evaluate(workers, sigma);
+            });
+        }
+    }
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_m);
+        idle_cv_m.wait(lock, [this] { return queue_m.empty() && busy_m == 0; });
+        std::swap(error, error_m);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (size_t j = 0; j < results.size(); ++j) {
+        job_result& result = results[j];
+        for (const auto& point : result.points) {
+            result.stats.push_back(stats[j][point.sigma]);
+
+            const double expected = theories[j]->at_sigma(point.sigma).ber;
+            const double deviation = ext_ber_deviation(point, expected);
+
+            result.theory_ber.push_back(expected);
+            result.deviation.push_back(deviation);
+            if (result.job.flag_sigma > 0 && std::fabs(deviation) > result.job.flag_sigma) {
+                result.flagged++;
+            }
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,127 @@
+#include "sim/noise_estimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// independent partial sums, the adds of one lane do not wait for the others
+constexpr size_t MOMENT_LANES = 4;
+
+} // namespace
+
+double noise_estimate::sigma() const {
+    return std::sqrt(std::max(noise_power, 0.0) / 2.0);
+}
+
+double noise_estimate::esn0_db() const {
+    if (noise_power <= 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return signal_power > 0 ? 10.0 * std::log10(signal_power / noise_power) : -std::numeric_limits<double>::infinity();
+}
+
+template<typename DTYPE>
+noise_estimator<DTYPE>::noise_estimator(std::shared_ptr<mapper_base> mapper, noise_method method, bool unit_energy)
+    : table_m(ext_make_table<DTYPE>(mapper, unit_energy)),
+      slicer_m(table_m),
+      method_m(method) {
+    double m2 = 0.0;
+    double m4 = 0.0;
+    for (const auto& point : table_m.points) {
+        const double power = static_cast<double>(point.i) * point.i + static_cast<double>(point.q) * point.q;
+        m2 += power;
+        m4 += power * power;
+    }
+    const double n = static_cast<double>(table_m.points.size());
+    kurtosis_m = (m4 / n) / ((m2 / n) * (m2 / n));
+}
+
+template<typename DTYPE>
+noise_estimate noise_estimator<DTYPE>::estimate(const complex<DTYPE>& symbols, size_t count) {
+    if (count > symbols.size() / 2) {
+        throw std::out_of_range("requested symbol count is out of range");
+    }
+    auto [in_i, in_q] = symbols.decompose();
+
+    moments block;
+    block.symbols = count;
+    if (method_m == noise_method::M2M4) {
+        double power[MOMENT_LANES] = {};
+        double power_sq[MOMENT_LANES] = {};
+        size_t k = 0;
+        for (; k + MOMENT_LANES <= count; k += MOMENT_LANES) {
+            for (size_t lane = 0; lane < MOMENT_LANES; ++lane) {
+                const double i = in_i[k + lane];
+                const double q = in_q[k + lane];
+                const double p = i * i + q * q;
+                power[lane] += p;
+                power_sq[lane] += p * p;
+            }
+        }
+        for (; k < count; ++k) {
+            const double p = static_cast<double>(in_i[k]) * in_i[k] + static_cast<double>(in_q[k]) * in_q[k];
+            power[0] += p;
+            power_sq[0] += p * p;
+        }
+        for (size_t lane = 0; lane < MOMENT_LANES; ++lane) {
+            block.power += power[lane];
+            block.power_sq += power_sq[lane];
+        }
+    } else {
+        for (size_t k = 0; k < count; ++k) {
+            const complex_t<DTYPE>& ref = table_m.lut[slicer_m.slice(in_i[k], in_q[k])];
+            const double ei = static_cast<double>(in_i[k]) - ref.i;
+            const double eq = static_cast<double>(in_q[k]) - ref.q;
+            block.error += ei * ei + eq * eq;
+            block.reference += static_cast<double>(ref.i) * ref.i + static_cast<double>(ref.q) * ref.q;
+        }
+    }
+
+    total_m.symbols += block.symbols;
+    total_m.power += block.power;
+    total_m.power_sq += block.power_sq;
+    total_m.reference += block.reference;
+    total_m.error += block.error;
+    return solve(block);
+}
+
+template<typename DTYPE>
+void noise_estimator<DTYPE>::merge(const noise_estimator& other) {
+    if (other.method_m != method_m || other.table_m.lut.size() != table_m.lut.size()) {
+        throw std::invalid_argument("Cannot merge estimators of different methods or constellations");
+    }
+    total_m.symbols += other.total_m.symbols;
+    total_m.power += other.total_m.power;
+    total_m.power_sq += other.total_m.power_sq;
+    total_m.reference += other.total_m.reference;
+    total_m.error += other.total_m.error;
+}
+
+template<typename DTYPE>
+noise_estimate noise_estimator<DTYPE>::solve(const moments& m) const {
+    noise_estimate result;
+    result.symbols = m.symbols;
+    if (m.symbols == 0) {
+        return result;
+    }
+
+    const double n = static_cast<double>(m.symbols);
+    if (method_m == noise_method::DECISION) {
+        result.signal_power = m.reference / n;
+        result.noise_power = m.error / n;
+        return result;
+    }
+
+    // S = sqrt((2 * M2^2 - M4) / (2 - ka)), clamped to [0, M2] against the variance of short blocks
+    const double m2 = m.power / n;
+    const double m4 = m.power_sq / n;
+    const double signal = std::sqrt(std::max(2.0 * m2 * m2 - m4, 0.0) / (2.0 - kurtosis_m));
+    result.signal_power = std::min(signal, m2);
+    result.noise_power = m2 - result.signal_power;
+    return result;
+}
+
+SIM_TEMPLATES(noise_estimator)
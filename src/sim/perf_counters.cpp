@@ -0,0 +1,179 @@
+#include "sim/perf_counters.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+struct event_config {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_read_miss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// same order as perf_event_kind
+constexpr event_config EVENTS[PERF_EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+};
+
+int open_event(const event_config& event) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // calling thread, any CPU, no group
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+} // namespace
+
+void perf_sample::merge(const perf_sample& other) {
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        values[e] += other.values[e];
+        valid[e] = (regions ? valid[e] : true) && other.valid[e];
+    }
+    regions += other.regions;
+}
+
+double perf_sample::ipc() const {
+    if (!has(perf_event_kind::CYCLES) || !has(perf_event_kind::INSTRUCTIONS) || get(perf_event_kind::CYCLES) == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(get(perf_event_kind::INSTRUCTIONS)) / static_cast<double>(get(perf_event_kind::CYCLES));
+}
+
+double perf_sample::per_unit(perf_event_kind kind, uint64_t units) const {
+    if (!has(kind) || units == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(get(kind)) / static_cast<double>(units);
+}
+
+std::string perf_sample::report(uint64_t units, const std::string& unit_name) const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << "IPC ";
+    if (has(perf_event_kind::CYCLES) && has(perf_event_kind::INSTRUCTIONS)) {
+        oss << ipc();
+    } else {
+        oss << "n/a";
+    }
+
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        const auto kind = static_cast<perf_event_kind>(e);
+        oss << ", " << event_name(kind) << "/" << unit_name << " ";
+        if (has(kind)) {
+            oss << std::setprecision(kind == perf_event_kind::LLC_MISSES ? 4 : 2) << per_unit(kind, units);
+        } else {
+            oss << "n/a";
+        }
+    }
+    return oss.str();
+}
+
+const char* perf_sample::event_name(perf_event_kind kind) {
+    switch (kind) {
+        case perf_event_kind::CYCLES:           return "cycles";
+        case perf_event_kind::INSTRUCTIONS:     return "instructions";
+        case perf_event_kind::BRANCH_MISSES:    return "branch-misses";
+        case perf_event_kind::L1D_MISSES:       return "L1D-misses";
+        case perf_event_kind::LLC_MISSES:       return "LLC-misses";
+        default:                                return "unknown";
+    }
+}
+
+perf_counters::perf_counters() {
+    fds_m.fill(-1);
+#ifdef __linux__
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        fds_m[e] = open_event(EVENTS[e]);
+    }
+#endif
+}
+
+perf_counters::~perf_counters() {
+#ifdef __linux__
+    for (int fd : fds_m) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+perf_counters::ptr perf_counters::make() {
+    return std::make_unique<perf_counters>();
+}
+
+bool perf_counters::available() const {
+    for (int fd : fds_m) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void perf_counters::start() {
+#ifdef __linux__
+    for (int fd : fds_m) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+perf_sample perf_counters::stop() {
+    perf_sample sample;
+    sample.regions = 1;
+#ifdef __linux__
+    for (int fd : fds_m) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        if (fds_m[e] < 0) {
+            continue;
+        }
+
+        // value, time enabled, time running
+        uint64_t data[3] = {0, 0, 0};
+        if (read(fds_m[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+
+        // the kernel time-shares counters if more events than PMU slots are open
+        double scaled = static_cast<double>(data[0]);
+        if (data[2] < data[1]) {
+            scaled *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+        sample.values[e] = static_cast<uint64_t>(scaled);
+        sample.valid[e] = true;
+    }
+#endif
+    return sample;
+}
@@ -0,0 +1,271 @@
+#include "sim/pipeline.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// whole symbols for 2, 4 and 6 bits per symbol
+constexpr size_t BLOCK_ALIGN_BYTES = 3;
+
+// a random seed is drawn once, payload and noise streams share it
+uint64_t resolve_seed(engine_config& cfg) {
+    if (cfg.seed == 0) {
+        cfg.seed = std::random_device{}();
+    }
+    return cfg.seed;
+}
+
+// end of stream, passed down the links after the last block
+constexpr uint32_t END_OF_STREAM = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Thrown inside a stage when another stage failed
+ */
+struct pipeline_aborted {};
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Pins a thread to a core, best effort (containers may forbid it)
+ */
+void pin_thread(std::thread& thread, size_t core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % std::max(1u, std::thread::hardware_concurrency()), &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+}
+
+} // namespace
+
+double pipeline_stats::bits_per_second() const {
+    return total_ns ? static_cast<double>(bits) * 1e9 / static_cast<double>(total_ns) : 0.0;
+}
+
+std::string pipeline_stats::report() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << bits_per_second() / 1e6 << " Mbit/s |";
+    for (size_t s = 0; s < PIPELINE_STAGES; ++s) {
+        const pipeline_stage_stats& stage = stages[s];
+        const double busy = total_ns ? static_cast<double>(stage.busy_ns) / static_cast<double>(total_ns) : 0.0;
+        oss << " " << stage_profile::stage_name(static_cast<sim_stage>(s)) << " " << busy * 100.0
+            << "% q" << stage.mean_occupancy();
+    }
+    return oss.str();
+}
+
+template<typename DTYPE>
+sim_pipeline<DTYPE>::sim_pipeline(std::shared_ptr<mapper_base> mapper, const engine_config& engine,
+                                  const pipeline_config& cfg)
+    : engine_m(engine),
+      cfg_m(cfg),
+      counter_m(mapper ? mapper->get_bits_per_symbol() : 1),
+      source_m(resolve_seed(engine_m), engine.stream) {
+    if (!mapper) {
+        throw std::invalid_argument("Mapper cannot be null");
+    }
+    if (engine_m.frame_bytes < BLOCK_ALIGN_BYTES || cfg_m.block_bytes < BLOCK_ALIGN_BYTES) {
+        throw std::invalid_argument("frame_bytes and block_bytes must be >= 3");
+    }
+    if (cfg_m.depth == 0) {
+        throw std::invalid_argument("depth must be > 0");
+    }
+
+    // same rounding as the engine tiles: no padded symbol inside a frame
+    engine_m.frame_bytes -= engine_m.frame_bytes % BLOCK_ALIGN_BYTES;
+    cfg_m.block_bytes -= cfg_m.block_bytes % BLOCK_ALIGN_BYTES;
+    cfg_m.block_bytes = std::min(cfg_m.block_bytes, engine_m.frame_bytes);
+
+    modulator_m.set_mapper(mapper);
+    demodulator_m.set_mapper(mapper);
+    modulator_m.set_unit_energy(engine_m.unit_energy);
+    demodulator_m.set_unit_energy(engine_m.unit_energy);
+
+    channel_m.set_channel_response_model(noise<DTYPE>(0.0, engine_m.seed, engine_m.stream));
+    channel_m.set_signal_energy(engine_m.unit_energy ? 1.0 : mapper->get_symbol_energy());
+
+    // every link can be full at once, the free queue holds all blocks
+    const size_t max_symbols = (cfg_m.block_bytes * 8 + 1) / 2;
+    blocks_m.resize(4 * cfg_m.depth);
+    for (block& b : blocks_m) {
+        b.tx_bits.resize(cfg_m.block_bytes);
+        b.rx_bits.resize(cfg_m.block_bytes);
+        b.symbols = complex<DTYPE>::make(max_symbols * 2);
+    }
+    free_m = std::make_unique<queue>(blocks_m.size());
+    for (auto& link : links_m) {
+        link = std::make_unique<queue>(cfg_m.depth);
+    }
+}
+
+template<typename DTYPE>
+typename sim_pipeline<DTYPE>::ptr sim_pipeline<DTYPE>::make(std::shared_ptr<mapper_base> mapper,
+                                                            const engine_config& engine, const pipeline_config& cfg) {
+    return std::make_unique<sim_pipeline>(mapper, engine, cfg);
+}
+
+template<typename DTYPE>
+uint32_t sim_pipeline<DTYPE>::pop(queue& input, pipeline_stage_stats& stats) {
+    uint32_t index = 0;
+    while (!input.try_pop(index)) {
+        if (abort_m.load(std::memory_order_relaxed)) {
+            throw pipeline_aborted();
+        }
+        ++stats.input_waits;
+        std::this_thread::yield();
+    }
+    const size_t occupancy = input.size() + 1;
+    stats.occupancy_sum += occupancy;
+    stats.occupancy_max = std::max(stats.occupancy_max, occupancy);
+    return index;
+}
+
+template<typename DTYPE>
+void sim_pipeline<DTYPE>::push(queue& output, uint32_t index, pipeline_stage_stats& stats) {
+    while (!output.try_push(index)) {
+        if (abort_m.load(std::memory_order_relaxed)) {
+            throw pipeline_aborted();
+        }
+        ++stats.output_waits;
+        std::this_thread::yield();
+    }
+}
+
+template<typename DTYPE>
+ber_point sim_pipeline<DTYPE>::run(double sigma, size_t frames) {
+    channel_m.set_sigma(sigma);
+    counter_m.reset();
+    abort_m = false;
+
+    // all blocks start free, the links are empty after every run
+    uint32_t drain = 0;
+    while (free_m->try_pop(drain)) {}
+    for (uint32_t b = 0; b < blocks_m.size(); ++b) {
+        free_m->try_push(b);
+    }
+
+    ber_point point;
+    point.sigma = sigma;
+
+    const size_t blocks_per_frame = (engine_m.frame_bytes + cfg_m.block_bytes - 1) / cfg_m.block_bytes;
+    std::array<pipeline_stage_stats, PIPELINE_STAGES> stage_stats{};
+    std::array<std::exception_ptr, PIPELINE_STAGES> errors{};
+
+    // one loop per stage: take a block, run the kernel, hand it on; END_OF_STREAM is forwarded
+    auto stage = [&](sim_stage id, queue& input, queue* output, auto&& kernel) {
+        pipeline_stage_stats& stats = stage_stats[static_cast<size_t>(id)];
+        try {
+            while (true) {
+                const uint32_t index = pop(input, stats);
+                if (index == END_OF_STREAM) {
+                    if (output) {
+                        push(*output, END_OF_STREAM, stats);
+                    }
+                    return;
+                }
+                const auto start = std::chrono::steady_clock::now();
+                kernel(blocks_m[index]);
+                stats.busy_ns += elapsed_ns(start);
+                stats.blocks++;
+                push(output ? *output : *free_m, index, stats);
+            }
+        } catch (const pipeline_aborted&) {
+        } catch (...) {
+            errors[static_cast<size_t>(id)] = std::current_exception();
+            abort_m = true;
+        }
+    };
+
+    auto generate = [&]() {
+        pipeline_stage_stats& stats = stage_stats[static_cast<size_t>(sim_stage::GENERATE)];
+        try {
+            for (size_t frame = 0; frame < frames; ++frame) {
+                for (size_t b = 0; b < blocks_per_frame; ++b) {
+                    const uint32_t index = pop(*free_m, stats);
+                    block& blk = blocks_m[index];
+                    const auto start = std::chrono::steady_clock::now();
+                    blk.bytes = std::min(cfg_m.block_bytes, engine_m.frame_bytes - b * cfg_m.block_bytes);
+                    source_m.fill(std::span<byte>(blk.tx_bits.data(), blk.bytes));
+                    stats.busy_ns += elapsed_ns(start);
+                    stats.blocks++;
+                    push(*links_m[0], index, stats);
+                }
+            }
+            push(*links_m[0], END_OF_STREAM, stats);
+        } catch (const pipeline_aborted&) {
+        } catch (...) {
+            errors[static_cast<size_t>(sim_stage::GENERATE)] = std::current_exception();
+            abort_m = true;
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.emplace_back(generate);
+    threads.emplace_back(stage, sim_stage::MODULATE, std::ref(*links_m[0]), links_m[1].get(), [this](block& blk) {
+        blk.count = modulator_m.modulate(std::span<const byte>(blk.tx_bits.data(), blk.bytes), blk.symbols);
+    });
+    threads.emplace_back(stage, sim_stage::TRANSMIT, std::ref(*links_m[1]), links_m[2].get(), [this](block& blk) {
+        channel_m.transmit(blk.symbols, blk.symbols, blk.count);
+        if (tap_m) {
+            tap_m(blk.symbols, blk.count);
+        }
+    });
+    threads.emplace_back(stage, sim_stage::DEMODULATE, std::ref(*links_m[2]), links_m[3].get(), [this](block& blk) {
+        demodulator_m.demodulate(blk.symbols, blk.count, std::span<byte>(blk.rx_bits.data(), blk.bytes));
+    });
+    threads.emplace_back(stage, sim_stage::COUNT, std::ref(*links_m[3]), nullptr, [this](block& blk) {
+        counter_m.accumulate(std::span<const byte>(blk.tx_bits.data(), blk.bytes),
+                             std::span<const byte>(blk.rx_bits.data(), blk.bytes));
+    });
+
+    if (cfg_m.pin) {
+        for (size_t s = 0; s < threads.size(); ++s) {
+            pin_thread(threads[s], cfg_m.first_core + s);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            // blocks may be left in the links, drain them for the next run
+            for (auto& link : links_m) {
+                while (link->try_pop(drain)) {}
+            }
+            std::rethrow_exception(error);
+        }
+    }
+
+    counter_m.flush();
+    point.frames = frames;
+    point.bits = static_cast<uint64_t>(frames) * engine_m.frame_bytes * 8;
+    point.errors = counter_m.get_stats().errors;
+    errors_m.merge(counter_m.get_stats());
+
+    stats_m.total_ns += elapsed_ns(start);
+    stats_m.bits += point.bits;
+    for (size_t s = 0; s < PIPELINE_STAGES; ++s) {
+        pipeline_stage_stats& total = stats_m.stages[s];
+        total.blocks += stage_stats[s].blocks;
+        total.busy_ns += stage_stats[s].busy_ns;
+        total.input_waits += stage_stats[s].input_waits;
+        total.output_waits += stage_stats[s].output_waits;
+        total.occupancy_sum += stage_stats[s].occupancy_sum;
+        total.occupancy_max = std::max(total.occupancy_max, stage_stats[s].occupancy_max);
+    }
+    return point;
+}
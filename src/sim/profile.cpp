@@ -0,0 +1,57 @@
+#include "sim/profile.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+void stage_profile::merge(const stage_profile& other) {
+    for (size_t s = 0; s < SIM_STAGE_COUNT; ++s) {
+        stage_ns[s] += other.stage_ns[s];
+    }
+    total_ns += other.total_ns;
+    symbols  += other.symbols;
+    bits     += other.bits;
+}
+
+double stage_profile::symbols_per_second() const {
+    return total_ns ? static_cast<double>(symbols) * 1e9 / static_cast<double>(total_ns) : 0.0;
+}
+
+double stage_profile::bits_per_second() const {
+    return total_ns ? static_cast<double>(bits) * 1e9 / static_cast<double>(total_ns) : 0.0;
+}
+
+double stage_profile::stage_share(sim_stage stage) const {
+    return total_ns ? static_cast<double>(stage_ns[static_cast<size_t>(stage)]) / static_cast<double>(total_ns) : 0.0;
+}
+
+std::string stage_profile::report() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << symbols_per_second() / 1e6 << " Msym/s, " 
+        << bits_per_second() / 1e6 << " Mbit/s";
+
+    if (STAGES_ENABLED) {
+        oss << " |";
+        for (size_t s = 0; s < SIM_STAGE_COUNT; ++s) {
+            if (stage_ns[s] == 0) {
+                continue;
+            }
+            oss << " " << stage_name(static_cast<sim_stage>(s)) << " " 
+                << stage_share(static_cast<sim_stage>(s)) * 100.0 << "%";
+        }
+    }
+
+    return oss.str();
+}
+
+const char* stage_profile::stage_name(sim_stage stage) {
+    switch (stage) {
+        case sim_stage::GENERATE:   return "generate";
+        case sim_stage::MODULATE:   return "modulate";
+        case sim_stage::TRANSMIT:   return "transmit";
+        case sim_stage::DEMODULATE: return "demodulate";
+        case sim_stage::COUNT:      return "count";
+        case sim_stage::FUSED:      return "fused";
+        default:                    return "unknown";
+    }
+}
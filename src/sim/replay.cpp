@@ -0,0 +1,202 @@
+#include "sim/replay.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "phys/qam/qam_demodulator.hpp"
+
+namespace {
+
+/**
+ * @brief Finished chunks waiting for their turn at the sink
+ */
+struct reorder_buffer {
+    std::mutex                                  mutex;
+    std::condition_variable                     ready;      // A chunk was finished or a worker failed
+    std::condition_variable                     space;      // The writer emitted a chunk
+    std::map<size_t, std::vector<byte>>         done;
+    size_t                                      next_emit = 0;
+    std::exception_ptr                          error;
+    bool                                        abort = false;
+};
+
+} // namespace
+
+template<typename DTYPE>
+replay_stats ext_replay_capture(const iq_reader<DTYPE>& reader, std::shared_ptr<mapper_base> mapper,
+                                const replay_config& cfg, const std::function<void(std::span<const byte>)>& sink) {
+    if (!mapper) {
+        throw std::invalid_argument("Mapper cannot be null");
+    }
+    if (cfg.chunk_samples == 0 || cfg.chunk_samples % 8 != 0) {
+        throw std::invalid_argument("chunk_samples must be a positive multiple of 8");
+    }
+    if (cfg.llr && cfg.unit_energy) {
+        // demodulate_llr() works on the raw constellation
+        throw std::invalid_argument("llr replay of a unit-energy capture is not supported");
+    }
+
+    const size_t threads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t max_in_flight = cfg.max_in_flight ? cfg.max_in_flight : 4 * threads;
+    const size_t total = reader.size();
+    const size_t chunks = (total + cfg.chunk_samples - 1) / cfg.chunk_samples;
+    const uint32_t bits_per_symbol = mapper->get_bits_per_symbol();
+
+    // recorded captures rarely know their noise: estimate it from the symbols
+    const double sigma = cfg.sigma > 0 ? cfg.sigma : reader.get_header().sigma;
+    const bool blind = cfg.blind || (cfg.llr && sigma <= 0);
+
+    reorder_buffer buffer;
+    std::atomic<size_t> next_chunk{0};
+    std::mutex quality_mutex;
+    evm_stats quality;
+    noise_estimator<DTYPE> noise(mapper, cfg.estimator, cfg.unit_energy);
+    const auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        try {
+            qam_demodulator<DTYPE> demodulator;
+            demodulator.set_mapper(mapper);
+            demodulator.set_unit_energy(cfg.unit_energy);
+
+            std::unique_ptr<evm_meter<DTYPE>> meter;
+            if (cfg.measure) {
+                meter = std::make_unique<evm_meter<DTYPE>>(mapper, cfg.unit_energy);
+            }
+            std::unique_ptr<noise_estimator<DTYPE>> estimator;
+            if (blind) {
+                estimator = std::make_unique<noise_estimator<DTYPE>>(mapper, cfg.estimator, cfg.unit_energy);
+            }
+
+            auto symbols = complex<DTYPE>::make(cfg.chunk_samples * 2);
+            while (true) {
+                const size_t index = next_chunk.fetch_add(1);
+                if (index >= chunks) {
+                    break;
+                }
+
+                {
+                    std::unique_lock<std::mutex> lock(buffer.mutex);
+                    buffer.space.wait(lock, [&]() { return buffer.abort || index < buffer.next_emit + max_in_flight; });
+                    if (buffer.abort) {
+                        return;
+                    }
+                }
+
+                const size_t first = index * cfg.chunk_samples;
+                const size_t count = std::min(cfg.chunk_samples, total - first);
+                // demodulate_llr() takes the whole container
+                if (cfg.llr && symbols.size() != count * 2) {
+                    symbols = complex<DTYPE>::make(count * 2);
+                }
+                reader.read(first, count, symbols);
+
+                double chunk_sigma = sigma;
+                if (estimator) {
+                    const noise_estimate estimate = estimator->estimate(symbols, count);
+                    if (cfg.sigma <= 0) {
+                        chunk_sigma = estimate.sigma();
+                    }
+                }
+
+                std::vector<byte> bits;
+                if (cfg.llr) {
+                    bits = demodulator.demodulate_llr(symbols, static_cast<DTYPE>(chunk_sigma));
+                } else {
+                    bits.resize((count * bits_per_symbol + 7) / 8);
+                    demodulator.demodulate(symbols, count, bits);
+                }
+                if (meter) {
+                    meter->accumulate(symbols, count);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(buffer.mutex);
+                    buffer.done.emplace(index, std::move(bits));
+                }
+                buffer.ready.notify_one();
+            }
+
+            std::lock_guard<std::mutex> lock(quality_mutex);
+            if (meter) {
+                quality.merge(meter->get_stats());
+            }
+            if (estimator) {
+                noise.merge(*estimator);
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(buffer.mutex);
+                if (!buffer.error) {
+                    buffer.error = std::current_exception();
+                }
+                buffer.abort = true;
+            }
+            buffer.ready.notify_all();
+            buffer.space.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < std::min(threads, std::max<size_t>(chunks, 1)); ++t) {
+        pool.emplace_back(worker);
+    }
+
+    auto stop_pool = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            buffer.abort = true;
+        }
+        buffer.space.notify_all();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    };
+
+    replay_stats stats;
+    try {
+        for (size_t index = 0; index < chunks; ++index) {
+            std::vector<byte> bits;
+            {
+                std::unique_lock<std::mutex> lock(buffer.mutex);
+                buffer.ready.wait(lock, [&]() { return buffer.error || buffer.done.count(index); });
+                if (buffer.error) {
+                    std::rethrow_exception(buffer.error);
+                }
+                auto it = buffer.done.find(index);
+                bits = std::move(it->second);
+                buffer.done.erase(it);
+                buffer.next_emit = index + 1;
+            }
+            buffer.space.notify_all();
+
+            sink(bits);
+            stats.bytes_out += bits.size();
+        }
+    } catch (...) {
+        stop_pool();
+        throw;
+    }
+    stop_pool();
+
+    stats.samples = total;
+    stats.chunks = chunks;
+    stats.bytes_in = total * 2 * sizeof(DTYPE);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.quality = std::move(quality);
+    stats.noise = noise.get_total();
+    return stats;
+}
+
+template replay_stats ext_replay_capture<float>(const iq_reader<float>&, std::shared_ptr<mapper_base>,
+                                                const replay_config&, const std::function<void(std::span<const byte>)>&);
+template replay_stats ext_replay_capture<double>(const iq_reader<double>&, std::shared_ptr<mapper_base>,
+                                                 const replay_config&, const std::function<void(std::span<const byte>)>&);
@@ -0,0 +1,90 @@
+#include "sim/result_cache.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#include "file/binary_io.hpp"
+
+namespace {
+
+constexpr const char* KIND = "result cache";
+constexpr char MAGIC[4] = {'Y', 'Q', 'R', 'C'};
+
+} // namespace
+
+result_cache::result_cache(const std::string& filename) : filename_m(filename) {}
+
+bool result_cache::load() {
+    std::ifstream file(filename_m, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    if (!ext_read_magic(file, MAGIC)) {
+        throw std::runtime_error("Not a result cache file: " + filename_m);
+    }
+
+    uint32_t version = 0;
+    ext_read_value(file, version, KIND);
+    if (version != VERSION) {
+        throw std::runtime_error("Unsupported result cache version in " + filename_m);
+    }
+
+    uint64_t count = 0;
+    ext_read_value(file, count, KIND);
+
+    std::unordered_map<uint64_t, ber_point> entries;
+    for (uint64_t n = 0; n < count; ++n) {
+        uint64_t key = 0;
+        ber_point point;
+        ext_read_value(file, key, KIND);
+        ext_read_value(file, point.sigma, KIND);
+        ext_read_value(file, point.bits, KIND);
+        ext_read_value(file, point.errors, KIND);
+        ext_read_value(file, point.frames, KIND);
+        entries[key] = point;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_m);
+    entries_m = std::move(entries);
+    return true;
+}
+
+void result_cache::save() const {
+    std::lock_guard<std::mutex> lock(mutex_m);
+    ext_replace_file(filename_m, [this](std::ofstream& file) {
+        file.write(MAGIC, sizeof(MAGIC));
+        ext_write_value(file, VERSION);
+        ext_write_value(file, static_cast<uint64_t>(entries_m.size()));
+
+        for (const auto& [key, point] : entries_m) {
+            ext_write_value(file, key);
+            ext_write_value(file, point.sigma);
+            ext_write_value(file, point.bits);
+            ext_write_value(file, point.errors);
+            ext_write_value(file, point.frames);
+        }
+    }, KIND);
+}
+
+std::optional<ber_point> result_cache::find(uint64_t key) const {
+    std::lock_guard<std::mutex> lock(mutex_m);
+    auto it = entries_m.find(key);
+    if (it == entries_m.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void result_cache::store(uint64_t key, const ber_point& point) {
+    std::lock_guard<std::mutex> lock(mutex_m);
+    auto it = entries_m.find(key);
+    if (it == entries_m.end() || it->second.frames < point.frames) {
+        entries_m[key] = point;
+    }
+}
+
+size_t result_cache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_m);
+    return entries_m.size();
+}
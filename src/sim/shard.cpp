@@ -0,0 +1,199 @@
+#include "sim/shard.hpp"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "file/binary_io.hpp"
+#include "phys/qam/mapper.hpp"
+#include "sim/hash.hpp"
+
+namespace {
+
+constexpr const char* KIND = "shard";
+constexpr char MAGIC[4] = {'Y', 'Q', 'S', 'H'};
+constexpr uint32_t VERSION = 1;
+
+std::vector<shard_cell> make_cells(const shard_plan& plan) {
+    std::vector<shard_cell> cells;
+    for (qam_order order : plan.modulations) {
+        for (double sigma : plan.sigmas) {
+            shard_cell cell;
+            cell.modulation = order;
+            cell.point.sigma = sigma;
+            cells.push_back(cell);
+        }
+    }
+    return cells;
+}
+
+void write_shard_file(const std::string& filename, const shard_plan& plan, 
+                      uint32_t shard_index, const std::vector<shard_cell>& cells) {
+    ext_replace_file(filename, [&](std::ofstream& file) {
+        file.write(MAGIC, sizeof(MAGIC));
+        ext_write_value(file, VERSION);
+        ext_write_value(file, plan.hash());
+        ext_write_value(file, shard_index);
+        ext_write_value(file, plan.shard_count);
+        ext_write_value(file, static_cast<uint64_t>(cells.size()));
+
+        for (const auto& cell : cells) {
+            ext_write_value(file, static_cast<uint32_t>(cell.modulation));
+            ext_write_value(file, cell.point.sigma);
+            ext_write_value(file, cell.point.bits);
+            ext_write_value(file, cell.point.errors);
+            ext_write_value(file, cell.point.frames);
+        }
+    }, KIND);
+}
+
+} // namespace
+
+uint64_t shard_plan::hash() const {
+    uint64_t h = FNV1A_BASIS;
+    for (qam_order order : modulations) {
+        h = fnv1a(h, static_cast<uint32_t>(order));
+    }
+    for (double sigma : sigmas) {
+        h = fnv1a(h, sigma);
+    }
+    h = fnv1a(h, blocks_per_point);
+    h = fnv1a(h, frames_per_block);
+    h = fnv1a(h, shard_count);
+    h = fnv1a(h, engine.frame_bytes);
+    h = fnv1a(h, engine.tile_bytes);
+    h = fnv1a(h, static_cast<uint32_t>(engine.unit_energy));
+    h = fnv1a(h, static_cast<uint32_t>(engine.fused));
+    h = fnv1a(h, engine.seed);
+    return h;
+}
+
+std::string shard_file_name(const std::string& directory, uint32_t shard_index) {
+    return directory + "/shard_" + std::to_string(shard_index) + ".bin";
+}
+
+template<typename DTYPE>
+std::vector<shard_cell> run_shard(const shard_plan& plan, uint32_t shard_index, const std::string& filename) {
+    if (plan.shard_count == 0 || shard_index >= plan.shard_count) {
+        throw std::invalid_argument("shard_index must be < shard_count");
+    }
+    if (plan.engine.seed == 0) {
+        throw std::invalid_argument("sharded sweeps need a fixed seed");
+    }
+
+    std::vector<shard_cell> cells = make_cells(plan);
+
+    // one engine per modulation, reused for all items of the shard
+    std::vector<typename sim_engine<DTYPE>::ptr> engines;
+    for (qam_order order : plan.modulations) {
+        engines.push_back(sim_engine<DTYPE>::make(ext_make_mapper<DTYPE>(order), plan.engine));
+    }
+
+    const uint64_t items_per_modulation = static_cast<uint64_t>(plan.sigmas.size()) * plan.blocks_per_point;
+
+    for (uint64_t item = shard_index; item < plan.item_count(); item += plan.shard_count) {
+        const size_t modulation_index = item / items_per_modulation;
+        const size_t sigma_index = (item % items_per_modulation) / plan.blocks_per_point;
+
+        auto& engine = *engines[modulation_index];
+        engine.reseed(plan.engine.seed, item);
+
+        shard_cell& cell = cells[modulation_index * plan.sigmas.size() + sigma_index];
+        cell.point.merge(engine.run(plan.sigmas[sigma_index], plan.frames_per_block));
+    }
+
+    write_shard_file(filename, plan, shard_index, cells);
+    return cells;
+}
+
+std::vector<shard_cell> merge_shards(const shard_plan& plan, const std::string& directory) {
+    std::vector<shard_cell> cells = make_cells(plan);
+    const uint64_t expected_hash = plan.hash();
+
+    for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+        const std::string filename = shard_file_name(directory, shard);
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Missing shard file: " + filename);
+        }
+
+        if (!ext_read_magic(file, MAGIC)) {
+            throw std::runtime_error("Not a shard file: " + filename);
+        }
+
+        uint32_t version = 0, shard_index = 0, shard_count = 0;
+        uint64_t hash = 0, count = 0;
+        ext_read_value(file, version, KIND);
+        ext_read_value(file, hash, KIND);
+        ext_read_value(file, shard_index, KIND);
+        ext_read_value(file, shard_count, KIND);
+        ext_read_value(file, count, KIND);
+
+        if (version != VERSION || hash != expected_hash || shard_index != shard || count != cells.size()) {
+            throw std::runtime_error("Shard file belongs to another plan: " + filename);
+        }
+
+        for (auto& cell : cells) {
+            uint32_t modulation = 0;
+            ber_point point;
+            ext_read_value(file, modulation, KIND);
+            ext_read_value(file, point.sigma, KIND);
+            ext_read_value(file, point.bits, KIND);
+            ext_read_value(file, point.errors, KIND);
+            ext_read_value(file, point.frames, KIND);
+
+            if (modulation != static_cast<uint32_t>(cell.modulation) || point.sigma != cell.point.sigma) {
+                throw std::runtime_error("Shard file cell mismatch: " + filename);
+            }
+            cell.point.merge(point);
+        }
+    }
+
+    return cells;
+}
+
+template<typename DTYPE>
+std::vector<shard_cell> launch_local_shards(const shard_plan& plan, const std::string& directory) {
+    std::vector<pid_t> workers;
+
+    for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            throw std::runtime_error("fork() failed");
+        }
+
+        if (pid == 0) {
+            int status = EXIT_SUCCESS;
+            try {
+                run_shard<DTYPE>(plan, shard, shard_file_name(directory, shard));
+            } catch (...) {
+                status = EXIT_FAILURE;
+            }
+            _exit(status);
+        }
+
+        workers.push_back(pid);
+    }
+
+    bool failed = false;
+    for (pid_t pid : workers) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        throw std::runtime_error("A shard worker failed");
+    }
+
+    return merge_shards(plan, directory);
+}
+
+template std::vector<shard_cell> run_shard<float>(const shard_plan&, uint32_t, const std::string&);
+template std::vector<shard_cell> run_shard<double>(const shard_plan&, uint32_t, const std::string&);
+template std::vector<shard_cell> launch_local_shards<float>(const shard_plan&, const std::string&);
+template std::vector<shard_cell> launch_local_shards<double>(const shard_plan&, const std::string&);
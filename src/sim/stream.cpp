@@ -0,0 +1,94 @@
+#include "sim/stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "file/async_io.hpp"
+#include "phys/qam/qam_modulator.hpp"
+
+template<typename DTYPE>
+stream_stats ext_stream_modulate(const std::string& input, const std::string& output,
+                                 std::shared_ptr<mapper_base> mapper, const stream_config& cfg) {
+    if (!mapper) {
+        throw std::invalid_argument("Mapper cannot be null");
+    }
+    if (cfg.block_bytes == 0) {
+        throw std::invalid_argument("block_bytes must be > 0");
+    }
+
+    async_io_config io = cfg.io;
+    io.block_bytes = cfg.block_bytes;
+    block_source source(input, io);
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint32_t bits_per_symbol = mapper->get_bits_per_symbol();
+    // bytes of the smallest run of whole symbols (1 for QPSK / QAM16, 3 for QAM64)
+    const size_t group = std::lcm<size_t>(8, bits_per_symbol) / 8;
+    const size_t max_symbols = ((group + source.block_bytes()) * 8 + bits_per_symbol - 1) / bits_per_symbol;
+
+    qam_modulator<DTYPE> modulator;
+    modulator.set_mapper(mapper);
+    modulator.set_unit_energy(cfg.unit_energy);
+
+    iq_metadata meta = cfg.iq;
+    meta.modulation = mapper->get_order();
+    iq_writer<DTYPE> writer(output, meta);
+
+    // a block is copied behind the bytes carried from the previous one
+    std::vector<byte> in(group + source.block_bytes());
+    complex<DTYPE> out[2] = {complex<DTYPE>::make(max_symbols * 2), complex<DTYPE>::make(max_symbols * 2)};
+
+    const auto policy = cfg.background ? std::launch::async : std::launch::deferred;
+    std::future<void> pending_write;
+
+    stream_stats stats;
+    size_t carry = 0;
+    for (size_t cur = 0;; cur ^= 1) {
+        const std::span<const byte> block = source.next();
+        if (block.empty() && carry == 0) {
+            break;
+        }
+        stats.bytes_in += block.size();
+        stats.blocks += !block.empty();
+
+        // the last block takes the partial group
+        const bool last = stats.bytes_in == source.size();
+        std::copy(block.begin(), block.end(), in.begin() + static_cast<std::ptrdiff_t>(carry));
+        const size_t bytes = carry + block.size();
+        const size_t whole = last ? bytes : bytes / group * group;
+
+        const size_t count = modulator.modulate(std::span<const byte>(in.data(), whole), out[cur]);
+        carry = bytes - whole;
+        std::copy_n(in.begin() + static_cast<std::ptrdiff_t>(whole), carry, in.begin());
+
+        // the write of out[cur] two blocks ago was waited for in the previous round
+        if (pending_write.valid()) {
+            pending_write.get();
+        }
+        pending_write = std::async(policy, [&writer, &symbols = out[cur], count]() {
+            writer.append(symbols, count);
+        });
+        stats.samples += count;
+
+        if (last) {
+            break;
+        }
+    }
+
+    if (pending_write.valid()) {
+        pending_write.get();
+    }
+    writer.close();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+template stream_stats ext_stream_modulate<float>(const std::string&, const std::string&,
+                                                 std::shared_ptr<mapper_base>, const stream_config&);
+template stream_stats ext_stream_modulate<double>(const std::string&, const std::string&,
+                                                  std::shared_ptr<mapper_base>, const stream_config&);
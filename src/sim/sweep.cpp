@@ -0,0 +1,84 @@
+#include "sim/sweep.hpp"
+
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+
+adaptive_sweep::adaptive_sweep(const config& cfg) : cfg_m(cfg) {
+    if (cfg_m.coarse_points < 2) {
+        throw std::invalid_argument("coarse_points must be >= 2");
+    }
+    if (cfg_m.sigma_end <= cfg_m.sigma_start) {
+        throw std::invalid_argument("sigma_end must be > sigma_start");
+    }
+    if (cfg_m.point_budget < cfg_m.coarse_points) {
+        cfg_m.point_budget = cfg_m.coarse_points;
+    }
+}
+
+double adaptive_sweep::interval_score(const ber_point& left, const ber_point& right) {
+    return std::fabs(std::log10(right.resolved_ber()) - std::log10(left.resolved_ber()));
+}
+
+std::vector<ber_point> adaptive_sweep::run(const evaluator& eval) {
+    struct interval {
+        double score;
+        double left;
+        double right;
+
+        bool operator<(const interval& other) const { 
+            return score < other.score;
+        }
+    };
+
+    std::map<double, ber_point> points;
+    std::priority_queue<interval> queue;
+
+    auto push_interval = [&](const ber_point& left, const ber_point& right) {
+        if (right.sigma - left.sigma < 2 * cfg_m.min_step) {
+            return;
+        }
+
+        double score = interval_score(left, right);
+        if (score < cfg_m.tolerance) {
+            return;
+        }
+
+        queue.push({score, left.sigma, right.sigma});
+    };
+
+    // Coarse uniform grid
+    const double step = (cfg_m.sigma_end - cfg_m.sigma_start) / (cfg_m.coarse_points - 1);
+    for (size_t i = 0; i < cfg_m.coarse_points; ++i) {
+        double sigma = (i + 1 == cfg_m.coarse_points) ? cfg_m.sigma_end : cfg_m.sigma_start + i * step;
+        ber_point point = eval(sigma);
+        point.sigma = sigma;
+        points[sigma] = point;
+    }
+
+    for (auto it = points.begin(); std::next(it) != points.end(); ++it) {
+        push_interval(it->second, std::next(it)->second);
+    }
+
+    // Refinement: always split the steepest interval
+    while (points.size() < cfg_m.point_budget && !queue.empty()) {
+        interval top = queue.top();
+        queue.pop();
+
+        double middle = 0.5 * (top.left + top.right);
+        ber_point point = eval(middle);
+        point.sigma = middle;
+        points[middle] = point;
+
+        push_interval(points.at(top.left), point);
+        push_interval(point, points.at(top.right));
+    }
+
+    std::vector<ber_point> result;
+    result.reserve(points.size());
+    for (const auto& [sigma, point] : points) {
+        result.push_back(point);
+    }
+
+    return result;
+}
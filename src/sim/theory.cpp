@@ -0,0 +1,192 @@
+#include "sim/theory.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+uint32_t side_levels(qam_order order) {
+    switch (order) {
+        case qam_order::QPSK:   return 2;
+        case qam_order::QAM16:  return 4;
+        case qam_order::QAM64:  return 8;
+        default:
+            throw std::invalid_argument("Unsupported modulation order");
+    }
+}
+
+std::vector<double> unique_sorted(std::vector<double> levels) {
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    return levels;
+}
+
+} // namespace
+
+double ext_qfunc(double x) {
+    return 0.5 * std::erfc(x / std::sqrt(2.0));
+}
+
+double ext_gray_qam_ber(qam_order order, double ebn0_db) {
+    const double m = static_cast<double>(order);
+    const double k = ext_get_bits_per_symbol(order);
+    const uint32_t side = side_levels(order);
+    const double ebn0 = std::pow(10.0, ebn0_db / 10.0);
+    const double argument = std::sqrt(3.0 * k * ebn0 / (m - 1.0));
+
+    double sum = 0.0;
+    for (uint32_t i = 1; i <= side / 2; ++i) {
+        sum += ext_qfunc((2.0 * i - 1.0) * argument);
+    }
+    return 4.0 / k * (1.0 - 1.0 / side) * sum;
+}
+
+std::vector<double> ext_gray_qam_ber(qam_order order, std::span<const double> ebn0_db) {
+    std::vector<double> ber(ebn0_db.size());
+    std::transform(ebn0_db.begin(), ebn0_db.end(), ber.begin(), [order](double value) {
+        return ext_gray_qam_ber(order, value);
+    });
+    return ber;
+}
+
+double ext_gray_qam_ser(qam_order order, double esn0_db) {
+    const double m = static_cast<double>(order);
+    const uint32_t side = side_levels(order);
+    const double esn0 = std::pow(10.0, esn0_db / 10.0);
+
+    const double axis = 2.0 * (1.0 - 1.0 / side) * ext_qfunc(std::sqrt(3.0 * esn0 / (m - 1.0)));
+    return 1.0 - (1.0 - axis) * (1.0 - axis);
+}
+
+std::vector<double> ext_gray_qam_ser(qam_order order, std::span<const double> esn0_db) {
+    std::vector<double> ser(esn0_db.size());
+    std::transform(esn0_db.begin(), esn0_db.end(), ser.begin(), [order](double value) {
+        return ext_gray_qam_ser(order, value);
+    });
+    return ser;
+}
+
+constellation_theory::constellation_theory(const qam_table<double>& table, uint32_t bits_per_symbol)
+    : bits_per_symbol_m(bits_per_symbol) {
+    std::vector<double> levels_i;
+    std::vector<double> levels_q;
+    for (const auto& point : table.points) {
+        levels_i.push_back(point.i);
+        levels_q.push_back(point.q);
+        symbol_energy_m += point.i * point.i + point.q * point.q;
+    }
+    if (table.points.empty()) {
+        throw std::invalid_argument("Empty constellation table");
+    }
+    symbol_energy_m /= table.points.size();
+
+    levels_i_m = unique_sorted(levels_i);
+    levels_q_m = unique_sorted(levels_q);
+    if (levels_i_m.size() * levels_q_m.size() != table.points.size()) {
+        throw std::invalid_argument("Constellation is not a rectangular grid");
+    }
+
+    grid_index_m.assign(table.points.size(), std::numeric_limits<uint32_t>::max());
+    for (size_t p = 0; p < table.points.size(); ++p) {
+        size_t li = std::lower_bound(levels_i_m.begin(), levels_i_m.end(), table.points[p].i) - levels_i_m.begin();
+        size_t lq = std::lower_bound(levels_q_m.begin(), levels_q_m.end(), table.points[p].q) - levels_q_m.begin();
+        uint32_t& cell = grid_index_m[li * levels_q_m.size() + lq];
+        if (cell != std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Constellation is not a rectangular grid");
+        }
+        cell = table.indices[p];
+    }
+}
+
+std::vector<double> constellation_theory::axis_transitions(const std::vector<double>& levels, double sigma) const {
+    const size_t n = levels.size();
+    std::vector<double> transitions(n * n, 0.0);
+
+    for (size_t a = 0; a < n; ++a) {
+        for (size_t j = 0; j < n; ++j) {
+            // decision region of level j: (t_{j-1}, t_j], thresholds at the midpoints
+            double upper = (j + 1 < n) ? (levels[j] + levels[j + 1]) / 2 : std::numeric_limits<double>::infinity();
+            double lower = (j > 0) ? (levels[j - 1] + levels[j]) / 2 : -std::numeric_limits<double>::infinity();
+
+            if (sigma <= 0) {
+                transitions[a * n + j] = (a == j) ? 1.0 : 0.0;
+                continue;
+            }
+            // P(lower < L_a + n <= upper) = Q((lower - L_a) / sigma) - Q((upper - L_a) / sigma)
+            transitions[a * n + j] = ext_qfunc((lower - levels[a]) / sigma) - ext_qfunc((upper - levels[a]) / sigma);
+        }
+    }
+
+    return transitions;
+}
+
+theory_point constellation_theory::at_sigma(double sigma) const {
+    const size_t ni = levels_i_m.size();
+    const size_t nq = levels_q_m.size();
+    const std::vector<double> pi = axis_transitions(levels_i_m, sigma);
+    const std::vector<double> pq = axis_transitions(levels_q_m, sigma);
+
+    double bit_errors = 0.0;
+    double correct = 0.0;
+
+    for (size_t si = 0; si < ni; ++si) {
+        for (size_t sq = 0; sq < nq; ++sq) {
+            const uint32_t sent = grid_index_m[si * nq + sq];
+            correct += pi[si * ni + si] * pq[sq * nq + sq];
+
+            for (size_t ti = 0; ti < ni; ++ti) {
+                for (size_t tq = 0; tq < nq; ++tq) {
+                    const uint32_t decided = grid_index_m[ti * nq + tq];
+                    if (decided == sent) {
+                        continue;
+                    }
+                    bit_errors += pi[si * ni + ti] * pq[sq * nq + tq] * std::popcount(sent ^ decided);
+                }
+            }
+        }
+    }
+
+    const double symbols = static_cast<double>(ni * nq);
+    theory_point point;
+    point.ber = bit_errors / (symbols * bits_per_symbol_m);
+    point.ser = 1.0 - correct / symbols;
+    return point;
+}
+
+std::vector<theory_point> constellation_theory::at_sigma(std::span<const double> sigmas) const {
+    std::vector<theory_point> points;
+    points.reserve(sigmas.size());
+    for (double sigma : sigmas) {
+        points.push_back(at_sigma(sigma));
+    }
+    return points;
+}
+
+uint64_t ext_plan_frames(double expected_ber, uint64_t bits_per_frame, uint64_t target_errors,
+                         uint64_t min_frames, uint64_t max_frames) {
+    if (bits_per_frame == 0 || min_frames > max_frames) {
+        throw std::invalid_argument("bits_per_frame must be > 0 and min_frames <= max_frames");
+    }
+    if (expected_ber <= 0) {
+        return max_frames;
+    }
+
+    const double frames = std::ceil(static_cast<double>(target_errors) / (expected_ber * bits_per_frame));
+    if (frames >= static_cast<double>(max_frames)) {
+        return max_frames;
+    }
+    return std::max<uint64_t>(min_frames, static_cast<uint64_t>(frames));
+}
+
+double ext_ber_deviation(const ber_point& point, double expected_ber) {
+    if (point.bits == 0) {
+        return 0.0;
+    }
+
+    const double n = static_cast<double>(point.bits);
+    const double p = std::clamp(expected_ber, 1.0 / (n * n), 1.0 - 1.0 / (n * n));
+    return (static_cast<double>(point.errors) - n * p) / std::sqrt(n * p * (1.0 - p));
+}
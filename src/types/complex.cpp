@@ -44,6 +44,18 @@ std::array<std::span<DTYPE>, 2> complex<DTYPE>::decompose() {
     };
 }
 
+template<typename DTYPE>
+std::array<std::span<const DTYPE>, 2> complex<DTYPE>::decompose() const { 
+    const size_t half = size_m / 2; 
+
+    const DTYPE* data_ptr = arr_m.get(); 
+
+    return {
+        std::span<const DTYPE>(data_ptr, half),         // i
+        std::span<const DTYPE>(data_ptr + half, half)   // q
+    };
+}
+
 template<typename DTYPE> 
 void complex<DTYPE>::store(const complex_t<DTYPE>& val, size_t index) { 
     if (index >= size_m) { 
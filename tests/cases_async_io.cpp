@@ -0,0 +1,135 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "file/async_io.hpp"
+
+const char* IO_FILE = "cases_async_io.bin";
+
+std::vector<byte> make_data(size_t size) {
+    std::vector<byte> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<byte>(i * 7 + (i >> 12));
+    }
+    return data;
+}
+
+std::vector<byte> read_file(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<byte>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * TEST: uneven writes through the sink, blocks in order through the source
+ */
+bool test_round_trip(io_backend backend, bool direct) {
+    async_io_config cfg;
+    cfg.backend = backend;
+    cfg.block_bytes = 8192;
+    cfg.queue_depth = 3;
+    cfg.direct = direct;
+
+    // 10 full blocks and a short one
+    const std::vector<byte> data = make_data(10 * 8192 + 1234);
+    {
+        block_sink sink(IO_FILE, cfg);
+        size_t done = 0;
+        for (size_t chunk = 1; done < data.size(); chunk = chunk * 3 + 1) {
+            const size_t count = std::min(chunk, data.size() - done);
+            sink.write(std::span<const byte>(data.data() + done, count));
+            done += count;
+        }
+        assert(sink.size() == data.size() && "sink size mismatch");
+        sink.close();
+    }
+    assert(read_file(IO_FILE) == data && "written file mismatch");
+
+    block_source source(IO_FILE, cfg);
+    assert(source.size() == data.size() && "source size mismatch");
+    std::vector<byte> back;
+    size_t blocks = 0;
+    for (auto block = source.next(); !block.empty(); block = source.next()) {
+        assert((block.size() == 8192 || back.size() + block.size() == data.size()) && "only the last block is short");
+        back.insert(back.end(), block.begin(), block.end());
+        ++blocks;
+    }
+    assert(blocks == 11 && back == data && "read back mismatch");
+    assert(source.next().empty() && "source must stay at the end");
+
+    std::remove(IO_FILE);
+    return true;
+}
+
+/**
+ * TEST: source abandoned with reads in flight, empty files, missing files
+ */
+bool test_edges() {
+    async_io_config cfg;
+    cfg.backend = io_backend::THREADS;
+    cfg.block_bytes = 4096;
+    {
+        block_sink sink(IO_FILE, cfg);
+        const std::vector<byte> data = make_data(64 * 1024);
+        sink.write(data);
+    }
+    assert(read_file(IO_FILE).size() == 64 * 1024 && "destructor must flush");
+    {
+        block_source source(IO_FILE, cfg);
+        assert(source.next().size() == 4096 && "first block mismatch");
+    }
+
+    { block_sink sink(IO_FILE, cfg); }
+    block_source empty(IO_FILE, cfg);
+    assert(empty.size() == 0 && empty.next().empty() && "empty file must give no blocks");
+    std::remove(IO_FILE);
+
+    bool thrown = false;
+    try {
+        block_source source(IO_FILE, cfg);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "missing file must throw");
+
+    thrown = false;
+    try {
+        block_sink sink(IO_FILE, cfg);
+        sink.acquire();
+        sink.commit(100);
+        sink.acquire();
+        sink.commit(4096);
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    assert(thrown && "a short block must be the last one");
+
+    std::remove(IO_FILE);
+    return true;
+}
+
+int main() {
+    assert(test_round_trip(io_backend::THREADS, true) == true && "test_round_trip(THREADS, direct) != true");
+    assert(test_round_trip(io_backend::THREADS, false) == true && "test_round_trip(THREADS, buffered) != true");
+    assert(test_round_trip(io_backend::AUTO, true) == true && "test_round_trip(AUTO, direct) != true");
+
+    // io_uring is refused by some kernels and sandboxes, AUTO covers the fallback then
+    bool uring = true;
+    try {
+        io_engine::make(io_backend::URING, 4);
+    } catch (const std::runtime_error&) {
+        uring = false;
+        std::cout << "io_uring not available, skipping the URING backend" << std::endl;
+    }
+    if (uring) {
+        assert(test_round_trip(io_backend::URING, true) == true && "test_round_trip(URING, direct) != true");
+        assert(test_round_trip(io_backend::URING, false) == true && "test_round_trip(URING, buffered) != true");
+    }
+    assert(test_edges() == true && "test_edges() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "sim/bit_source.hpp"
+
+/**
+ * TEST: same (seed, stream) -> same bits, different stream -> different bits
+ */
+bool test_random_determinism() {
+    std::vector<byte> a(1001), b(1001), c(1001);
+
+    random_bit_source src_a(1234, 0);
+    random_bit_source src_b(1234, 0);
+    random_bit_source src_c(1234, 1);
+
+    src_a.fill(a);
+    src_b.fill(b);
+    src_c.fill(c);
+
+    assert(a == b && "same seed and stream must give the same bits");
+    assert(a != c && "different streams must give different bits");
+    assert(src_a.get_position() == (1001 + 7) / 8 && "position must count drawn words");
+
+    return true;
+}
+
+/**
+ * TEST: state save / restore continues the stream exactly
+ */
+bool test_random_state_restore() {
+    random_bit_source src(99, 3);
+    std::vector<byte> head(64), tail(256), resumed(256);
+
+    src.fill(head);
+    auto state = src.get_state();
+    auto position = src.get_position();
+    src.fill(tail);
+
+    random_bit_source other(0, 0);
+    other.set_state(state, position);
+    other.fill(resumed);
+
+    assert(tail == resumed && "restored stream must continue exactly");
+    assert(other.get_position() == src.get_position() && "restored position mismatch");
+
+    return true;
+}
+
+/**
+ * TEST: bits are roughly balanced
+ */
+bool test_random_balance() {
+    random_bit_source src(7);
+    std::vector<byte> bits(1 << 16);
+    src.fill(bits);
+
+    size_t ones = 0;
+    for (byte b : bits) {
+        ones += std::popcount(b);
+    }
+
+    double ratio = static_cast<double>(ones) / (bits.size() * 8);
+    assert(ratio > 0.49 && ratio < 0.51 && "random bits are not balanced");
+
+    return true;
+}
+
+/**
+ * TEST: gaussian samples are reproducible and independent of the payload stream
+ */
+bool test_gaussian_determinism() {
+    gaussian_source a(1234, 0);
+    gaussian_source b(1234, 0);
+    gaussian_source c(1234, 1);
+    random_bit_source payload(1234, 0);
+
+    bool same = true;
+    bool other_stream = false;
+    for (int k = 0; k < 1000; ++k) {
+        const double x = a.next();
+        same = same && x == b.next();
+        other_stream = other_stream || x != c.next();
+    }
+    assert(same && "same seed and stream must give the same samples");
+    assert(other_stream && "different streams must give different samples");
+    assert(payload.next_word() != gaussian_source(1234, 0).get_bit_source().next_word() &&
+           "noise must not reuse the payload sequence");
+
+    // the uniform words carry the whole state
+    random_bit_source& words = a.get_bit_source();
+    gaussian_source resumed(0, 0);
+    resumed.get_bit_source().set_state(words.get_state(), words.get_position());
+    assert(resumed.next() == a.next() && "restored stream must continue exactly");
+    return true;
+}
+
+/**
+ * TEST: moments and tail probabilities of the samples match N(0, 1)
+ */
+bool test_gaussian_distribution() {
+    gaussian_source src(7);
+    const size_t count = 1 << 21;
+    const double thresholds[] = {0.5, 1.0, 2.0, 3.0, 3.5};
+    size_t beyond[5] = {};
+
+    double sum = 0.0, sum_sq = 0.0, sum_4 = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        const double x = src.next();
+        sum += x;
+        sum_sq += x * x;
+        sum_4 += x * x * x * x;
+        for (size_t t = 0; t < 5; ++t) {
+            beyond[t] += std::fabs(x) > thresholds[t];
+        }
+    }
+
+    const double mean = sum / count;
+    const double var = sum_sq / count;
+    assert(std::fabs(mean) < 0.005 && "gaussian mean is not 0");
+    assert(std::fabs(var - 1.0) < 0.005 && "gaussian variance is not 1");
+    assert(std::fabs(sum_4 / count / (var * var) - 3.0) < 0.05 && "gaussian kurtosis is not 3");
+
+    // P(|x| > t) within 5 standard deviations of the binomial count
+    for (size_t t = 0; t < 5; ++t) {
+        const double p = std::erfc(thresholds[t] / std::sqrt(2.0));
+        const double expected = p * count;
+        assert(std::fabs(beyond[t] - expected) < 5.0 * std::sqrt(expected * (1.0 - p)) && "gaussian tail mismatch");
+    }
+    return true;
+}
+
+/**
+ * Reference serial LFSR: b[t] = b[t - k] ^ b[t - n], register initialised to ones
+ */
+std::vector<int> serial_prbs(uint32_t n, uint32_t k, size_t length) {
+    std::vector<int> seq(n, 1);
+    for (size_t t = n; t < n + length; ++t) {
+        seq.push_back(seq[t - k] ^ seq[t - n]);
+    }
+    return std::vector<int>(seq.begin() + n, seq.end());
+}
+
+/**
+ * TEST: bit-parallel PRBS matches the serial recurrence
+ */
+bool test_prbs_matches_serial(prbs_type type, uint32_t n, uint32_t k) {
+    const size_t length = 4096;
+    auto reference = serial_prbs(n, k, length * 8);
+
+    prbs_bit_source src(type);
+    std::vector<byte> bits(length);
+
+    // two fills to cover carrying bits across calls
+    src.fill(std::span<byte>(bits.data(), 13));
+    src.fill(std::span<byte>(bits.data() + 13, length - 13));
+
+    for (size_t i = 0; i < length * 8; ++i) {
+        int bit = (bits[i / 8] >> (7 - i % 8)) & 0x1;
+        assert(bit == reference[i] && "PRBS bit mismatch");
+    }
+
+    return true;
+}
+
+/**
+ * TEST: PRBS7 has period 127
+ */
+bool test_prbs7_period() {
+    prbs_bit_source src(prbs_type::PRBS7);
+    assert(src.get_period() == 127 && "PRBS7 period must be 127");
+
+    std::vector<byte> bits(127 * 2);
+    src.fill(bits);
+
+    for (size_t i = 0; i < 127 * 8; ++i) {
+        int a = (bits[i / 8] >> (7 - i % 8)) & 0x1;
+        int b = (bits[(i + 127) / 8] >> (7 - (i + 127) % 8)) & 0x1;
+        assert(a == b && "PRBS7 is not periodic with 127");
+    }
+
+    try {
+        prbs_bit_source zero(prbs_type::PRBS15, 0);
+        assert(false && "zero seed should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    return true;
+}
+
+int main() {
+    assert(test_random_determinism() == true && "test_random_determinism() != true");
+    assert(test_random_state_restore() == true && "test_random_state_restore() != true");
+    assert(test_random_balance() == true && "test_random_balance() != true");
+    assert(test_gaussian_determinism() == true && "test_gaussian_determinism() != true");
+    assert(test_gaussian_distribution() == true && "test_gaussian_distribution() != true");
+
+    assert(test_prbs_matches_serial(prbs_type::PRBS7, 7, 6) == true && "test_prbs_matches_serial(PRBS7) != true");
+    assert(test_prbs_matches_serial(prbs_type::PRBS15, 15, 14) == true && "test_prbs_matches_serial(PRBS15) != true");
+    assert(test_prbs_matches_serial(prbs_type::PRBS23, 23, 18) == true && "test_prbs_matches_serial(PRBS23) != true");
+    assert(test_prbs_matches_serial(prbs_type::PRBS31, 31, 28) == true && "test_prbs_matches_serial(PRBS31) != true");
+    assert(test_prbs7_period() == true && "test_prbs7_period() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "phys/qam/mapper.hpp"
+#include "sim/checkpoint.hpp"
+#include "sim/engine.hpp"
+
+/**
+ * TEST: records survive a save / load round trip
+ */
+bool test_checkpoint_round_trip() {
+    const std::string filename = "cases_checkpoint_round_trip.ckpt";
+    std::remove(filename.c_str());
+
+    sweep_checkpoint checkpoint(filename, 42);
+    assert(checkpoint.load() == false && "missing file must not load");
+
+    checkpoint_record record;
+    record.point.sigma  = 0.75;
+    record.point.bits   = 1000;
+    record.point.errors = 12;
+    record.point.frames = 4;
+    record.rng_state    = {1, 2, 3, 4};
+    record.rng_position = 77;
+    record.noise_state  = {5, 6, 7, 8};
+    record.noise_position = 91;
+    checkpoint.update(record, true);
+
+    sweep_checkpoint restored(filename, 42);
+    assert(restored.load() == true && "saved checkpoint must load");
+
+    auto loaded = restored.find(0.75);
+    assert(loaded.has_value() && "record not found");
+    assert(loaded->point.bits == 1000 && loaded->point.errors == 12 && loaded->point.frames == 4 && "counts mismatch");
+    assert(loaded->rng_state == record.rng_state && loaded->rng_position == 77 && "rng state mismatch");
+    assert(loaded->noise_state == record.noise_state && loaded->noise_position == 91 && "noise state mismatch");
+    assert(!restored.find(0.5).has_value() && "unknown sigma must not be found");
+
+    restored.remove();
+    assert(!restored.find(0.75).has_value() && !std::ifstream(filename).is_open() && "remove() must delete the file");
+    return true;
+}
+
+/**
+ * TEST: a checkpoint written with other settings is rejected
+ */
+bool test_checkpoint_other_settings() {
+    const std::string filename = "cases_checkpoint_settings.ckpt";
+    std::remove(filename.c_str());
+
+    engine_config cfg;
+    cfg.frame_bytes = 3000;
+    cfg.seed        = 5;
+    auto mapper = qam_mapper<float, qam_order::QPSK>::make();
+    auto engine = sim_engine<float>::make(mapper, cfg);
+
+    sweep_checkpoint checkpoint(filename, ext_checkpoint_hash(*engine));
+    resume_point(*engine, checkpoint, 0.6, 2, 2);
+
+    // same settings with another seed resume
+    cfg.seed = 6;
+    assert(ext_checkpoint_hash(*sim_engine<float>::make(mapper, cfg)) == ext_checkpoint_hash(*engine) &&
+           "the seed must not change the hash");
+
+    engine_config energy = cfg;
+    energy.unit_energy = true;
+    engine_config staged = cfg;
+    staged.fused = false;
+    engine_config frames = cfg;
+    frames.frame_bytes = 6000;
+    for (const engine_config& other : {energy, staged, frames}) {
+        sweep_checkpoint restored(filename, ext_checkpoint_hash(*sim_engine<float>::make(mapper, other)));
+        bool thrown = false;
+        try {
+            restored.load();
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && "checkpoint of other settings must be rejected");
+    }
+
+    auto qam16 = sim_engine<float>::make(qam_mapper<float, qam_order::QAM16>::make(), cfg);
+    assert(ext_checkpoint_hash(*qam16) != ext_checkpoint_hash(*engine) && "modulation must change the hash");
+
+    std::remove(filename.c_str());
+    return true;
+}
+
+/**
+ * TEST: corrupted file is rejected
+ */
+bool test_checkpoint_corrupted() {
+    const std::string filename = "cases_checkpoint_corrupted.ckpt";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file << "garbage";
+    }
+
+    sweep_checkpoint checkpoint(filename, 42);
+    try {
+        checkpoint.load();
+        assert(false && "corrupted checkpoint should throw");
+    } catch (const std::runtime_error& e) {
+        // pass
+    }
+
+    std::remove(filename.c_str());
+    return true;
+}
+
+/**
+ * TEST: interrupted point continues from its counts and stream positions,
+ *       a completed point is not simulated again, more frames are merged
+ */
+bool test_resume_point() {
+    const std::string filename = "cases_checkpoint_resume.ckpt";
+    std::remove(filename.c_str());
+
+    engine_config cfg;
+    cfg.frame_bytes = 3000;
+    cfg.seed        = 5;
+
+    auto mapper = qam_mapper<float, qam_order::QPSK>::make();
+
+    // "killed" after 4 of 10 frames
+    {
+        auto engine = sim_engine<float>::make(mapper, cfg);
+        sweep_checkpoint checkpoint(filename, ext_checkpoint_hash(*engine));
+        ber_point partial = resume_point(*engine, checkpoint, 0.6, 4, 2);
+        assert(partial.frames == 4 && "partial frame count mismatch");
+    }
+
+    // a fresh process resumes: only 6 frames are simulated
+    size_t generated = 0;
+    auto engine = sim_engine<float>::make(mapper, cfg);
+    auto& source = engine->get_bit_source();
+    engine->set_bit_generator([&](std::span<byte> bits) {
+        source.fill(bits);
+        generated += bits.size();
+    });
+
+    sweep_checkpoint checkpoint(filename, ext_checkpoint_hash(*engine));
+    assert(checkpoint.load() && "checkpoint must exist");
+    uint64_t saved_position = checkpoint.find(0.6)->rng_position;
+
+    ber_point full = resume_point(*engine, checkpoint, 0.6, 10, 2);
+    assert(full.frames == 10 && full.bits == 10 * cfg.frame_bytes * 8 && "resumed counts mismatch");
+    assert(generated == 6 * cfg.frame_bytes && "resume must simulate only the missing frames");
+    assert(source.get_position() > saved_position && "payload stream must continue from the saved position");
+    assert(full.errors == sim_engine<float>::make(mapper, cfg)->run(0.6, 10).errors &&
+           "resumed point must match an uninterrupted run");
+
+    // completed: nothing simulated
+    generated = 0;
+    ber_point again = resume_point(*engine, checkpoint, 0.6, 10, 2);
+    assert(generated == 0 && again.errors == full.errors && "completed point must come from the checkpoint");
+
+    // top up with more frames
+    ber_point more = resume_point(*engine, checkpoint, 0.6, 15, 5);
+    assert(more.frames == 15 && more.errors >= full.errors && "top-up must merge counts");
+    assert(generated == 5 * cfg.frame_bytes && "top-up must simulate only the extra frames");
+
+    std::remove(filename.c_str());
+    return true;
+}
+
+int main() {
+    assert(test_checkpoint_round_trip() == true && "test_checkpoint_round_trip() != true");
+    assert(test_checkpoint_corrupted() == true && "test_checkpoint_corrupted() != true");
+    assert(test_checkpoint_other_settings() == true && "test_checkpoint_other_settings() != true");
+    assert(test_resume_point() == true && "test_resume_point() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,287 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "phys/qam/qam_demodulator.hpp"
+#include "phys/chan.hpp"
+#include "sim/engine.hpp"
+
+std::vector<byte> random_bytes(size_t length, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<byte> bytes(length);
+    for (auto& b : bytes) {
+        b = static_cast<byte>(rng());
+    }
+    return bytes;
+}
+
+/**
+ * TEST: block modulate/demodulate give the same result as the vector API
+ */
+template<qam_order ORDER>
+bool test_block_api_matches(size_t length) {
+    auto mapper = qam_mapper<float, ORDER>::make();
+    auto modulator = qam_modulator<float>::make();
+    auto demodulator = qam_demodulator<float>::make();
+    modulator->set_mapper(mapper);
+    demodulator->set_mapper(mapper);
+
+    auto bits = random_bytes(length, 42);
+    auto reference = modulator->modulate(bits);
+
+    auto block = complex<float>::make(reference.size());
+    size_t count = modulator->modulate(std::span<const byte>(bits), block);
+    assert(count == reference.size() / 2 && "block modulate symbol count mismatch");
+
+    for (size_t i = 0; i < count; ++i) {
+        assert(block[i] == reference[i] && "block modulate symbol mismatch");
+    }
+
+    channel<float> chan(0.7);
+    auto noisy = chan.transmit(reference);
+
+    auto reference_bits = demodulator->demodulate(noisy);
+    std::vector<byte> block_bits(length, 0);
+    demodulator->demodulate(noisy, count, std::span<byte>(block_bits));
+
+    for (size_t i = 0; i < length; ++i) {
+        assert(block_bits[i] == reference_bits[i] && "block demodulate bit mismatch");
+    }
+
+    return true;
+}
+
+/**
+ * TEST: noiseless channel gives zero errors, frames are accounted
+ */
+template<qam_order ORDER>
+bool test_engine_noiseless(bool fused) {
+    engine_config cfg;
+    cfg.frame_bytes = 10000;
+    cfg.tile_bytes  = 1000;
+    cfg.fused       = fused;
+
+    auto engine = sim_engine<float>::make(qam_mapper<float, ORDER>::make(), cfg);
+    assert(engine->get_config().tile_bytes == 999 && "tile must be aligned to whole symbols");
+    assert(engine->get_config().frame_bytes == 9999 && "frame must be aligned to whole symbols");
+
+    ber_point point = engine->run(0.0, 3);
+    assert(point.bits == 3 * 9999 * 8 && "bit accounting mismatch");
+    assert(point.errors == 0 && "noiseless channel must not produce errors");
+
+    return true;
+}
+
+/**
+ * TEST: noisy channel produces errors, BER is sane
+ */
+bool test_engine_noisy() {
+    auto engine = sim_engine<double>::make(qam_mapper<double, qam_order::QPSK>::make());
+    ber_point point = engine->run(1.0, 2);
+
+    // QPSK at sigma 1: 0.5 * erfc(1 / sqrt(2)) ~ 0.159
+    assert(point.ber() > 0.12 && point.ber() < 0.20 && "unexpected QPSK BER at sigma = 1");
+    return true;
+}
+
+/**
+ * TEST: payload and noise follow the seed: same seed -> same errors in both
+ *       kernels, reseed() replays a stream, another stream differs
+ */
+bool test_engine_reproducible() {
+    engine_config cfg;
+    cfg.frame_bytes = 6000;
+    cfg.seed = 11;
+
+    auto mapper = qam_mapper<float, qam_order::QAM16>::make();
+    cfg.fused = true;
+    auto fused = sim_engine<float>::make(mapper, cfg);
+    cfg.fused = false;
+    auto staged = sim_engine<float>::make(mapper, cfg);
+
+    const ber_point first = fused->run(0.8, 3);
+    assert(first.errors > 0 && "sigma 0.8 must give errors");
+    assert(staged->run(0.8, 3).errors == first.errors && "kernels must see the same payload and noise");
+
+    fused->reseed(cfg.seed, 0);
+    assert(fused->run(0.8, 3).errors == first.errors && "reseed must replay the stream");
+    fused->reseed(cfg.seed, 1);
+    assert(fused->run(0.8, 3).errors != first.errors && "another stream must give other errors");
+    return true;
+}
+
+/**
+ * TEST: unit-energy constellations are precomputed and decoded without errors
+ */
+template<qam_order ORDER>
+bool test_engine_unit_energy(bool fused, double raw_energy) {
+    auto mapper = qam_mapper<float, ORDER>::make();
+    assert(std::fabs(mapper->get_symbol_energy() - raw_energy) < 1e-9 && "wrong constellation energy");
+
+    double unit_energy = 0.0;
+    for (const auto& [index, point] : mapper->get_unit_constellation()) {
+        unit_energy += point.i * point.i + point.q * point.q;
+    }
+    unit_energy /= mapper->get_unit_constellation().size();
+    assert(std::fabs(unit_energy - 1.0) < 1e-5 && "unit constellation must have energy 1");
+
+    engine_config cfg;
+    cfg.frame_bytes = 3000;
+    cfg.fused       = fused;
+    cfg.unit_energy = true;
+
+    auto engine = sim_engine<float>::make(mapper, cfg);
+    assert(engine->get_symbol_energy() == 1.0 && "unit-energy engine must report Es = 1");
+
+    ber_point point = engine->run(0.0, 2);
+    assert(point.errors == 0 && "noiseless unit-energy channel must not produce errors");
+
+    // scaled thresholds: tiny noise relative to the unit-energy spacing is harmless
+    point = engine->run(ext_esn0_to_sigma(40.0), 2);
+    assert(point.errors == 0 && "40 dB Es/N0 must not produce errors");
+
+    return true;
+}
+
+/**
+ * TEST: Eb/N0 parameterisation on unit-energy QPSK matches theory
+ */
+bool test_engine_ebn0_qpsk(bool fused) {
+    engine_config cfg;
+    cfg.frame_bytes = 30000;
+    cfg.fused       = fused;
+    cfg.unit_energy = true;
+
+    auto engine = sim_engine<double>::make(qam_mapper<double, qam_order::QPSK>::make(), cfg);
+
+    // Gray QPSK: BER = 0.5 * erfc(sqrt(Eb/N0)), 4 dB -> 1.25e-2
+    const double ebn0_db = 4.0;
+    const double theory = 0.5 * std::erfc(std::sqrt(std::pow(10.0, ebn0_db / 10.0)));
+
+    ber_point point = engine->run(ext_ebn0_to_sigma(ebn0_db, engine->get_bits_per_symbol()), 4);
+    assert(point.ber() > 0.7 * theory && point.ber() < 1.3 * theory && "QPSK BER off at 4 dB Eb/N0");
+
+    return true;
+}
+
+/**
+ * TEST: staged chain collects detailed error statistics
+ */
+bool test_engine_error_stats() {
+    engine_config cfg;
+    cfg.frame_bytes = 30000;
+    cfg.fused       = false;
+    cfg.measure_quality = true;
+
+    auto engine = sim_engine<float>::make(qam_mapper<float, qam_order::QAM16>::make(), cfg);
+    ber_point point = engine->run(0.8, 2);
+    const error_stats& stats = engine->get_error_stats();
+
+    assert(stats.bits == point.bits && "stats bits != point bits");
+    assert(stats.errors == point.errors && "stats errors != point errors");
+    assert(stats.symbols == point.bits / 4 && "QAM16 symbol count mismatch");
+    assert(stats.ser() > stats.ber() && "SER must exceed BER");
+    assert(stats.bursts > 0 && stats.bursts <= stats.errors && "burst count out of range");
+
+    // data-aided: AWGN only, so MER and cluster SNR agree
+    const evm_stats quality = engine->get_quality();
+    assert(quality.symbols == stats.symbols && "quality symbol count mismatch");
+    assert(std::isfinite(quality.mer_db()) && std::fabs(quality.mer_db() - quality.snr_db()) < 0.3 && "MER != SNR");
+
+    return true;
+}
+
+/**
+ * TEST: the fused kernel gives the bit and per-position counts of the
+ *       staged chain (no symbol or burst statistics), runs accumulate
+ *       until reset_stats()
+ */
+bool test_engine_fused_error_stats() {
+    engine_config cfg;
+    cfg.frame_bytes = 30000;
+    cfg.seed = 21;
+
+    auto mapper = qam_mapper<float, qam_order::QAM64>::make();
+    auto fused = sim_engine<float>::make(mapper, cfg);
+    cfg.fused = false;
+    auto staged = sim_engine<float>::make(mapper, cfg);
+
+    // one point in two chunks, as resume_point() runs it
+    ber_point point = fused->run(0.5, 1);
+    point.merge(fused->run(0.5, 2));
+    staged->run(0.5, 3);
+
+    const error_stats& stats = fused->get_error_stats();
+    assert(stats.bits == point.bits && stats.errors == point.errors && "chunks must accumulate");
+    assert(stats.errors == staged->get_error_stats().errors && "fused error count differs from the staged chain");
+    assert(stats.bit_position_errors == staged->get_error_stats().bit_position_errors && "per-position mismatch");
+    assert(stats.symbols == 0 && stats.bursts == 0 && "fused kernel must not report symbol statistics");
+    assert(staged->get_error_stats().symbol_errors > 0 && "sigma 0.5 must give symbol errors");
+
+    fused->reset_stats();
+    assert(fused->get_error_stats().bits == 0 && "reset_stats() must clear the counts");
+    return true;
+}
+
+/**
+ * TEST: custom bit generator
+ */
+bool test_engine_bit_generator() {
+    engine_config cfg;
+    cfg.frame_bytes = 4095;
+
+    size_t generated = 0;
+    auto engine = sim_engine<float>::make(qam_mapper<float, qam_order::QAM16>::make(), cfg);
+    engine->set_bit_generator([&](std::span<byte> bits) {
+        std::fill(bits.begin(), bits.end(), 0xA5);
+        generated += bits.size();
+    });
+
+    ber_point point = engine->run(0.0, 2);
+    assert(generated == 2 * cfg.frame_bytes && "generator must cover every frame byte");
+    assert(point.errors == 0 && "noiseless channel must not produce errors");
+
+    try {
+        engine->set_bit_generator(nullptr);
+        assert(false && "null generator should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    return true;
+}
+
+int main() {
+    assert(test_block_api_matches<qam_order::QPSK>(257) == true && "test_block_api_matches<QPSK>() != true");
+    assert(test_block_api_matches<qam_order::QAM16>(257) == true && "test_block_api_matches<QAM16>() != true");
+    assert(test_block_api_matches<qam_order::QAM64>(257) == true && "test_block_api_matches<QAM64>() != true");
+    assert(test_block_api_matches<qam_order::QAM64>(256) == true && "test_block_api_matches<QAM64>() != true");
+
+    assert(test_engine_noiseless<qam_order::QPSK>(false) == true && "test_engine_noiseless<QPSK>(false) != true");
+    assert(test_engine_noiseless<qam_order::QPSK>(true) == true && "test_engine_noiseless<QPSK>(true) != true");
+    assert(test_engine_noiseless<qam_order::QAM16>(false) == true && "test_engine_noiseless<QAM16>(false) != true");
+    assert(test_engine_noiseless<qam_order::QAM16>(true) == true && "test_engine_noiseless<QAM16>(true) != true");
+    assert(test_engine_noiseless<qam_order::QAM64>(false) == true && "test_engine_noiseless<QAM64>(false) != true");
+    assert(test_engine_noiseless<qam_order::QAM64>(true) == true && "test_engine_noiseless<QAM64>(true) != true");
+    assert(test_engine_noisy() == true && "test_engine_noisy() != true");
+    assert(test_engine_reproducible() == true && "test_engine_reproducible() != true");
+    assert(test_engine_unit_energy<qam_order::QPSK>(false, 2.0) == true && "test_engine_unit_energy<QPSK>(false) != true");
+    assert(test_engine_unit_energy<qam_order::QPSK>(true, 2.0) == true && "test_engine_unit_energy<QPSK>(true) != true");
+    assert(test_engine_unit_energy<qam_order::QAM16>(false, 10.0) == true && "test_engine_unit_energy<QAM16>(false) != true");
+    assert(test_engine_unit_energy<qam_order::QAM16>(true, 10.0) == true && "test_engine_unit_energy<QAM16>(true) != true");
+    assert(test_engine_unit_energy<qam_order::QAM64>(false, 42.0) == true && "test_engine_unit_energy<QAM64>(false) != true");
+    assert(test_engine_unit_energy<qam_order::QAM64>(true, 42.0) == true && "test_engine_unit_energy<QAM64>(true) != true");
+    assert(test_engine_ebn0_qpsk(false) == true && "test_engine_ebn0_qpsk(false) != true");
+    assert(test_engine_ebn0_qpsk(true) == true && "test_engine_ebn0_qpsk(true) != true");
+    assert(test_engine_error_stats() == true && "test_engine_error_stats() != true");
+    assert(test_engine_fused_error_stats() == true && "test_engine_fused_error_stats() != true");
+    assert(test_engine_bit_generator() == true && "test_engine_bit_generator() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
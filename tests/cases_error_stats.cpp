@@ -0,0 +1,161 @@
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sim/error_stats.hpp"
+
+/**
+ * Reference: bit by bit over the whole stream
+ */
+error_stats reference_stats(const std::vector<byte>& tx, const std::vector<byte>& rx, uint32_t bps) {
+    error_stats stats;
+    uint64_t run = 0;
+
+    auto close = [&]() {
+        if (run) {
+            stats.bursts++;
+            stats.max_burst = std::max(stats.max_burst, run);
+            stats.burst_histogram[std::min<uint64_t>(run, error_stats::BURST_BUCKETS) - 1]++;
+            run = 0;
+        }
+    };
+
+    bool symbol_error = false;
+    for (size_t i = 0; i < tx.size() * 8; ++i) {
+        int a = (tx[i / 8] >> (7 - i % 8)) & 1;
+        int b = (rx[i / 8] >> (7 - i % 8)) & 1;
+
+        stats.bits++;
+        if (a != b) {
+            stats.errors++;
+            stats.bit_position_errors[i % bps]++;
+            symbol_error = true;
+            run++;
+        } else {
+            close();
+        }
+
+        if (i % bps == bps - 1) {
+            stats.symbols++;
+            stats.symbol_errors += symbol_error;
+            symbol_error = false;
+        }
+    }
+    close();
+
+    return stats;
+}
+
+bool equal_stats(const error_stats& a, const error_stats& b) {
+    return a.bits == b.bits && a.errors == b.errors && 
+           a.symbols == b.symbols && a.symbol_errors == b.symbol_errors &&
+           a.bursts == b.bursts && a.max_burst == b.max_burst &&
+           a.bit_position_errors == b.bit_position_errors &&
+           a.burst_histogram == b.burst_histogram;
+}
+
+/**
+ * TEST: word-parallel counter matches the bit-by-bit reference,
+ *       also when the stream is split into several blocks
+ */
+bool test_counter_matches_reference(uint32_t bps, double error_rate) {
+    const size_t length = 3 * 1000 + 3;
+    std::mt19937 rng(bps);
+    std::bernoulli_distribution flip(error_rate);
+
+    std::vector<byte> tx(length), rx(length);
+    for (size_t i = 0; i < length; ++i) {
+        tx[i] = static_cast<byte>(rng());
+        byte mask = 0;
+        for (int j = 0; j < 8; ++j) {
+            mask = (mask << 1) | (flip(rng) ? 1 : 0);
+        }
+        rx[i] = tx[i] ^ mask;
+    }
+
+    error_stats reference = reference_stats(tx, rx, bps);
+
+    error_counter whole(bps);
+    whole.accumulate(tx, rx);
+    whole.flush();
+    assert(equal_stats(whole.get_stats(), reference) && "single block stats mismatch");
+
+    // blocks of 3 bytes * k keep symbol alignment for every order
+    error_counter split(bps);
+    size_t offset = 0;
+    for (size_t block : {3, 300, 9, 1500, 6}) {
+        split.accumulate(std::span<const byte>(tx.data() + offset, block), 
+                         std::span<const byte>(rx.data() + offset, block));
+        offset += block;
+    }
+    split.accumulate(std::span<const byte>(tx.data() + offset, length - offset), 
+                     std::span<const byte>(rx.data() + offset, length - offset));
+    split.flush();
+    assert(equal_stats(split.get_stats(), reference) && "split block stats mismatch");
+
+    return true;
+}
+
+/**
+ * TEST: merge and derived rates
+ */
+bool test_stats_merge() {
+    error_stats a;
+    a.bits = 100; a.errors = 10; a.symbols = 50; a.symbol_errors = 8; a.bursts = 5; a.max_burst = 3;
+    error_stats b;
+    b.bits = 100; b.errors = 30; b.symbols = 50; b.symbol_errors = 12; b.bursts = 5; b.max_burst = 7;
+
+    a.merge(b);
+    assert(a.bits == 200 && a.errors == 40 && "merge counts mismatch");
+    assert(a.max_burst == 7 && "merge max_burst mismatch");
+    assert(a.ber() == 0.2 && "ber mismatch");
+    assert(a.ser() == 0.2 && "ser mismatch");
+    assert(a.mean_burst() == 4.0 && "mean burst mismatch");
+
+    return true;
+}
+
+/**
+ * TEST: invalid arguments
+ */
+bool test_counter_invalid() {
+    try {
+        error_counter counter(7);
+        assert(false && "bits_per_symbol > 6 should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    // 5 does not divide the 48-bit chunk, symbols would straddle chunks
+    try {
+        error_counter counter(5);
+        assert(false && "bits_per_symbol 5 should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    error_counter counter(6);
+    std::vector<byte> tx(4), rx(4);
+    try {
+        counter.accumulate(tx, rx);
+        assert(false && "partial symbol should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    return true;
+}
+
+int main() {
+    for (uint32_t bps : {1u, 2u, 3u, 4u, 6u}) {
+        assert(test_counter_matches_reference(bps, 0.01) == true && "test_counter_matches_reference(0.01) != true");
+        assert(test_counter_matches_reference(bps, 0.3) == true && "test_counter_matches_reference(0.3) != true");
+        assert(test_counter_matches_reference(bps, 0.95) == true && "test_counter_matches_reference(0.95) != true");
+    }
+    assert(test_stats_merge() == true && "test_stats_merge() != true");
+    assert(test_counter_invalid() == true && "test_counter_invalid() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "sim/evm.hpp"
+
+/**
+ * @brief Reads one symbol of a container
+ */
+complex_t<double> point_at(const complex<double>& symbols, size_t s) {
+    auto [i, q] = symbols.decompose();
+    return complex_t<double>(i[s], q[s]);
+}
+
+/**
+ * @brief Modulates count QAM16 symbols of known bits
+ */
+complex<double> make_symbols(size_t count, std::vector<byte>& bits) {
+    bits.resize(count * 4 / 8);
+    for (size_t i = 0; i < bits.size(); ++i) {
+        bits[i] = static_cast<byte>(i * 73 + 5);
+    }
+    auto modulator = qam_modulator<double>::make();
+    modulator->set_mapper(ext_make_mapper<double>(qam_order::QAM16));
+    return modulator->modulate(bits);
+}
+
+/**
+ * TEST: clean symbols have no error, every reference mode finds the same points
+ */
+bool test_noiseless() {
+    const size_t count = 1000;
+    std::vector<byte> bits;
+    const complex<double> symbols = make_symbols(count, bits);
+    const auto mapper = ext_make_mapper<double>(qam_order::QAM16);
+
+    evm_meter<double> decided(mapper), aided(mapper), from_bits(mapper);
+    decided.accumulate(symbols, count);
+    aided.accumulate(symbols, symbols, count);
+    from_bits.accumulate(symbols, count, bits);
+
+    for (const evm_meter<double>* meter : {&decided, &aided, &from_bits}) {
+        const evm_stats& stats = meter->get_stats();
+        assert(stats.symbols == count && "symbol count mismatch");
+        assert(stats.rms_evm() == 0 && stats.peak_evm() == 0 && "clean symbols must have no EVM");
+        assert(std::isinf(stats.mer_db()) && stats.snr_db() > 100 && "clean symbols must have infinite MER / SNR");
+        assert(stats.points.size() == 16 && "QAM16 must have 16 points");
+        for (size_t p = 0; p < 16; ++p) {
+            assert(stats.points[p].count == decided.get_stats().points[p].count && "point attribution mismatch");
+        }
+    }
+    // mean power of the default QAM16 constellation
+    assert(std::fabs(decided.get_stats().reference_power / count - 10.0) < 0.5 && "reference power mismatch");
+    return true;
+}
+
+/**
+ * TEST: a constant offset gives the exact EVM and leaves the cluster SNR unbounded
+ */
+bool test_offset() {
+    const size_t count = 1024;
+    std::vector<byte> bits;
+    const complex<double> symbols = make_symbols(count, bits);
+    auto rx = complex<double>::make(count * 2);
+    for (size_t s = 0; s < count; ++s) {
+        const complex_t<double> point = point_at(symbols, s);
+        rx.store(complex_t<double>(point.i + 0.1, point.q), s);
+    }
+
+    evm_meter<double> meter(ext_make_mapper<double>(qam_order::QAM16));
+    meter.accumulate(rx, symbols, count);
+    const evm_stats& stats = meter.get_stats();
+
+    const double expected = std::sqrt(0.01 * count / stats.reference_power);
+    assert(std::fabs(stats.rms_evm() - expected) < 1e-9 && "offset EVM mismatch");
+    assert(std::fabs(stats.peak_evm() - expected) < 1e-9 && "constant error must have peak == rms");
+    assert(stats.snr_db() > 100 && "an offset is not noise");
+    for (const evm_point_stats& point : stats.points) {
+        if (point.count) {
+            assert(point.spread() < 1e-6 && "clusters must have no spread");
+        }
+    }
+    return true;
+}
+
+/**
+ * TEST: Gaussian noise gives MER = Es / (2 sigma^2), merged halves equal one pass
+ */
+bool test_noise() {
+    const size_t count = 200000;
+    const double sigma = 0.3;
+    std::vector<byte> bits;
+    const complex<double> symbols = make_symbols(count, bits);
+
+    std::mt19937 rng(7);
+    std::normal_distribution<double> awgn(0.0, sigma);
+    auto rx = complex<double>::make(count * 2);
+    for (size_t s = 0; s < count; ++s) {
+        const complex_t<double> point = point_at(symbols, s);
+        rx.store(complex_t<double>(point.i + awgn(rng), point.q + awgn(rng)), s);
+    }
+
+    const auto mapper = ext_make_mapper<double>(qam_order::QAM16);
+    evm_meter<double> meter(mapper);
+    meter.accumulate(rx, count, bits);
+    const evm_stats& stats = meter.get_stats();
+
+    const double expected = 10.0 * std::log10(stats.reference_power / count / (2 * sigma * sigma));
+    assert(std::fabs(stats.mer_db() - expected) < 0.1 && "data-aided MER mismatch");
+    assert(std::fabs(stats.snr_db() - expected) < 0.1 && "cluster SNR mismatch");
+    for (const evm_point_stats& point : stats.points) {
+        assert(std::fabs(point.spread() - sigma * std::sqrt(2.0)) < 0.02 && "cluster spread mismatch");
+    }
+
+    // decision-directed is optimistic
+    evm_meter<double> decided(mapper);
+    decided.accumulate(rx, count);
+    assert(decided.get_stats().mer_db() > stats.mer_db() && "decision-directed MER must not be below data-aided");
+
+    // halves through two meters
+    const size_t half = count / 2;
+    auto first = complex<double>::make(half * 2), second = complex<double>::make(half * 2);
+    for (size_t s = 0; s < half; ++s) {
+        first.store(point_at(rx, s), s);
+        second.store(point_at(rx, half + s), s);
+    }
+    evm_meter<double> a(mapper), b(mapper);
+    a.accumulate(first, half, bits);
+    b.accumulate(second, half, std::span<const byte>(bits).subspan(half * 4 / 8));
+    evm_stats merged = a.get_stats();
+    merged.merge(b.get_stats());
+    assert(merged.symbols == count && "merged count mismatch");
+    assert(std::fabs(merged.mer_db() - stats.mer_db()) < 1e-9 && "merged MER mismatch");
+    assert(merged.peak_error_power == stats.peak_error_power && "merged peak mismatch");
+
+    bool thrown = false;
+    try {
+        evm_meter<double> qpsk(ext_make_mapper<double>(qam_order::QPSK));
+        merged.merge(qpsk.get_stats());
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "merging different constellations must throw");
+
+    meter.reset();
+    assert(meter.get_stats().symbols == 0 && meter.get_stats().points.size() == 16 && "reset mismatch");
+    return true;
+}
+
+int main() {
+    assert(test_noiseless() == true && "test_noiseless() != true");
+    assert(test_offset() == true && "test_offset() != true");
+    assert(test_noise() == true && "test_noise() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
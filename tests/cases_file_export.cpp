@@ -0,0 +1,123 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "file/file.hpp"
+#include "types/complex.hpp"
+
+const char* EXPORT_FILE = "cases_file_export";
+
+template<typename DTYPE>
+complex<DTYPE> make_symbols(size_t count) {
+    auto symbols = complex<DTYPE>::make(count * 2);
+    for (size_t s = 0; s < count; ++s) {
+        const DTYPE i = static_cast<DTYPE>(s) / 7 - static_cast<DTYPE>(3.5);
+        const DTYPE q = static_cast<DTYPE>(1e-5) * static_cast<DTYPE>(s) - 1;
+        symbols.store(complex_t<DTYPE>(i, q), s);
+    }
+    return symbols;
+}
+
+std::string read_file(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/**
+ * TEST: text dumps read like the former operator<< output, decimation keeps indices
+ */
+template<typename DTYPE>
+bool test_text_export() {
+    const size_t count = 100000;
+    const auto symbols = make_symbols<DTYPE>(count);
+    const std::string filename = std::string(EXPORT_FILE) + ".dat";
+
+    assert(file_io::save_modulated_symbols_to_file(symbols, filename, true) && "text export failed");
+    std::ostringstream expected;
+    expected << "# Modulated Symbols\n# Format: index i q\n";
+    for (size_t s = 0; s < count; ++s) {
+        expected << s << " " << symbols[s].i << " " << symbols[s].q << "\n";
+    }
+    assert(read_file(filename) == expected.str() && "text export differs from operator<<");
+
+    file_io::export_options options;
+    options.decimation = 1000;
+    assert(file_io::save_modulated_symbols_to_file(symbols, filename, true, options) && "decimated export failed");
+    std::istringstream lines(read_file(filename));
+    std::string line;
+    size_t rows = 0;
+    while (std::getline(lines, line)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        size_t index = 0;
+        std::istringstream(line) >> index;
+        assert(index == rows * 1000 && "decimated index mismatch");
+        ++rows;
+    }
+    assert(rows == 100 && "decimated row count mismatch");
+
+    std::remove(filename.c_str());
+    return true;
+}
+
+/**
+ * TEST: binary dumps hold float32 records and the script reads them as such
+ */
+bool test_binary_export() {
+    const size_t count = 1001;
+    const auto symbols = make_symbols<double>(count);
+
+    file_io::export_options options;
+    options.binary = true;
+    options.decimation = 2;
+    assert(file_io::save_and_plot_modulated_symbols(symbols, EXPORT_FILE, "Binary", false, options) && "binary export failed");
+
+    const std::string data = read_file(std::string(EXPORT_FILE) + ".bin");
+    assert(data.size() == 501 * 2 * sizeof(float) && "binary size mismatch");
+    float record[2];
+    std::memcpy(record, data.data() + 10 * sizeof(record), sizeof(record));
+    assert(record[0] == static_cast<float>(symbols[20].i) && record[1] == static_cast<float>(symbols[20].q) && "binary record mismatch");
+
+    std::string script = read_file(std::string(EXPORT_FILE) + ".plt");
+    assert(script.find("binary format='%float%float' using 1:2") != std::string::npos && "script must read the binary file");
+
+    // indices are uint64: 2^24 + 1 has no float
+    const size_t far = (size_t(1) << 24) + 1;
+    const auto many = make_symbols<float>(far + 1);
+    options.decimation = far;
+    assert(file_io::save_and_plot_modulated_symbols(many, EXPORT_FILE, "Binary", true, options) && "indexed export failed");
+
+    const std::string indexed = read_file(std::string(EXPORT_FILE) + ".bin");
+    const size_t record_bytes = sizeof(uint64_t) + 2 * sizeof(float);
+    assert(indexed.size() == 2 * record_bytes && "indexed binary size mismatch");
+    uint64_t index = 0;
+    std::memcpy(&index, indexed.data() + record_bytes, sizeof(index));
+    assert(index == far && "index must be exact");
+    std::memcpy(record, indexed.data() + record_bytes + sizeof(index), sizeof(record));
+    assert(record[0] == many[far].i && record[1] == many[far].q && "indexed record mismatch");
+
+    script = read_file(std::string(EXPORT_FILE) + ".plt");
+    assert(script.find("binary format='%uint64%float%float' using 2:3") != std::string::npos && "script must skip the index");
+
+    std::remove((std::string(EXPORT_FILE) + ".bin").c_str());
+    std::remove((std::string(EXPORT_FILE) + ".plt").c_str());
+    return true;
+}
+
+int main() {
+    assert(test_text_export<float>() == true && "test_text_export<float>() != true");
+    assert(test_text_export<double>() == true && "test_text_export<double>() != true");
+    assert(test_binary_export() == true && "test_binary_export() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
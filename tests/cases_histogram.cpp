@@ -0,0 +1,124 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "file/iq_file.hpp"
+#include "sim/histogram.hpp"
+
+const char* HIST_FILE = "cases_histogram";
+
+/**
+ * TEST: bin edges, overflow bin and NaN
+ */
+bool test_binning() {
+    histogram_config cfg;
+    cfg.bins = 4;
+    cfg.limit = 2.0;  // bins of width 1: [-2,-1) [-1,0) [0,1) [1,2)
+    iq_histogram histogram(cfg);
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> i = {-2.0f, -0.5f, 0.0f, 1.99f, 2.0f, -2.01f, nan, 0.5f};
+    const std::vector<float> q = {-2.0f,  0.5f, 0.0f, 1.99f, 0.0f,  0.0f, 0.0f, nan};
+    histogram.accumulate<float>(i, q);
+
+    assert(histogram.total() == 8 && histogram.outside() == 4 && "overflow count mismatch");
+    assert(histogram.at(0, 0) == 1 && "lower edge belongs to the first bin");
+    assert(histogram.at(1, 2) == 1 && histogram.at(2, 2) == 1 && histogram.at(3, 3) == 1 && "bin mismatch");
+    assert(std::fabs(histogram.bin_center(0) + 1.5) < 1e-12 && "bin centre mismatch");
+    return true;
+}
+
+/**
+ * TEST: tiles across the internal tile size, per-thread merge equals one pass
+ */
+bool test_capture_merge() {
+    const size_t count = 5000;
+    auto symbols = complex<double>::make(count * 2);
+    for (size_t s = 0; s < count; ++s) {
+        symbols.store(complex_t<double>(std::sin(0.37 * s) * 3, std::cos(0.11 * s) * 3), s);
+    }
+
+    iq_histogram single;
+    single.accumulate(symbols, count);
+
+    for (iq_layout layout : {iq_layout::PLANAR, iq_layout::INTERLEAVED}) {
+        iq_metadata meta;
+        meta.layout = layout;
+        meta.block_samples = 300;
+        {
+            iq_writer<double> writer(std::string(HIST_FILE) + ".iq", meta);
+            writer.append(symbols, count);
+        }
+        iq_reader<double> reader(std::string(HIST_FILE) + ".iq");
+        const iq_histogram merged = ext_histogram_capture<double>(reader, histogram_config(), 3);
+
+        assert(merged.total() == count && "merged total mismatch");
+        for (size_t y = 0; y < 256; ++y) {
+            for (size_t x = 0; x < 256; ++x) {
+                assert(merged.at(x, y) == single.at(x, y) && "merged histogram mismatch");
+            }
+        }
+    }
+    std::remove((std::string(HIST_FILE) + ".iq").c_str());
+
+    histogram_config other;
+    other.bins = 128;
+    bool thrown = false;
+    try {
+        single.merge(iq_histogram(other));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "merging different grids must throw");
+    return true;
+}
+
+/**
+ * TEST: binary matrix and image layout
+ */
+bool test_export() {
+    histogram_config cfg;
+    cfg.bins = 8;
+    iq_histogram histogram(cfg);
+    const std::vector<float> i = {7.5f, 7.5f, -7.5f};
+    const std::vector<float> q = {7.5f, 7.5f, -7.5f};
+    histogram.accumulate<float>(i, q);
+    assert(histogram.save_and_plot(HIST_FILE, "Test") && "export failed");
+
+    std::ifstream matrix(std::string(HIST_FILE) + ".bin", std::ios::binary);
+    std::vector<float> values(9 * 9);
+    matrix.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+    assert(matrix.gcount() == static_cast<std::streamsize>(values.size() * sizeof(float)) && "matrix size mismatch");
+    assert(values[0] == 8.0f && values[1] == -7.0f && "matrix header mismatch");
+    assert(values[9 * 8 + 8] == 2.0f && values[9 * 1 + 1] == 1.0f && "matrix values mismatch");
+
+    std::ifstream image(std::string(HIST_FILE) + ".pgm", std::ios::binary);
+    std::string magic;
+    size_t width = 0, height = 0, depth = 0;
+    image >> magic >> width >> height >> depth;
+    image.get();
+    std::vector<unsigned char> pixels(64);
+    image.read(reinterpret_cast<char*>(pixels.data()), 64);
+    assert(magic == "P5" && width == 8 && height == 8 && depth == 255 && "image header mismatch");
+    assert(pixels[7] == 255 && pixels[56] > 0 && pixels[0] == 0 && "image must have +Q at the top");
+
+    for (const char* ext : {".bin", ".pgm", ".plt"}) {
+        std::remove((std::string(HIST_FILE) + ext).c_str());
+    }
+    return true;
+}
+
+int main() {
+    assert(test_binning() == true && "test_binning() != true");
+    assert(test_capture_merge() == true && "test_capture_merge() != true");
+    assert(test_export() == true && "test_export() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
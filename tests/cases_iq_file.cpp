@@ -0,0 +1,173 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "file/iq_file.hpp"
+#include "types/complex.hpp"
+
+const char* IQ_FILE = "cases_iq_file.iq";
+
+template<typename DTYPE>
+complex<DTYPE> make_ramp(size_t count) {
+    auto symbols = complex<DTYPE>::make(count * 2);
+    for (size_t s = 0; s < count; ++s) {
+        symbols.store(complex_t<DTYPE>(static_cast<DTYPE>(s), -static_cast<DTYPE>(s) / 2), s);
+    }
+    return symbols;
+}
+
+/**
+ * TEST: appends of uneven sizes read back through views and copies
+ */
+template<typename DTYPE>
+bool test_round_trip(iq_layout layout) {
+    const size_t total = 1000;
+    auto ramp = make_ramp<DTYPE>(total);
+    auto [ramp_i, ramp_q] = ramp.decompose();
+
+    iq_metadata meta;
+    meta.layout = layout;
+    meta.block_samples = 64;
+    meta.modulation = qam_order::QAM16;
+    meta.sigma = 0.25;
+    {
+        iq_writer<DTYPE> writer(IQ_FILE, meta);
+        size_t done = 0;
+        for (size_t chunk : {1u, 63u, 100u, 300u, 536u}) {
+            writer.append(ramp_i.subspan(done, chunk), ramp_q.subspan(done, chunk));
+            done += chunk;
+        }
+        assert(writer.size() == total && "writer size mismatch");
+    }
+
+    iq_reader<DTYPE> reader(IQ_FILE);
+    const iq_header& header = reader.get_header();
+    assert(reader.size() == total && "sample count mismatch");
+    assert(header.layout == layout && header.dtype == ext_iq_dtype<DTYPE>() && "header mismatch");
+    assert(header.modulation == static_cast<uint32_t>(qam_order::QAM16) && header.sigma == 0.25 && "metadata mismatch");
+    assert(header.payload_offset % 4096 == 0 && "payload must be page aligned");
+    assert(reader.block_count() == 16 && "block count mismatch");
+
+    // last block is short
+    iq_view<DTYPE> last = reader.block(15);
+    assert(last.first == 960 && last.count == 40 && "last block mismatch");
+    if (layout == iq_layout::PLANAR) {
+        assert(last.i[5] == static_cast<DTYPE>(965) && last.q[5] == -static_cast<DTYPE>(965) / 2 && "planar view mismatch");
+    } else {
+        assert(last.interleaved[10] == static_cast<DTYPE>(965) && last.interleaved[11] == -static_cast<DTYPE>(965) / 2 && "interleaved view mismatch");
+    }
+
+    // range across block boundaries
+    auto out = complex<DTYPE>::make(300 * 2);
+    reader.read(50, 300, out);
+    for (size_t s = 0; s < 300; ++s) {
+        assert(out[s] == ramp[50 + s] && "read mismatch");
+    }
+
+    bool thrown = false;
+    try {
+        reader.read(900, 200, out);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown && "read past the end must throw");
+
+    std::remove(IQ_FILE);
+    return true;
+}
+
+/**
+ * TEST: SigMF sidecar, dtype mismatch and truncation
+ */
+bool test_metadata_and_errors() {
+    iq_metadata meta;
+    meta.layout = iq_layout::INTERLEAVED;
+    meta.sample_rate = 1e6;
+    meta.sigmf = true;
+    {
+        iq_writer<float> writer(IQ_FILE, meta);
+        writer.append(make_ramp<float>(10), 10);
+    }
+
+    const std::string sidecar = std::string(IQ_FILE) + ".sigmf-meta";
+    std::ifstream file(sidecar);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    assert(ss.str().find("\"core:datatype\": \"cf32_le\"") != std::string::npos && "SigMF datatype missing");
+    assert(ss.str().find("\"core:header_bytes\": 4096") != std::string::npos && "SigMF header bytes missing");
+    std::remove(sidecar.c_str());
+
+    bool thrown = false;
+    try {
+        iq_reader<double> reader(IQ_FILE);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "dtype mismatch must throw");
+
+    // header fields whose products or sums wrap around 2^64
+    auto patch = [](size_t offset, uint64_t value) {
+        std::fstream io(IQ_FILE, std::ios::binary | std::ios::in | std::ios::out);
+        io.seekp(static_cast<std::streamoff>(offset));
+        io.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    const uint64_t huge_offset = ~uint64_t(0) - 4095;
+    for (const auto& [field, value] : {std::pair{offsetof(iq_header, sample_count), uint64_t(1) << 61},
+                                       std::pair{offsetof(iq_header, payload_offset), huge_offset}}) {
+        patch(field, value);
+        thrown = false;
+        try {
+            iq_reader<float> reader(IQ_FILE);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && "wrapping header size must throw");
+    }
+    patch(offsetof(iq_header, sample_count), 10);
+    patch(offsetof(iq_header, payload_offset), IQ_PAYLOAD_OFFSET);
+    assert(iq_reader<float>(IQ_FILE).size() == 10 && "restored header must load");
+
+    // cut the payload short
+    {
+        std::ifstream in(IQ_FILE, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(IQ_FILE, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size() - 8));
+    }
+    thrown = false;
+    try {
+        iq_reader<float> reader(IQ_FILE);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "truncated file must throw");
+
+    thrown = false;
+    meta.layout = iq_layout::PLANAR;
+    try {
+        iq_writer<float> writer(IQ_FILE, meta);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "planar SigMF must throw");
+
+    std::remove(IQ_FILE);
+    return true;
+}
+
+int main() {
+    assert(test_round_trip<float>(iq_layout::PLANAR) == true && "test_round_trip<float>(PLANAR) != true");
+    assert(test_round_trip<float>(iq_layout::INTERLEAVED) == true && "test_round_trip<float>(INTERLEAVED) != true");
+    assert(test_round_trip<double>(iq_layout::PLANAR) == true && "test_round_trip<double>(PLANAR) != true");
+    assert(test_round_trip<double>(iq_layout::INTERLEAVED) == true && "test_round_trip<double>(INTERLEAVED) != true");
+    assert(test_metadata_and_errors() == true && "test_metadata_and_errors() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "sim/job.hpp"
+
+/**
+ * TEST: defaults, sections and list expansion of the job spec
+ */
+bool test_parse_job_spec() {
+    std::istringstream spec(
+        "# defaults\n"
+        "threads = 2\n"
+        "frames  = 7\n"
+        "seed    = 5\n"
+        "\n"
+        "[job]\n"
+        "modulation = QPSK, QAM64\n"
+        "dtype      = float, double\n"
+        "sigma      = 0:1:0.25   # five points\n"
+        "output     = out_{modulation}_{dtype}.csv\n"
+        "[job]\n"
+        "name       = snr\n"
+        "modulation = QAM16\n"
+        "ebn0_db    = 0:10:1\n"
+        "frames     = 3\n"
+        "fused      = false\n"
+        "output     = snr.csv\n");
+
+    job_batch batch = parse_job_spec(spec);
+
+    assert(batch.threads == 2 && "threads not parsed");
+    assert(batch.jobs.size() == 5 && "first section must expand into 4 jobs");
+
+    const sweep_job& first = batch.jobs[0];
+    assert(first.modulation == qam_order::QPSK && first.dtype == sample_type::FLOAT && "wrong expansion order");
+    assert(first.output == "out_qpsk_float.csv" && "placeholders not replaced");
+    assert(first.frames == 7 && first.engine.seed == 5 && "defaults not applied");
+    assert(first.grid().size() == 5 && "wrong grid size");
+    assert(batch.jobs[3].output == "out_qam64_double.csv" && "placeholders not replaced");
+
+    const sweep_job& snr = batch.jobs[4];
+    assert(snr.name == "snr" && snr.axis == sweep_axis::EBN0_DB && "ebn0 job not parsed");
+    assert(snr.frames == 3 && !snr.engine.fused && "section keys must override defaults");
+    assert(snr.engine.unit_energy && "Eb/N0 grids must run on unit-energy constellations");
+    assert(snr.grid().size() == 11 && "wrong grid size");
+
+    return true;
+}
+
+/**
+ * TEST: malformed specs are rejected with the line number
+ */
+bool test_parse_errors() {
+    const char* bad_specs[] = {
+        "[job]\nmodulation = QAM32\noutput = x.csv\n",
+        "[job]\nsigma = 0:1\noutput = x.csv\n",
+        "[job]\nframes = many\noutput = x.csv\n",
+        "[job]\ncolour = blue\noutput = x.csv\n",
+        "[job]\nsigma = 0:1:0.5\n",
+        "[job]\nmodulation = QPSK, QAM16\noutput = x.csv\n",
+        "[batch]\n",
+    };
+
+    for (const char* text : bad_specs) {
+        std::istringstream spec(text);
+        try {
+            parse_job_spec(spec);
+            assert(false && "malformed spec should throw");
+        } catch (const std::invalid_argument& e) {
+            assert(std::string(e.what()).find("line") != std::string::npos && "error without line number");
+        }
+    }
+
+    return true;
+}
+
+/**
+ * TEST: jobs of a batch run on the pool and reuse the workers' engines
+ */
+bool test_batch_runner() {
+    std::istringstream spec(
+        "frames      = 4\n"
+        "chunk_frames = 1\n"
+        "frame_bytes = 3000\n"
+        "seed        = 3\n"
+        "[job]\n"
+        "modulation  = QPSK, QAM16, QAM64\n"
+        "sigma       = 0:2:0.5\n"
+        "output      = unused_{modulation}.csv\n"
+        "[job]\n"
+        "modulation  = QPSK\n"
+        "sigma       = 3:3:1\n"
+        "target_errors = 1\n"
+        "min_frames  = 2\n"
+        "output      = unused.csv\n");
+
+    job_batch batch = parse_job_spec(spec);
+    auto runner = batch_runner::make(2);
+
+    // the count may be read while the workers create engines
+    std::atomic<bool> running{true};
+    bool monotonic = true;
+    std::thread poller([&]() {
+        size_t last = 0;
+        while (running) {
+            const size_t count = runner->get_engine_count();
+            monotonic = monotonic && count >= last;
+            last = count;
+            std::this_thread::yield();
+        }
+    });
+    auto results = runner->run(batch.jobs);
+    running = false;
+    poller.join();
+    assert(monotonic && "engine count must only grow");
+    assert(results.size() == 4 && "one result per job");
+
+    for (size_t j = 0; j < 3; ++j) {
+        assert(results[j].points.size() == 5 && "one point per grid value");
+        assert(results[j].points[0].errors == 0 && "noiseless point must not have errors");
+        assert(results[j].points[0].frames == 4 && "frame budget not used");
+        assert(results[j].points[4].ber() > 0.0 && "noisy point must have errors");
+
+        // error statistics cover exactly the simulated frames of every point
+        assert(results[j].stats.size() == 5 && "one error_stats per point");
+        for (size_t i = 0; i < 5; ++i) {
+            assert(results[j].stats[i].bits == results[j].points[i].bits && "statistics of another point");
+            assert(results[j].stats[i].errors == results[j].points[i].errors && "error counts disagree");
+        }
+        assert(results[j].stats[4].symbols == 0 && "fused jobs count bits only");
+    }
+
+    // stopping rule: errors show up in the first frame, min_frames bounds the stop
+    assert(results[3].points[0].frames == 2 && "error target did not stop the point");
+
+    const size_t engines = runner->get_engine_count();
+    assert(engines <= 2 * 3 && "engines must be cached per worker and modulation");
+
+    // second batch on the warm pool creates no new engines
+    runner->run(batch.jobs);
+    assert(runner->get_engine_count() == engines && "warm pool must reuse its engines");
+
+    return true;
+}
+
+/**
+ * TEST: Eb/N0 to sigma conversion
+ */
+bool test_ebn0_to_sigma() {
+    // QPSK with points +-1 +-1j: Es = 2, Eb = 1, N0 = 2 sigma^2
+    double sigma = ext_ebn0_to_sigma(0.0, 2, 2.0);
+    assert(std::fabs(sigma - std::sqrt(0.5)) < 1e-12 && "0 dB conversion mismatch");
+
+    double sigma_10 = ext_ebn0_to_sigma(10.0, 2, 2.0);
+    assert(std::fabs(sigma_10 - std::sqrt(0.05)) < 1e-12 && "10 dB conversion mismatch");
+
+    return true;
+}
+
+int main() {
+    assert(test_parse_job_spec() == true && "test_parse_job_spec() != true");
+    assert(test_parse_errors() == true && "test_parse_errors() != true");
+    assert(test_batch_runner() == true && "test_batch_runner() != true");
+    assert(test_ebn0_to_sigma() == true && "test_ebn0_to_sigma() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "phys/chan.hpp"
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/qam_demodulator.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "sim/noise_estimator.hpp"
+
+/**
+ * @brief Modulates count symbols of pseudo-random bits and adds Gaussian noise
+ */
+complex<double> make_received(qam_order order, size_t count, double sigma, uint32_t seed) {
+    const uint32_t bits_per_symbol = ext_make_mapper<double>(order)->get_bits_per_symbol();
+    std::mt19937 rng(seed);
+    std::vector<byte> bits(count * bits_per_symbol / 8);
+    for (auto& b : bits) {
+        b = static_cast<byte>(rng());
+    }
+
+    auto modulator = qam_modulator<double>::make();
+    modulator->set_mapper(ext_make_mapper<double>(order));
+    complex<double> symbols = modulator->modulate(bits);
+
+    std::normal_distribution<double> awgn(0.0, sigma);
+    auto [i, q] = symbols.decompose();
+    for (size_t s = 0; s < count; ++s) {
+        i[s] += awgn(rng);
+        q[s] += awgn(rng);
+    }
+    return symbols;
+}
+
+/**
+ * TEST: decisions find sigma and Es at high SNR for every order, M2M4 only for
+ *       the constant-modulus QPSK (on several rings the noise is a small
+ *       difference of large moments there)
+ */
+bool test_accuracy(noise_method method) {
+    const std::vector<qam_order> orders = method == noise_method::DECISION
+        ? std::vector<qam_order>{qam_order::QPSK, qam_order::QAM16, qam_order::QAM64}
+        : std::vector<qam_order>{qam_order::QPSK};
+    for (qam_order order : orders) {
+        const auto mapper = ext_make_mapper<double>(order);
+        // Es/N0 = 20 dB for every order
+        const double sigma = ext_esn0_to_sigma(20.0, mapper->get_symbol_energy());
+        const size_t count = 120000;
+        const complex<double> rx = make_received(order, count, sigma, 11);
+
+        noise_estimator<double> estimator(mapper, method);
+        const noise_estimate estimate = estimator.estimate(rx, count);
+
+        assert(estimate.symbols == count && "symbol count mismatch");
+        assert(std::fabs(estimate.sigma() / sigma - 1.0) < 0.05 && "sigma estimate off by more than 5 %");
+        assert(std::fabs(estimate.esn0_db() - 20.0) < 0.5 && "Es/N0 estimate off by more than 0.5 dB");
+    }
+    return true;
+}
+
+/**
+ * TEST: at low SNR decisions underestimate the noise, M2M4 does not
+ */
+bool test_low_snr() {
+    const auto mapper = ext_make_mapper<double>(qam_order::QAM16);
+    const double sigma = ext_esn0_to_sigma(5.0, mapper->get_symbol_energy());
+    const size_t count = 200000;
+    const complex<double> rx = make_received(qam_order::QAM16, count, sigma, 5);
+
+    noise_estimator<double> decision(mapper, noise_method::DECISION);
+    noise_estimator<double> moments(mapper, noise_method::M2M4);
+    const double dd = decision.estimate(rx, count).sigma();
+    const double m2m4 = moments.estimate(rx, count).sigma();
+
+    assert(dd < 0.9 * sigma && "decision-directed estimate must be biased low");
+    assert(std::fabs(m2m4 / sigma - 1.0) < 0.05 && "M2M4 estimate off by more than 5 %");
+    return true;
+}
+
+/**
+ * TEST: totals over blocks and merged estimators equal one pass
+ */
+bool test_totals(noise_method method) {
+    const auto mapper = ext_make_mapper<double>(qam_order::QAM16);
+    const size_t count = 4096;
+    const complex<double> rx = make_received(qam_order::QAM16, count, 0.4, 3);
+
+    noise_estimator<double> single(mapper, method);
+    const noise_estimate whole = single.estimate(rx, count);
+
+    const size_t half = count / 2;
+    auto first = complex<double>::make(half * 2), second = complex<double>::make(half * 2);
+    auto [i, q] = rx.decompose();
+    auto [fi, fq] = first.decompose();
+    auto [si, sq] = second.decompose();
+    for (size_t s = 0; s < half; ++s) {
+        fi[s] = i[s];
+        fq[s] = q[s];
+        si[s] = i[half + s];
+        sq[s] = q[half + s];
+    }
+
+    noise_estimator<double> blocks(mapper, method), other(mapper, method);
+    blocks.estimate(first, half);
+    other.estimate(second, half);
+    blocks.merge(other);
+    const noise_estimate merged = blocks.get_total();
+
+    assert(merged.symbols == count && "merged count mismatch");
+    assert(std::fabs(merged.noise_power - whole.noise_power) < 1e-9 && "merged noise mismatch");
+    assert(std::fabs(merged.signal_power - whole.signal_power) < 1e-9 && "merged signal mismatch");
+
+    blocks.reset();
+    assert(blocks.get_total().symbols == 0 && blocks.get_total().noise_power == 0 && "reset mismatch");
+
+    bool thrown = false;
+    try {
+        blocks.merge(noise_estimator<double>(ext_make_mapper<double>(qam_order::QPSK), method));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "merging different constellations must throw");
+    return true;
+}
+
+/**
+ * TEST: the LLR demodulator consumes the block estimate
+ */
+bool test_llr() {
+    const auto mapper = ext_make_mapper<double>(qam_order::QAM16);
+    const double sigma = 0.5;
+    const size_t count = 2000;
+    const complex<double> rx = make_received(qam_order::QAM16, count, sigma, 9);
+
+    noise_estimator<double> estimator(mapper);
+    const noise_estimate estimate = estimator.estimate(rx, count);
+
+    auto demodulator = qam_demodulator<double>::make();
+    demodulator->set_mapper(mapper);
+    channel<double> chan;
+    chan.set_sigma(sigma);
+    assert(demodulator->demodulate_llr(rx, estimate.sigma()) == demodulator->demodulate_llr(rx, chan) &&
+           "LLR decisions with the estimate differ from the true sigma");
+    return true;
+}
+
+int main() {
+    assert(test_accuracy(noise_method::DECISION) == true && "test_accuracy(DECISION) != true");
+    assert(test_accuracy(noise_method::M2M4) == true && "test_accuracy(M2M4) != true");
+    assert(test_low_snr() == true && "test_low_snr() != true");
+    assert(test_totals(noise_method::DECISION) == true && "test_totals(DECISION) != true");
+    assert(test_totals(noise_method::M2M4) == true && "test_totals(M2M4) != true");
+    assert(test_llr() == true && "test_llr() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
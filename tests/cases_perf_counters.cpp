@@ -0,0 +1,80 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "sim/perf_counters.hpp"
+
+/**
+ * TEST: derived values of a sample, missing events
+ */
+bool test_sample_arithmetic() {
+    perf_sample sample;
+    assert(sample.ipc() == 0.0 && "empty sample must have no IPC");
+    assert(sample.report(100).find("IPC n/a") != std::string::npos && "missing events must be n/a");
+
+    perf_sample region;
+    region.regions = 1;
+    region.values[static_cast<size_t>(perf_event_kind::CYCLES)] = 1000;
+    region.values[static_cast<size_t>(perf_event_kind::INSTRUCTIONS)] = 2500;
+    region.values[static_cast<size_t>(perf_event_kind::BRANCH_MISSES)] = 10;
+    region.valid[static_cast<size_t>(perf_event_kind::CYCLES)] = true;
+    region.valid[static_cast<size_t>(perf_event_kind::INSTRUCTIONS)] = true;
+    region.valid[static_cast<size_t>(perf_event_kind::BRANCH_MISSES)] = true;
+
+    // the first region defines which events are valid
+    sample.merge(region);
+    assert(sample.has(perf_event_kind::CYCLES) && "merge into an empty sample must keep events");
+    assert(!sample.has(perf_event_kind::LLC_MISSES) && "unread event must stay missing");
+    assert(sample.ipc() == 2.5 && "IPC mismatch");
+    assert(sample.per_unit(perf_event_kind::BRANCH_MISSES, 100) == 0.1 && "per_unit mismatch");
+    assert(sample.per_unit(perf_event_kind::LLC_MISSES, 100) == 0.0 && "missing event must count 0");
+
+    // an event missing in one region is missing in the sum
+    perf_sample partial = region;
+    partial.valid[static_cast<size_t>(perf_event_kind::BRANCH_MISSES)] = false;
+    sample.merge(partial);
+    assert(sample.regions == 2 && "regions mismatch");
+    assert(sample.get(perf_event_kind::CYCLES) == 2000 && "merge must add counts");
+    assert(!sample.has(perf_event_kind::BRANCH_MISSES) && "partially read event must be missing");
+
+    const std::string report = sample.report(100);
+    assert(report.find("IPC 2.50") != std::string::npos && "report must contain IPC");
+    assert(report.find("branch-misses/sym n/a") != std::string::npos && "report must mark missing events");
+    return true;
+}
+
+/**
+ * TEST: counters of a busy loop (skipped where the machine has no counters)
+ */
+bool test_counters() {
+    auto counters = perf_counters::make();
+    perf_sample sample;
+
+    volatile uint64_t sink = 0;
+    {
+        perf_scope scope(*counters, sample);
+        for (uint64_t i = 0; i < 1000000; ++i) {
+            sink = sink + i;
+        }
+    }
+    assert(sample.regions == 1 && "scope must add one region");
+
+    if (!counters->available()) {
+        std::cout << "Hardware counters unavailable, counting skipped" << std::endl;
+        return true;
+    }
+
+    if (counters->has(perf_event_kind::INSTRUCTIONS) && sample.has(perf_event_kind::INSTRUCTIONS)) {
+        assert(sample.get(perf_event_kind::INSTRUCTIONS) > 1000000 && "loop instructions not counted");
+    }
+    return true;
+}
+
+int main() {
+    assert(test_sample_arithmetic() == true && "test_sample_arithmetic() != true");
+    assert(test_counters() == true && "test_counters() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
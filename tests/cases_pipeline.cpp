@@ -0,0 +1,180 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "phys/qam/mapper.hpp"
+#include "sim/pipeline.hpp"
+#include "sim/spsc_ring.hpp"
+
+/**
+ * TEST: ring capacity, full / empty and wrap-around on one thread
+ */
+bool test_ring_basic() {
+    spsc_ring<uint32_t> ring(3);
+    assert(ring.capacity() == 4 && "capacity must round up to a power of two");
+
+    uint32_t value = 0;
+    assert(!ring.try_pop(value) && "new ring must be empty");
+    for (uint32_t round = 0; round < 5; ++round) {
+        for (uint32_t k = 0; k < 4; ++k) {
+            assert(ring.try_push(round * 4 + k) && "push into a free slot failed");
+        }
+        assert(!ring.try_push(99) && "push into a full ring must fail");
+        assert(ring.size() == 4 && "size mismatch");
+        for (uint32_t k = 0; k < 4; ++k) {
+            assert(ring.try_pop(value) && value == round * 4 + k && "pop order mismatch");
+        }
+        assert(!ring.try_pop(value) && "drained ring must be empty");
+    }
+
+    bool thrown = false;
+    try {
+        spsc_ring<uint32_t> empty(0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "zero capacity must throw");
+    return true;
+}
+
+/**
+ * TEST: a producer and a consumer thread exchange a long sequence in order
+ */
+bool test_ring_threads() {
+    const uint32_t count = 200000;
+    spsc_ring<uint32_t> ring(16);
+
+    std::thread producer([&]() {
+        for (uint32_t k = 0; k < count; ++k) {
+            while (!ring.try_push(k)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool ordered = true;
+    uint32_t value = 0;
+    for (uint32_t k = 0; k < count; ++k) {
+        while (!ring.try_pop(value)) {
+            std::this_thread::yield();
+        }
+        ordered = ordered && value == k;
+    }
+    producer.join();
+
+    assert(ordered && "values arrived out of order");
+    assert(ring.size() == 0 && "ring must be empty after the transfer");
+    return true;
+}
+
+/**
+ * TEST: noiseless runs are error free and every stage sees every block
+ */
+bool test_pipeline_noiseless(size_t depth) {
+    engine_config engine;
+    engine.frame_bytes = 10000;
+    engine.seed = 3;
+    pipeline_config cfg;
+    cfg.block_bytes = 1000;     // 999 after rounding, 11 blocks per frame
+    cfg.depth = depth;
+
+    auto pipeline = sim_pipeline<float>::make(qam_mapper<float, qam_order::QAM16>::make(), engine, cfg);
+    const ber_point point = pipeline->run(0.0, 4);
+
+    assert(point.bits == 4 * 9999 * 8 && point.frames == 4 && "bit count mismatch");
+    assert(point.errors == 0 && "noiseless pipeline must have no errors");
+    assert(pipeline->get_error_stats().bits == point.bits && "counter saw a different payload");
+
+    const pipeline_stats& stats = pipeline->get_stats();
+    for (size_t s = 0; s < PIPELINE_STAGES; ++s) {
+        assert(stats.stages[s].blocks == 4 * 11 && "stage block count mismatch");
+    }
+    // links hold depth blocks (rounded up), the source draws from all 4 * depth
+    for (sim_stage s : {sim_stage::MODULATE, sim_stage::TRANSMIT, sim_stage::DEMODULATE, sim_stage::COUNT}) {
+        assert(stats.at(s).occupancy_max <= spsc_ring<uint32_t>(depth).capacity() && "queue exceeded its bound");
+    }
+    assert(stats.at(sim_stage::GENERATE).occupancy_max <= 4 * depth && "free queue exceeded the pool");
+    assert(!stats.report().empty() && "empty report");
+    return true;
+}
+
+/**
+ * TEST: noisy QPSK matches the theory, repeated runs reuse the blocks
+ */
+bool test_pipeline_noisy() {
+    engine_config engine;
+    engine.frame_bytes = 30000;
+    pipeline_config cfg;
+    cfg.depth = 2;
+
+    auto pipeline = sim_pipeline<float>::make(qam_mapper<float, qam_order::QPSK>::make(), engine, cfg);
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        const ber_point point = pipeline->run(1.0, 3);
+        // QPSK at sigma 1: 0.5 * erfc(1 / sqrt(2)) ~ 0.159
+        assert(point.ber() > 0.12 && point.ber() < 0.20 && "unexpected QPSK BER at sigma = 1");
+    }
+
+    bool thrown = false;
+    try {
+        sim_pipeline<float> broken(nullptr, engine, cfg);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "null mapper must throw");
+    return true;
+}
+
+/**
+ * TEST: a failing stage aborts the others, the error reaches the caller
+ * and the next run starts from empty links
+ */
+bool test_pipeline_failure() {
+    engine_config engine;
+    engine.frame_bytes = 10000;
+    pipeline_config cfg;
+    cfg.block_bytes = 1000;     // 11 blocks per frame
+    cfg.depth = 2;
+
+    auto pipeline = sim_pipeline<float>::make(qam_mapper<float, qam_order::QPSK>::make(), engine, cfg);
+    size_t tapped = 0;
+    pipeline->set_symbol_tap([&tapped](const complex<float>&, size_t) {
+        if (++tapped == 5) {
+            throw std::runtime_error("tap failed");
+        }
+    });
+
+    bool thrown = false;
+    try {
+        pipeline->run(0.0, 20);
+    } catch (const std::runtime_error& e) {
+        thrown = std::string(e.what()) == "tap failed";
+    }
+    assert(thrown && "stage exception must reach the caller");
+    assert(tapped == 5 && "transmit stage must stop at the failing block");
+    assert(pipeline->get_stats().bits == 0 && "failed run must not be accounted");
+
+    // stale blocks left in the links would be counted twice
+    pipeline->set_symbol_tap({});
+    const ber_point point = pipeline->run(0.0, 2);
+    assert(point.errors == 0 && pipeline->get_error_stats().bits == point.bits && "run after a failure is broken");
+    for (size_t s = 0; s < PIPELINE_STAGES; ++s) {
+        assert(pipeline->get_stats().stages[s].blocks == 2 * 11 && "stale block in a link");
+    }
+    return true;
+}
+
+int main() {
+    assert(test_ring_basic() == true && "test_ring_basic() != true");
+    assert(test_ring_threads() == true && "test_ring_threads() != true");
+    assert(test_pipeline_noiseless(1) == true && "test_pipeline_noiseless(1) != true");
+    assert(test_pipeline_noiseless(8) == true && "test_pipeline_noiseless(8) != true");
+    assert(test_pipeline_noisy() == true && "test_pipeline_noisy() != true");
+    assert(test_pipeline_failure() == true && "test_pipeline_failure() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "phys/qam/mapper.hpp"
+#include "sim/engine.hpp"
+#include "sim/profile.hpp"
+
+/**
+ * TEST: throughput, shares and merging of a profile
+ */
+bool test_profile_arithmetic() {
+    stage_profile profile;
+    assert(profile.symbols_per_second() == 0.0 && "empty profile must report no throughput");
+    assert(profile.stage_share(sim_stage::MODULATE) == 0.0 && "empty profile must report no share");
+
+    profile.total_ns = 2000000000;
+    profile.symbols = 4000000;
+    profile.bits = 8000000;
+    profile.stage_ns[static_cast<size_t>(sim_stage::MODULATE)] = 500000000;
+    assert(profile.symbols_per_second() == 2e6 && "symbols_per_second mismatch");
+    assert(profile.bits_per_second() == 4e6 && "bits_per_second mismatch");
+    assert(profile.stage_share(sim_stage::MODULATE) == 0.25 && "stage_share mismatch");
+
+    stage_profile other = profile;
+    other.merge(profile);
+    assert(other.total_ns == 2 * profile.total_ns && "merge must add time");
+    assert(other.symbols == 2 * profile.symbols && "merge must add symbols");
+    assert(other.stage_share(sim_stage::MODULATE) == 0.25 && "merge must keep shares");
+
+    assert(profile.report().find("Msym/s") != std::string::npos && "report must contain throughput");
+    assert(std::string(stage_profile::stage_name(sim_stage::DEMODULATE)) == "demodulate" && "stage_name mismatch");
+
+    other.reset();
+    assert(other.total_ns == 0 && other.bits == 0 && "reset must clear counts");
+    return true;
+}
+
+/**
+ * TEST: the engine fills its profile, stage times fit into the run time
+ */
+bool test_engine_profile(bool fused) {
+    engine_config cfg;
+    cfg.frame_bytes = 6000;
+    cfg.tile_bytes = 600;
+    cfg.fused = fused;
+    cfg.seed = 3;
+
+    auto engine = sim_engine<float>::make(qam_mapper<float, qam_order::QAM16>::make(), cfg);
+    engine->run(0.5, 4);
+
+    const stage_profile& profile = engine->get_profile();
+    assert(profile.bits == 4 * 6000 * 8 && "profile bits mismatch");
+    assert(profile.symbols == profile.bits / 4 && "profile symbols mismatch");
+    assert(profile.total_ns > 0 && "run time not recorded");
+
+    uint64_t stages_ns = 0;
+    for (uint64_t ns : profile.stage_ns) {
+        stages_ns += ns;
+    }
+    if (stage_profile::STAGES_ENABLED) {
+        assert(profile.stage_ns[static_cast<size_t>(sim_stage::GENERATE)] > 0 && "generate stage not timed");
+        assert(profile.stage_ns[static_cast<size_t>(fused ? sim_stage::FUSED : sim_stage::DEMODULATE)] > 0 && "stage not timed");
+        assert(stages_ns <= profile.total_ns && "stages exceed the run time");
+    } else {
+        assert(stages_ns == 0 && "stages must not be timed without SIM_STAGE_TIMING");
+    }
+
+    engine->run(0.5, 1);
+    assert(profile.bits == 5 * 6000 * 8 && "profile must accumulate over runs");
+    engine->reset_profile();
+    assert(profile.bits == 0 && profile.total_ns == 0 && "reset_profile must clear counts");
+    return true;
+}
+
+int main() {
+    assert(test_profile_arithmetic() == true && "test_profile_arithmetic() != true");
+    assert(test_engine_profile(true) == true && "test_engine_profile(fused) != true");
+    assert(test_engine_profile(false) == true && "test_engine_profile(staged) != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+#include <bit>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/slicer.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "phys/qam/qam_demodulator.hpp"
+#include "phys/qam/qam_fused.hpp"
+#include "phys/chan.hpp"
+
+std::vector<byte> random_bytes(size_t length, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<byte> bytes(length);
+    for (auto& b : bytes) {
+        b = static_cast<byte>(rng());
+    }
+    return bytes;
+}
+
+/**
+ * TEST: grid slicer gives the nearest point
+ */
+template<qam_order ORDER>
+bool test_slicer_matches_exhaustive() {
+    auto mapper = qam_mapper<double, ORDER>::make();
+    auto table = ext_make_table(*mapper);
+    qam_slicer<double> slicer(table);
+
+    assert(slicer.is_grid() && "default constellation must be sliced per axis");
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-9.0, 9.0);
+
+    for (int n = 0; n < 20000; ++n) {
+        double i = dist(rng);
+        double q = dist(rng);
+
+        uint32_t nearest = 0;
+        double min_distance = std::numeric_limits<double>::max();
+        for (size_t p = 0; p < table.points.size(); ++p) {
+            double d = (i - table.points[p].i) * (i - table.points[p].i) + 
+                       (q - table.points[p].q) * (q - table.points[p].q);
+            if (d < min_distance) {
+                min_distance = d;
+                nearest = table.indices[p];
+            }
+        }
+
+        assert(slicer.slice(i, q) == nearest && "slicer decision != nearest point");
+    }
+
+    return true;
+}
+
+/**
+ * TEST: non-rectangular constellation falls back to the exhaustive search
+ */
+bool test_slicer_fallback() {
+    auto mapper = qam_mapper<float, qam_order::QPSK>::make();
+    mapper->set_generator([]() {
+        qam_mapper<float, qam_order::QPSK>::constellation_map_type map;
+        map[0] = {1.0f, 0.0f};
+        map[1] = {0.0f, 1.0f};
+        map[2] = {-1.0f, 0.0f};
+        map[3] = {0.0f, -1.0f};
+        return map;
+    });
+
+    qam_slicer<float> slicer(ext_make_table(*mapper));
+    assert(!slicer.is_grid() && "rotated QPSK is not a grid");
+    assert(slicer.slice(0.9f, 0.1f) == 0 && "fallback decision mismatch");
+    assert(slicer.slice(-0.1f, -0.8f) == 3 && "fallback decision mismatch");
+
+    return true;
+}
+
+/**
+ * TEST: fused kernel counts the same errors as the staged chain
+ */
+template<qam_order ORDER>
+bool test_fused_matches_staged(double sigma) {
+    auto mapper = qam_mapper<float, ORDER>::make();
+    auto modulator = qam_modulator<float>::make();
+    auto demodulator = qam_demodulator<float>::make();
+    modulator->set_mapper(mapper);
+    demodulator->set_mapper(mapper);
+
+    auto bits = random_bytes(3 * 1000, 11);
+
+    channel<float> staged_chan(sigma);
+    channel<float> fused_chan = staged_chan;   // same noise sequence and position
+
+    auto symbols = modulator->modulate(bits);
+    auto noisy = staged_chan.transmit(symbols);
+    auto rx_bits = demodulator->demodulate(noisy);
+
+    uint64_t staged_errors = 0;
+    for (size_t i = 0; i < bits.size(); ++i) {
+        staged_errors += std::popcount(static_cast<byte>(bits[i] ^ rx_bits[i]));
+    }
+
+    qam_fused_kernel<float, ORDER> kernel(*mapper);
+    std::vector<uint64_t> bit_errors(qam_fused_kernel<float, ORDER>::BITS_PER_SYMBOL, 0);
+    uint64_t fused_errors = kernel.run(bits, fused_chan, bit_errors);
+
+    assert(fused_errors == staged_errors && "fused error count != staged error count");
+
+    uint64_t per_position = 0;
+    for (auto count : bit_errors) {
+        per_position += count;
+    }
+    assert(per_position == fused_errors && "per-position counts must sum to the error count");
+
+    return true;
+}
+
+/**
+ * TEST: fused kernel rejects partial symbols
+ */
+bool test_fused_partial_symbol() {
+    auto mapper = qam_mapper<float, qam_order::QAM64>::make();
+    qam_fused_kernel<float, qam_order::QAM64> kernel(*mapper);
+    channel<float> chan(0.0);
+
+    std::vector<byte> bits(4, 0xFF);
+    try {
+        kernel.run(bits, chan);
+        assert(false && "partial symbol should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    return true;
+}
+
+int main() {
+    assert(test_slicer_matches_exhaustive<qam_order::QPSK>() == true && "test_slicer_matches_exhaustive<QPSK>() != true");
+    assert(test_slicer_matches_exhaustive<qam_order::QAM16>() == true && "test_slicer_matches_exhaustive<QAM16>() != true");
+    assert(test_slicer_matches_exhaustive<qam_order::QAM64>() == true && "test_slicer_matches_exhaustive<QAM64>() != true");
+    assert(test_slicer_fallback() == true && "test_slicer_fallback() != true");
+
+    assert(test_fused_matches_staged<qam_order::QPSK>(0.0) == true && "test_fused_matches_staged<QPSK>(0.0) != true");
+    assert(test_fused_matches_staged<qam_order::QPSK>(0.8) == true && "test_fused_matches_staged<QPSK>(0.8) != true");
+    assert(test_fused_matches_staged<qam_order::QAM16>(0.6) == true && "test_fused_matches_staged<QAM16>(0.6) != true");
+    assert(test_fused_matches_staged<qam_order::QAM64>(0.5) == true && "test_fused_matches_staged<QAM64>(0.5) != true");
+    assert(test_fused_partial_symbol() == true && "test_fused_partial_symbol() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "sim/job.hpp"
+#include "sim/result_cache.hpp"
+
+const char* CACHE_FILE = "cases_result_cache.bin";
+
+/**
+ * TEST: entries survive a save / load round trip, fewer frames never replace more
+ */
+bool test_cache_round_trip() {
+    std::remove(CACHE_FILE);
+
+    result_cache cache(CACHE_FILE);
+    assert(!cache.load() && "missing file must not load");
+
+    ber_point point;
+    point.sigma = 0.5;
+    point.bits = 1000;
+    point.errors = 12;
+    point.frames = 4;
+    cache.store(42, point);
+
+    ber_point smaller = point;
+    smaller.frames = 2;
+    cache.store(42, smaller);
+    assert(cache.find(42)->frames == 4 && "fewer frames must not replace a cached point");
+    cache.save();
+
+    result_cache loaded(CACHE_FILE);
+    assert(loaded.load() && "saved cache must load");
+    assert(loaded.size() == 1 && "wrong number of entries");
+
+    auto found = loaded.find(42);
+    assert(found && found->sigma == 0.5 && found->bits == 1000 && found->errors == 12 && "entry mismatch");
+    assert(!loaded.find(43) && "unknown key must miss");
+
+    std::ofstream(CACHE_FILE, std::ios::trunc) << "garbage";
+    try {
+        loaded.load();
+        assert(false && "corrupted cache should throw");
+    } catch (const std::runtime_error& e) {
+        // pass
+    }
+
+    std::remove(CACHE_FILE);
+    return true;
+}
+
+/**
+ * TEST: point keys depend on the statistics-relevant configuration only
+ */
+bool test_point_key() {
+    sweep_job job;
+    job.engine.seed = 1;
+    const uint64_t key = job.point_key(0.5);
+
+    sweep_job other = job;
+    other.frames = 1000;
+    other.engine.tile_bytes = 999;
+    other.engine.fused = false;
+    assert(other.point_key(0.5) == key && "budget and tiling must not change the key");
+
+    other = job;
+    other.modulation = qam_order::QAM16;
+    assert(other.point_key(0.5) != key && "modulation must change the key");
+
+    other = job;
+    other.dtype = sample_type::DOUBLE;
+    assert(other.point_key(0.5) != key && "dtype must change the key");
+
+    other = job;
+    other.engine.frame_bytes = 3000;
+    assert(other.point_key(0.5) != key && "frame length must change the key");
+
+    other = job;
+    other.engine.seed = 2;
+    assert(other.point_key(0.5) != key && "seed must change the key");
+
+    assert(job.point_key(0.55) != key && "sigma must change the key");
+
+    return true;
+}
+
+/**
+ * TEST: cached points are reused, under-sampled ones are topped up
+ */
+bool test_runner_uses_cache() {
+    std::istringstream spec(
+        "frame_bytes = 3000\n"
+        "chunk_frames = 1\n"
+        "seed = 9\n"
+        "[job]\n"
+        "modulation = QPSK\n"
+        "sigma = 0:1:0.5\n"
+        "frames = 2\n"
+        "output = unused.csv\n");
+    job_batch batch = parse_job_spec(spec);
+
+    result_cache cache(CACHE_FILE);
+    auto runner = batch_runner::make(2);
+    runner->set_cache(&cache);
+
+    auto first = runner->run(batch.jobs);
+    assert(first[0].simulated_frames == 3 * 2 && "empty cache: everything is simulated");
+    assert(cache.size() == 3 && "every point must be cached");
+
+    auto second = runner->run(batch.jobs);
+    assert(second[0].simulated_frames == 0 && "cached points must not be simulated again");
+    for (size_t i = 0; i < 3; ++i) {
+        assert(second[0].points[i].errors == first[0].points[i].errors && "cached counts must be returned");
+    }
+
+    // tighter budget: only the missing frames are run
+    batch.jobs[0].frames = 5;
+    auto topped = runner->run(batch.jobs);
+    assert(topped[0].simulated_frames == 3 * 3 && "top-up must run the missing frames only");
+    for (size_t i = 0; i < 3; ++i) {
+        assert(topped[0].points[i].frames == 5 && "topped-up point must reach the budget");
+        assert(topped[0].points[i].errors >= first[0].points[i].errors && "top-up must keep the cached counts");
+    }
+
+    // a new modulation next to cached ones simulates just the new curve
+    batch.jobs.push_back(batch.jobs[0]);
+    batch.jobs[1].modulation = qam_order::QAM16;
+    auto extended = runner->run(batch.jobs);
+    assert(extended[0].simulated_frames == 0 && "cached curve must not be recomputed");
+    assert(extended[1].simulated_frames == 3 * 5 && "new curve must be simulated");
+
+    std::remove(CACHE_FILE);
+    return true;
+}
+
+int main() {
+    assert(test_cache_round_trip() == true && "test_cache_round_trip() != true");
+    assert(test_point_key() == true && "test_point_key() != true");
+    assert(test_runner_uses_cache() == true && "test_runner_uses_cache() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "file/result_writer.hpp"
+
+const char* CSV_FILE = "cases_result_writer.csv";
+const char* BINARY_FILE = "cases_result_writer.bin";
+
+std::string read_text(const std::string& filename) {
+    std::ifstream file(filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/**
+ * TEST: CSV formatting per column matches the fixed / scientific precision
+ */
+bool test_csv_format(bool background) {
+    result_writer_config cfg;
+    cfg.background = background;
+    {
+        result_writer writer(CSV_FILE, {{"sigma", 4}, {"ber", 15}, {"theory_ber", 6, true}}, result_format::CSV, cfg);
+        writer.push({0.25, 0.0123, 1.5e-7});
+        writer.push({1.0, 0.5, 0.25});
+        assert(writer.get_records() == 2 && "record count mismatch");
+    }
+
+    const std::string expected = 
+        "sigma,ber,theory_ber\n"
+        "0.2500,0.012300000000000,1.500000e-07\n"
+        "1.0000,0.500000000000000,2.500000e-01\n";
+    assert(read_text(CSV_FILE) == expected && "CSV content mismatch");
+    std::remove(CSV_FILE);
+    return true;
+}
+
+/**
+ * TEST: many records through small buffers arrive complete and in order
+ */
+bool test_buffer_rotation(bool background) {
+    result_writer_config cfg;
+    cfg.buffer_bytes = 256;
+    cfg.background = background;
+
+    const size_t records = 20000;
+    result_writer writer(BINARY_FILE, {{"index"}, {"square"}}, result_format::BINARY, cfg);
+    for (size_t i = 0; i < records; ++i) {
+        writer.push({static_cast<double>(i), static_cast<double>(i * i)});
+        if (i == records / 2) {
+            writer.flush();
+            assert(result_writer::load_binary(BINARY_FILE).rows() == i + 1 && "flush must write all records");
+        }
+    }
+    writer.close();
+
+    result_table table = result_writer::load_binary(BINARY_FILE);
+    assert(table.columns.size() == 2 && table.columns[1] == "square" && "column names mismatch");
+    assert(table.rows() == records && "row count mismatch");
+    for (size_t i = 0; i < records; ++i) {
+        assert(table.at(i, 0) == static_cast<double>(i) && table.at(i, 1) == static_cast<double>(i * i) && "record mismatch");
+    }
+    std::remove(BINARY_FILE);
+    return true;
+}
+
+/**
+ * TEST: invalid records and files are rejected
+ */
+bool test_errors() {
+    bool thrown = false;
+    try {
+        result_writer writer(CSV_FILE, {});
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "writer without columns must throw");
+
+    thrown = false;
+    try {
+        result_writer writer("/nonexistent_dir/result.csv", {{"x"}});
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "unwritable file must throw");
+
+    result_writer writer(CSV_FILE, {{"x"}, {"y"}});
+    thrown = false;
+    try {
+        writer.push({1.0});
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "short record must throw");
+    writer.close();
+
+    thrown = false;
+    try {
+        result_writer::load_binary(CSV_FILE);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "CSV file must not load as binary");
+    std::remove(CSV_FILE);
+    return true;
+}
+
+int main() {
+    assert(test_csv_format(true) == true && "test_csv_format(background) != true");
+    assert(test_csv_format(false) == true && "test_csv_format(inline) != true");
+    assert(test_buffer_rotation(true) == true && "test_buffer_rotation(background) != true");
+    assert(test_buffer_rotation(false) == true && "test_buffer_rotation(inline) != true");
+    assert(test_errors() == true && "test_errors() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "sim/shard.hpp"
+
+shard_plan make_plan(uint32_t shard_count) {
+    shard_plan plan;
+    plan.modulations        = {qam_order::QPSK, qam_order::QAM64};
+    plan.sigmas             = {0.0, 0.5, 1.0};
+    plan.blocks_per_point   = 3;
+    plan.frames_per_block   = 1;
+    plan.shard_count        = shard_count;
+    plan.engine.frame_bytes = 3000;
+    plan.engine.seed        = 17;
+    return plan;
+}
+
+/**
+ * TEST: every cell gets all of its frames, whatever the number of shards
+ */
+bool test_shards_cover_plan() {
+    shard_plan plan = make_plan(4);
+
+    for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+        run_shard<float>(plan, shard, shard_file_name(".", shard));
+    }
+
+    auto cells = merge_shards(plan, ".");
+    assert(cells.size() == 6 && "one cell per (modulation, sigma)");
+
+    for (const auto& cell : cells) {
+        assert(cell.point.frames == plan.blocks_per_point * plan.frames_per_block && "missing frames");
+        assert(cell.point.bits == cell.point.frames * 3000 * 8 && "bit accounting mismatch");
+        if (cell.point.sigma == 0.0) {
+            assert(cell.point.errors == 0 && "noiseless cell must not have errors");
+        }
+    }
+
+    assert(cells[1].point.ber() > 0.0 && "noisy cell must have errors");
+
+    for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+        std::remove(shard_file_name(".", shard).c_str());
+    }
+    return true;
+}
+
+/**
+ * TEST: the merged counts are the same for 1 and 4 shards
+ */
+bool test_shards_deterministic() {
+    std::vector<std::vector<shard_cell>> merged;
+    for (uint32_t shard_count : {1u, 4u}) {
+        shard_plan plan = make_plan(shard_count);
+        for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+            run_shard<float>(plan, shard, shard_file_name(".", shard));
+        }
+        merged.push_back(merge_shards(plan, "."));
+        for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+            std::remove(shard_file_name(".", shard).c_str());
+        }
+    }
+
+    assert(merged[0].size() == merged[1].size() && "cell count mismatch");
+    for (size_t c = 0; c < merged[0].size(); ++c) {
+        assert(merged[0][c].point.errors == merged[1][c].point.errors && "errors depend on the shard split");
+        assert(merged[0][c].point.bits == merged[1][c].point.bits && "bits depend on the shard split");
+    }
+    return true;
+}
+
+/**
+ * TEST: local launcher forks the workers and merges their files
+ */
+bool test_local_launcher() {
+    shard_plan plan = make_plan(3);
+    auto cells = launch_local_shards<float>(plan, ".");
+
+    for (const auto& cell : cells) {
+        assert(cell.point.frames == plan.blocks_per_point * plan.frames_per_block && "missing frames");
+    }
+
+    for (uint32_t shard = 0; shard < plan.shard_count; ++shard) {
+        std::remove(shard_file_name(".", shard).c_str());
+    }
+    return true;
+}
+
+/**
+ * TEST: shard files of another plan or missing shards are rejected
+ */
+bool test_merge_rejects_foreign_shards() {
+    shard_plan plan = make_plan(2);
+    run_shard<float>(plan, 0, shard_file_name(".", 0));
+
+    try {
+        merge_shards(plan, ".");
+        assert(false && "missing shard should throw");
+    } catch (const std::runtime_error& e) {
+        // pass
+    }
+
+    shard_plan other = make_plan(2);
+    other.engine.seed = 18;
+    run_shard<float>(other, 1, shard_file_name(".", 1));
+
+    try {
+        merge_shards(plan, ".");
+        assert(false && "shard of another plan should throw");
+    } catch (const std::runtime_error& e) {
+        // pass
+    }
+
+    // same grid and seed, other energy normalisation
+    shard_plan unit = make_plan(2);
+    unit.engine.unit_energy = true;
+    run_shard<float>(unit, 1, shard_file_name(".", 1));
+
+    try {
+        merge_shards(plan, ".");
+        assert(false && "shard with another unit_energy should throw");
+    } catch (const std::runtime_error& e) {
+        // pass
+    }
+
+    std::remove(shard_file_name(".", 0).c_str());
+    std::remove(shard_file_name(".", 1).c_str());
+    return true;
+}
+
+int main() {
+    assert(test_shards_cover_plan() == true && "test_shards_cover_plan() != true");
+    assert(test_shards_deterministic() == true && "test_shards_deterministic() != true");
+    assert(test_local_launcher() == true && "test_local_launcher() != true");
+    assert(test_merge_rejects_foreign_shards() == true && "test_merge_rejects_foreign_shards() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
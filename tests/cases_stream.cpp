@@ -0,0 +1,101 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "file/iq_file.hpp"
+#include "phys/qam/mapper.hpp"
+#include "phys/qam/qam_modulator.hpp"
+#include "sim/stream.hpp"
+
+const char* PAYLOAD_FILE = "cases_stream.bin";
+const char* IQ_FILE = "cases_stream.iq";
+
+std::vector<byte> write_payload(size_t size) {
+    std::vector<byte> bits(size);
+    for (size_t i = 0; i < size; ++i) {
+        bits[i] = static_cast<byte>(i * 131 + (i >> 8));
+    }
+    std::ofstream file(PAYLOAD_FILE, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bits.data()), static_cast<std::streamsize>(bits.size()));
+    return bits;
+}
+
+/**
+ * TEST: blocks that split bit groups give the symbols of one modulate() call
+ */
+template<typename DTYPE>
+bool test_stream_matches_modulate(qam_order order, size_t payload_bytes, size_t block_bytes, bool background) {
+    const std::vector<byte> bits = write_payload(payload_bytes);
+
+    auto modulator = qam_modulator<DTYPE>::make();
+    modulator->set_mapper(ext_make_mapper<DTYPE>(order));
+    const complex<DTYPE> expected = modulator->modulate(bits);
+
+    stream_config cfg;
+    cfg.block_bytes = block_bytes;
+    cfg.background = background;
+    cfg.iq.block_samples = 77;
+    const stream_stats stats = ext_stream_modulate<DTYPE>(PAYLOAD_FILE, IQ_FILE, ext_make_mapper<DTYPE>(order), cfg);
+
+    iq_reader<DTYPE> reader(IQ_FILE);
+    assert(stats.bytes_in == payload_bytes && "byte count mismatch");
+    assert(stats.samples == expected.size() / 2 && reader.size() == stats.samples && "symbol count mismatch");
+    assert(reader.get_header().modulation == static_cast<uint32_t>(order) && "modulation not recorded");
+
+    auto symbols = complex<DTYPE>::make(reader.size() * 2);
+    reader.read(0, reader.size(), symbols);
+    for (size_t s = 0; s < reader.size(); ++s) {
+        assert(symbols[s] == expected[s] && "streamed symbol mismatch");
+    }
+
+    std::remove(PAYLOAD_FILE);
+    std::remove(IQ_FILE);
+    return true;
+}
+
+/**
+ * TEST: empty payloads, zero blocks and missing files
+ */
+bool test_stream_edges() {
+    write_payload(0);
+    const stream_stats stats = ext_stream_modulate<float>(PAYLOAD_FILE, IQ_FILE, ext_make_mapper<float>(qam_order::QPSK));
+    assert(stats.samples == 0 && iq_reader<float>(IQ_FILE).size() == 0 && "empty payload must give an empty file");
+
+    stream_config cfg;
+    cfg.block_bytes = 0;
+    bool thrown = false;
+    try {
+        ext_stream_modulate<float>(PAYLOAD_FILE, IQ_FILE, ext_make_mapper<float>(qam_order::QPSK), cfg);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && "zero block size must throw");
+
+    std::remove(PAYLOAD_FILE);
+    thrown = false;
+    try {
+        ext_stream_modulate<float>(PAYLOAD_FILE, IQ_FILE, ext_make_mapper<float>(qam_order::QPSK));
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "missing payload must throw");
+
+    std::remove(IQ_FILE);
+    return true;
+}
+
+int main() {
+    // QAM64 groups are 3 bytes: 4096-byte blocks carry 1 or 2 bytes, 20001 bytes end in a partial symbol
+    assert(test_stream_matches_modulate<float>(qam_order::QAM64, 20001, 4096, true) == true && "test_stream_matches_modulate<float>(QAM64) != true");
+    assert(test_stream_matches_modulate<float>(qam_order::QAM64, 12288, 1, true) == true && "test_stream_matches_modulate<float>(QAM64, 1) != true");
+    assert(test_stream_matches_modulate<double>(qam_order::QAM64, 10000, 4096, false) == true && "test_stream_matches_modulate<double>(QAM64) != true");
+    assert(test_stream_matches_modulate<float>(qam_order::QAM16, 10000, 8192, true) == true && "test_stream_matches_modulate<float>(QAM16) != true");
+    assert(test_stream_matches_modulate<double>(qam_order::QPSK, 9000, 4096, true) == true && "test_stream_matches_modulate<double>(QPSK) != true");
+    assert(test_stream_edges() == true && "test_stream_edges() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
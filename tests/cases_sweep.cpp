@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include "sim/sweep.hpp"
+
+/**
+ * Synthetic waterfall: BER = 0.5 * erfc(1 / (sqrt(2) * sigma)) with 1e6 bits per point
+ */
+ber_point synthetic_point(double sigma) {
+    ber_point point;
+    point.sigma = sigma;
+    point.bits  = 1000000;
+
+    double ber = sigma > 0 ? 0.5 * std::erfc(1.0 / (std::sqrt(2.0) * sigma)) : 0.0;
+    point.errors = static_cast<uint64_t>(ber * point.bits);
+    return point;
+}
+
+/**
+ * TEST: budget is respected and the result is sorted
+ */
+bool test_sweep_budget_sorted() {
+    adaptive_sweep::config cfg;
+    cfg.sigma_start   = 0.0;
+    cfg.sigma_end     = 4.0;
+    cfg.coarse_points = 9;
+    cfg.point_budget  = 40;
+
+    size_t calls = 0;
+    adaptive_sweep sweep(cfg);
+    auto points = sweep.run([&](double sigma) { 
+        ++calls; 
+        return synthetic_point(sigma); 
+    });
+
+    assert(points.size() == calls && "every evaluation must produce a point");
+    assert(points.size() <= cfg.point_budget && "point budget exceeded");
+    assert(points.size() > cfg.coarse_points && "no refinement happened");
+    assert(points.front().sigma == cfg.sigma_start && "first point != sigma_start");
+    assert(points.back().sigma == cfg.sigma_end && "last point != sigma_end");
+
+    for (size_t i = 1; i < points.size(); ++i) {
+        assert(points[i - 1].sigma < points[i].sigma && "points are not sorted by sigma");
+    }
+
+    return true;
+}
+
+/**
+ * TEST: refinement concentrates on the waterfall, not on the flat tail
+ */
+bool test_sweep_refines_waterfall() {
+    adaptive_sweep::config cfg;
+    cfg.sigma_start   = 0.0;
+    cfg.sigma_end     = 4.0;
+    cfg.coarse_points = 9;
+    cfg.point_budget  = 40;
+
+    adaptive_sweep sweep(cfg);
+    auto points = sweep.run(synthetic_point);
+
+    // waterfall of the synthetic curve lives in (0, 1], flat tail in [2, 4]
+    size_t waterfall = 0;
+    size_t tail = 0;
+    for (const auto& point : points) {
+        if (point.sigma > 0.0 && point.sigma <= 1.0) waterfall++;
+        if (point.sigma >= 2.0) tail++;
+    }
+
+    assert(waterfall > tail && "waterfall must get more points than the flat tail");
+    return true;
+}
+
+/**
+ * TEST: flat curve stops at the coarse grid
+ */
+bool test_sweep_flat_curve() {
+    adaptive_sweep::config cfg;
+    cfg.coarse_points = 5;
+    cfg.point_budget  = 100;
+
+    adaptive_sweep sweep(cfg);
+    auto points = sweep.run([](double) {
+        ber_point point;
+        point.bits   = 1000;
+        point.errors = 500;
+        return point;
+    });
+
+    assert(points.size() == cfg.coarse_points && "flat curve must not be refined");
+    return true;
+}
+
+/**
+ * TEST: invalid configuration
+ */
+bool test_sweep_invalid_config() {
+    adaptive_sweep::config cfg;
+    cfg.coarse_points = 1;
+
+    try {
+        adaptive_sweep sweep(cfg);
+        assert(false && "coarse_points < 2 should throw");
+    } catch (const std::invalid_argument& e) {
+        // pass
+    }
+
+    return true;
+}
+
+int main() {
+    assert(test_sweep_budget_sorted() == true && "test_sweep_budget_sorted() != true");
+    assert(test_sweep_refines_waterfall() == true && "test_sweep_refines_waterfall() != true");
+    assert(test_sweep_flat_curve() == true && "test_sweep_flat_curve() != true");
+    assert(test_sweep_invalid_config() == true && "test_sweep_invalid_config() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "phys/chan.hpp"
+#include "phys/qam/mapper.hpp"
+#include "sim/engine.hpp"
+#include "sim/theory.hpp"
+
+bool close(double a, double b, double tolerance) {
+    return std::fabs(a - b) <= tolerance * std::fabs(b);
+}
+
+/**
+ * TEST: Q function reference values
+ */
+bool test_qfunc() {
+    assert(close(ext_qfunc(0.0), 0.5, 1e-12) && "Q(0) != 0.5");
+    assert(close(ext_qfunc(1.959963985), 0.025, 1e-6) && "Q(1.96) != 0.025");
+    assert(close(ext_qfunc(-1.0), 1.0 - ext_qfunc(1.0), 1e-12) && "Q(-x) != 1 - Q(x)");
+    return true;
+}
+
+/**
+ * TEST: exact table theory of QPSK equals the closed form
+ */
+bool test_qpsk_closed_form() {
+    auto mapper = qam_mapper<double, qam_order::QPSK>::make();
+    constellation_theory theory(ext_make_table(*mapper, true), 2);
+
+    std::vector<double> ebn0_db = {0.0, 4.0, 8.0, 12.0};
+    auto ber = ext_gray_qam_ber(qam_order::QPSK, ebn0_db);
+
+    for (size_t i = 0; i < ebn0_db.size(); ++i) {
+        const double sigma = ext_ebn0_to_sigma(ebn0_db[i], 2);
+        theory_point point = theory.at_sigma(sigma);
+        assert(close(point.ber, ber[i], 1e-6) && "QPSK BER mismatch");
+        assert(close(point.ser, ext_gray_qam_ser(qam_order::QPSK, ebn0_db[i] + 10 * std::log10(2.0)), 1e-6) && "QPSK SER mismatch");
+    }
+
+    assert(close(ber[1], 1.25e-2, 0.01) && "QPSK BER at 4 dB");
+    return true;
+}
+
+/**
+ * TEST: per-axis Gray labelling reaches the Gray approximation, the default
+ *       labelling has the same SER but more bit errors per symbol error
+ */
+template<qam_order ORDER>
+bool test_labelling(uint32_t side) {
+    const uint32_t bits_per_symbol = ext_get_bits_per_symbol(ORDER);
+    const uint32_t half = bits_per_symbol / 2;
+
+    // Gray code per axis: index = gray(level_i) << half | gray(level_q)
+    qam_table<double> gray;
+    for (uint32_t li = 0; li < side; ++li) {
+        for (uint32_t lq = 0; lq < side; ++lq) {
+            gray.indices.push_back(((li ^ (li >> 1)) << half) | (lq ^ (lq >> 1)));
+            gray.points.push_back({2.0 * li - (side - 1.0), 2.0 * lq - (side - 1.0)});
+        }
+    }
+
+    constellation_theory gray_theory(gray, bits_per_symbol);
+    auto mapper = qam_mapper<double, ORDER>::make();
+    constellation_theory default_theory(ext_make_table(*mapper), bits_per_symbol);
+
+    assert(close(gray_theory.get_symbol_energy(), mapper->get_symbol_energy(), 1e-12) && "energy mismatch");
+
+    const double es = gray_theory.get_symbol_energy();
+    for (double ebn0_db : {6.0, 10.0, 14.0}) {
+        const double sigma = ext_ebn0_to_sigma(ebn0_db, bits_per_symbol, es);
+        const double esn0_db = ebn0_db + 10 * std::log10(static_cast<double>(bits_per_symbol));
+
+        theory_point exact = gray_theory.at_sigma(sigma);
+        assert(close(exact.ser, ext_gray_qam_ser(ORDER, esn0_db), 1e-6) && "Gray SER mismatch");
+        assert(close(exact.ber, ext_gray_qam_ber(ORDER, ebn0_db), 0.05) && "Gray BER approximation off");
+
+        theory_point labelled = default_theory.at_sigma(sigma);
+        assert(close(labelled.ser, exact.ser, 1e-6) && "labelling must not change SER");
+        assert(labelled.ber > exact.ber && "default labelling is not Gray per axis");
+    }
+
+    return true;
+}
+
+/**
+ * TEST: simulated unit-energy curves follow the exact table theory
+ */
+template<qam_order ORDER>
+bool test_simulation_matches(double ebn0_db) {
+    engine_config cfg;
+    cfg.frame_bytes = 30000;
+    cfg.unit_energy = true;
+    cfg.seed        = 1;
+
+    auto mapper = qam_mapper<double, ORDER>::make();
+    auto engine = sim_engine<double>::make(mapper, cfg);
+    constellation_theory theory(ext_make_table(*mapper, true), mapper->get_bits_per_symbol());
+
+    const double sigma = ext_ebn0_to_sigma(ebn0_db, mapper->get_bits_per_symbol());
+    ber_point point = engine->run(sigma, 8);
+    const double expected = theory.at_sigma(sigma).ber;
+
+    assert(close(point.ber(), expected, 0.1) && "simulated BER off the exact theory");
+    return true;
+}
+
+/**
+ * TEST: frame budget and deviation helpers
+ */
+bool test_budget_and_deviation() {
+    assert(ext_plan_frames(1e-3, 8000, 100, 1, 1000) == 13 && "budget for 100 errors");
+    assert(ext_plan_frames(1e-9, 8000, 100, 1, 1000) == 1000 && "budget must be capped");
+    assert(ext_plan_frames(0.4, 8000, 100, 5, 1000) == 5 && "budget must respect min_frames");
+    assert(ext_plan_frames(0.0, 8000, 100, 5, 1000) == 1000 && "zero BER takes the whole budget");
+
+    ber_point point;
+    point.bits = 1000000;
+    point.errors = 1000;
+    assert(std::fabs(ext_ber_deviation(point, 1e-3)) < 1e-9 && "expected count must not deviate");
+    assert(ext_ber_deviation(point, 5e-4) > 20 && "doubled BER must deviate");
+    assert(ext_ber_deviation(point, 2e-3) < -20 && "halved BER must deviate");
+
+    return true;
+}
+
+int main() {
+    assert(test_qfunc() == true && "test_qfunc() != true");
+    assert(test_qpsk_closed_form() == true && "test_qpsk_closed_form() != true");
+    assert(test_labelling<qam_order::QAM16>(4) == true && "test_labelling<QAM16>() != true");
+    assert(test_labelling<qam_order::QAM64>(8) == true && "test_labelling<QAM64>() != true");
+    assert(test_simulation_matches<qam_order::QPSK>(6.0) == true && "test_simulation_matches<QPSK>() != true");
+    assert(test_simulation_matches<qam_order::QAM16>(8.0) == true && "test_simulation_matches<QAM16>() != true");
+    assert(test_simulation_matches<qam_order::QAM64>(12.0) == true && "test_simulation_matches<QAM64>() != true");
+    assert(test_budget_and_deviation() == true && "test_budget_and_deviation() != true");
+
+    std::cout << "All tests passed successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}